@@ -0,0 +1,335 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+// Allocation Tracker
+// Counts heap allocations (count, bytes, frees) per frame, per subsystem tag and per call site (stack hash).
+// Opt-in: compile the hooks once with
+//     #define ALLOC_TRACKER_IMPLEMENTATION
+//     #include "AllocTracker.h"
+// which replaces the global operator new / delete and, on glibc, interposes malloc / calloc / realloc / free
+// (covers stb_image, assimp and the driver). Nothing is recorded until allocTrackerEnable(true).
+// Call site names need exported symbols (link with -rdynamic), otherwise the report prints addresses.
+// Windows: operator new / delete only, the C allocator is not interposed.
+
+#include <cstddef>
+
+const unsigned int ALLOC_TRACKER_SITES = 4096;   // Distinct call sites (power of 2)
+const unsigned int ALLOC_TRACKER_TAGS = 64;
+const unsigned int ALLOC_TRACKER_DEPTH = 8;      // Stack frames kept per call site
+
+struct AllocStats {
+    unsigned long long allocations;
+    unsigned long long frees;
+    unsigned long long bytes;
+};
+
+void allocTrackerEnable (bool enable);
+bool allocTrackerEnabled ();
+void allocTrackerReset ();                     // Clears the frame, tag and call site counters
+void allocTrackerFrameBegin ();                // Starts a new frame window
+AllocStats allocTrackerFrame ();               // Since the last allocTrackerFrameBegin
+AllocStats allocTrackerTag (const char* tag);  // Since the last reset
+void allocTrackerReport (unsigned int maxSites = 16);
+
+// Tag: subsystem charged for the calling thread's allocations (string literal), returns the previous tag
+const char* allocTrackerSetTag (const char* tag);
+
+// Tag Scope
+struct AllocTag {
+    const char* previous;
+    AllocTag (const char* tag) : previous(allocTrackerSetTag(tag)) {}
+    ~AllocTag () { allocTrackerSetTag(previous); }
+};
+
+#endif
+
+#ifdef ALLOC_TRACKER_IMPLEMENTATION
+#ifndef ALLOC_TRACKER_IMPLEMENTED
+#define ALLOC_TRACKER_IMPLEMENTED
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>     // CaptureStackBackTrace
+    #include <malloc.h>      // _aligned_malloc
+    #define ALLOC_RAW_MALLOC(size) std::malloc(size)
+    #define ALLOC_RAW_FREE(memory) std::free(memory)
+    #define ALLOC_RAW_ALIGNED(size, alignment) _aligned_malloc(size, alignment)
+    #define ALLOC_RAW_ALIGNED_FREE(memory) _aligned_free(memory)
+#else
+    #include <execinfo.h>    // backtrace / backtrace_symbols
+    #if defined(__GLIBC__)
+        #define ALLOC_TRACKER_MALLOC_HOOK 1
+        extern "C" void* __libc_malloc (size_t size);
+        extern "C" void* __libc_calloc (size_t count, size_t size);
+        extern "C" void* __libc_realloc (void* memory, size_t size);
+        extern "C" void* __libc_memalign (size_t alignment, size_t size);
+        extern "C" void __libc_free (void* memory);
+        #define ALLOC_RAW_MALLOC(size) __libc_malloc(size)
+        #define ALLOC_RAW_FREE(memory) __libc_free(memory)
+        #define ALLOC_RAW_ALIGNED(size, alignment) __libc_memalign(alignment, size)
+    #else
+        #define ALLOC_RAW_MALLOC(size) std::malloc(size)
+        #define ALLOC_RAW_FREE(memory) std::free(memory)
+        #define ALLOC_RAW_ALIGNED(size, alignment) std::aligned_alloc(alignment, ((size) + (alignment) - 1) / (alignment) * (alignment))
+    #endif
+    #define ALLOC_RAW_ALIGNED_FREE(memory) ALLOC_RAW_FREE(memory)
+#endif
+
+// Everything below is constant initialized: the hooks run before (and after) any constructor
+struct AllocSiteSlot {
+    std::atomic<unsigned long long> key;   // Stack hash, 0 = empty
+    void* stack[ALLOC_TRACKER_DEPTH];
+    unsigned int depth;
+    const char* tag;
+    std::atomic<unsigned long long> allocations;
+    std::atomic<unsigned long long> bytes;
+};
+
+struct AllocTagSlot {
+    std::atomic<const char*> tag;
+    std::atomic<unsigned long long> allocations;
+    std::atomic<unsigned long long> frees;
+    std::atomic<unsigned long long> bytes;
+};
+
+static std::atomic<bool> allocTrackerOn(false);
+static std::atomic<unsigned long long> allocFrameAllocations(0), allocFrameFrees(0), allocFrameBytes(0);
+static std::atomic<unsigned long long> allocDroppedSites(0);
+static AllocSiteSlot allocSites[ALLOC_TRACKER_SITES];
+static AllocTagSlot allocTags[ALLOC_TRACKER_TAGS];
+static thread_local const char* allocThreadTag = "untagged";
+static thread_local bool allocThreadBusy = false;   // Re-entrancy guard (backtrace and the report allocate)
+
+static AllocTagSlot* allocTagSlot (const char* tag)
+{
+    unsigned int start = (unsigned int)(((std::uintptr_t)tag >> 3) & (ALLOC_TRACKER_TAGS - 1));
+    for (unsigned int i = 0; i < ALLOC_TRACKER_TAGS; i++) {
+        AllocTagSlot& slot = allocTags[(start + i) & (ALLOC_TRACKER_TAGS - 1)];
+        const char* current = slot.tag.load(std::memory_order_acquire);
+        if (current == tag) return &slot;
+        if (!current && slot.tag.compare_exchange_strong(current, tag)) return &slot;
+        if (current == tag) return &slot;
+    }
+    return nullptr;
+}
+
+static unsigned int allocCaptureStack (void** stack, unsigned int maxDepth)
+{
+#if defined(_WIN32)
+    return CaptureStackBackTrace(2, maxDepth, stack, nullptr);
+#else
+    void* frames[ALLOC_TRACKER_DEPTH + 2];
+    int depth = backtrace(frames, (int)(maxDepth + 2));
+    unsigned int kept = depth > 2 ? (unsigned int)depth - 2 : 0;   // Skip this function and the hook
+    for (unsigned int f = 0; f < kept; f++) stack[f] = frames[f + 2];
+    return kept;
+#endif
+}
+
+static void allocRecord (std::size_t size)
+{
+    if (!allocTrackerOn.load(std::memory_order_relaxed) || allocThreadBusy) return;
+    allocThreadBusy = true;
+
+    allocFrameAllocations.fetch_add(1, std::memory_order_relaxed);
+    allocFrameBytes.fetch_add(size, std::memory_order_relaxed);
+
+    const char* tag = allocThreadTag;
+    if (AllocTagSlot* slot = allocTagSlot(tag)) {
+        slot->allocations.fetch_add(1, std::memory_order_relaxed);
+        slot->bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    // Call site: FNV-1a over the return addresses
+    void* stack[ALLOC_TRACKER_DEPTH];
+    unsigned int depth = allocCaptureStack(stack, ALLOC_TRACKER_DEPTH);
+    unsigned long long hash = 14695981039346656037ull;
+    for (unsigned int f = 0; f < depth; f++) hash = (hash ^ (unsigned long long)(std::uintptr_t)stack[f]) * 1099511628211ull;
+    if (hash == 0) hash = 1;
+
+    bool stored = false;
+    for (unsigned int i = 0; i < 64 && !stored; i++) {
+        AllocSiteSlot& slot = allocSites[(hash + i) & (ALLOC_TRACKER_SITES - 1)];
+        unsigned long long key = slot.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            if (slot.key.compare_exchange_strong(key, hash)) {
+                for (unsigned int f = 0; f < depth; f++) slot.stack[f] = stack[f];
+                slot.depth = depth;
+                slot.tag = tag;
+                key = hash;
+            }
+        }
+        if (key == hash) {
+            slot.allocations.fetch_add(1, std::memory_order_relaxed);
+            slot.bytes.fetch_add(size, std::memory_order_relaxed);
+            stored = true;
+        }
+    }
+    if (!stored) allocDroppedSites.fetch_add(1, std::memory_order_relaxed);
+
+    allocThreadBusy = false;
+}
+
+static void allocRecordFree (void* memory)
+{
+    if (!memory || !allocTrackerOn.load(std::memory_order_relaxed) || allocThreadBusy) return;
+    allocFrameFrees.fetch_add(1, std::memory_order_relaxed);
+    if (AllocTagSlot* slot = allocTagSlot(allocThreadTag)) slot->frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+// API
+void allocTrackerEnable (bool enable)
+{
+#if !defined(_WIN32)
+    // The first backtrace loads the unwinder (allocates): do it now rather than inside a frame
+    void* warm[2];
+    backtrace(warm, 2);
+#endif
+    allocTrackerOn.store(enable);
+}
+
+bool allocTrackerEnabled () { return allocTrackerOn.load(); }
+
+void allocTrackerFrameBegin ()
+{
+    allocFrameAllocations.store(0);
+    allocFrameFrees.store(0);
+    allocFrameBytes.store(0);
+}
+
+void allocTrackerReset ()
+{
+    allocTrackerFrameBegin();
+    allocDroppedSites.store(0);
+    for (AllocSiteSlot& slot : allocSites) {
+        slot.allocations.store(0);
+        slot.bytes.store(0);
+        slot.key.store(0);
+    }
+    for (AllocTagSlot& slot : allocTags) {
+        slot.allocations.store(0);
+        slot.frees.store(0);
+        slot.bytes.store(0);
+    }
+}
+
+AllocStats allocTrackerFrame ()
+{
+    return {allocFrameAllocations.load(), allocFrameFrees.load(), allocFrameBytes.load()};
+}
+
+AllocStats allocTrackerTag (const char* tag)
+{
+    for (AllocTagSlot& slot : allocTags)
+        if (slot.tag.load() == tag) return {slot.allocations.load(), slot.frees.load(), slot.bytes.load()};
+    return {0, 0, 0};
+}
+
+const char* allocTrackerSetTag (const char* tag)
+{
+    const char* previous = allocThreadTag;
+    allocThreadTag = tag;
+    return previous;
+}
+
+// Report: per tag totals, then the call sites with the most allocations (innermost frame first)
+void allocTrackerReport (unsigned int maxSites)
+{
+    bool busy = allocThreadBusy;
+    allocThreadBusy = true;
+
+    std::cout << "Allocations by tag:" << std::endl;
+    for (AllocTagSlot& slot : allocTags) {
+        const char* tag = slot.tag.load();
+        if (!tag || slot.allocations.load() == 0) continue;
+        std::cout << "  " << std::setw(12) << tag << "  " << slot.allocations.load() << " allocations, "
+                  << slot.bytes.load() << " bytes, " << slot.frees.load() << " frees" << std::endl;
+    }
+
+    AllocSiteSlot* sorted[ALLOC_TRACKER_SITES];
+    unsigned int siteCount = 0;
+    for (AllocSiteSlot& slot : allocSites)
+        if (slot.key.load() != 0 && slot.allocations.load() != 0) sorted[siteCount++] = &slot;
+    std::sort(sorted, sorted + siteCount, [](AllocSiteSlot* a, AllocSiteSlot* b) { return a->allocations.load() > b->allocations.load(); });
+
+    std::cout << "Allocation call sites: " << siteCount;
+    if (allocDroppedSites.load()) std::cout << " (" << allocDroppedSites.load() << " allocations not attributed: site table full)";
+    std::cout << std::endl;
+
+    for (unsigned int s = 0; s < std::min(siteCount, maxSites); s++) {
+        AllocSiteSlot& slot = *sorted[s];
+        std::cout << "  #" << s << "  " << slot.allocations.load() << " allocations, " << slot.bytes.load() << " bytes [" << slot.tag << "]" << std::endl;
+#if defined(_WIN32)
+        for (unsigned int f = 0; f < slot.depth; f++) std::cout << "      " << slot.stack[f] << std::endl;
+#else
+        char** symbols = backtrace_symbols(slot.stack, (int)slot.depth);
+        for (unsigned int f = 0; f < slot.depth; f++) std::cout << "      " << (symbols ? symbols[f] : "?") << std::endl;
+        std::free(symbols);
+#endif
+    }
+
+    allocThreadBusy = busy;
+}
+
+// Global operator new / delete
+void* operator new (std::size_t size)
+{
+    allocRecord(size);
+    void* memory = ALLOC_RAW_MALLOC(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[] (std::size_t size) { return operator new(size); }
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocRecord(size);
+    return ALLOC_RAW_MALLOC(size ? size : 1);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    allocRecord(size);
+    void* memory = ALLOC_RAW_ALIGNED(size ? size : 1, (std::size_t)alignment);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void operator delete (void* memory) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete[] (void* memory) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete (void* memory, std::size_t) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete[] (void* memory, std::size_t) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete (void* memory, const std::nothrow_t&) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete[] (void* memory, const std::nothrow_t&) noexcept { allocRecordFree(memory); ALLOC_RAW_FREE(memory); }
+void operator delete (void* memory, std::align_val_t) noexcept { allocRecordFree(memory); ALLOC_RAW_ALIGNED_FREE(memory); }
+void operator delete[] (void* memory, std::align_val_t) noexcept { allocRecordFree(memory); ALLOC_RAW_ALIGNED_FREE(memory); }
+void operator delete (void* memory, std::size_t, std::align_val_t) noexcept { allocRecordFree(memory); ALLOC_RAW_ALIGNED_FREE(memory); }
+void operator delete[] (void* memory, std::size_t, std::align_val_t) noexcept { allocRecordFree(memory); ALLOC_RAW_ALIGNED_FREE(memory); }
+
+// C allocator (glibc): the executable's definitions win over libc's for every shared library
+#ifdef ALLOC_TRACKER_MALLOC_HOOK
+extern "C" {
+void* malloc (size_t size) { allocRecord(size); return __libc_malloc(size); }
+void* calloc (size_t count, size_t size) { allocRecord(count * size); return __libc_calloc(count, size); }
+void* realloc (void* memory, size_t size) { allocRecord(size); return __libc_realloc(memory, size); }
+void free (void* memory) { allocRecordFree(memory); __libc_free(memory); }
+}
+#endif
+
+#endif
+#endif
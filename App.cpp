@@ -6,12 +6,30 @@
 
 #include "Shader.h"
 #include "Texture.h"
+#include "Camera.h"
+#include "Culling.h"
+#include "RenderThread.h"
+#include "FrameClock.h"
+#include "FrameArena.h"
+#include "Residency.h"
+#include "Material.h"
+#include "Sampler.h"
+#include "RenderTarget.h"
+#include "ShaderHotReload.h"
+#define ALLOC_TRACKER_IMPLEMENTATION  // Compile the allocation hooks (recording stays off unless --alloc-check)
+#include "AllocTracker.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Allocation check: frames rendered before the tracked frames start (first use caches, arena growth)
+const unsigned int ALLOC_CHECK_WARMUP = 120;
 
 // Compile: checkGLError(glFunction)
 void checkGLError(const std::string& location) {
@@ -40,14 +58,21 @@ void inputWindow(GLFWwindow* window)
         glfwSetWindowShouldClose(window, true);
 }
 
-// Resize Window
-void sizeWindow(GLFWwindow* window, int width, int height)
+// Input Movement: WASD + Space / Left Control (camera space direction, x = right, y = up, z = forward)
+glm::vec3 inputMovement(GLFWwindow* window)
 {
-    glViewport(0, 0, width, height);
+    glm::vec3 direction(0.0f);
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)            direction.z += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)            direction.z -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)            direction.x += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)            direction.x -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)        direction.y += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS) direction.y -= 1.0f;
+    return direction;
 }
 
 // Create Window
-GLFWwindow* createWindow () {
+GLFWwindow* createWindow (bool visible = true) {
 
     // GLFW
     if (!glfwInit()) {
@@ -59,7 +84,8 @@ GLFWwindow* createWindow () {
     GLFWmonitor* monitor = glfwGetPrimaryMonitor();
     const GLFWvidmode* fullscreen = glfwGetVideoMode(monitor);
 
-    // Window
+    // Window (hidden for the headless checks)
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
     GLFWwindow* window = glfwCreateWindow(fullscreen->width, fullscreen->height, "OpenGL", nullptr, nullptr);
     if (!window) {
         std::cout << "Failed to create GLFW window" << std::endl;
@@ -67,17 +93,37 @@ GLFWwindow* createWindow () {
         return nullptr;
     }
 
-    // Context and Resize
+    // Context (handed to the render thread once the resources are loaded, the viewport follows the frame packet)
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, sizeWindow);
 
     return window;
 }
 
-int main()
+int main(int argc, char* argv[])
 {  
+    // Command line: --alloc-check [frames] renders headless and fails if a frame after the warm up allocates,
+    // --validate-shaders validates every program against the draw state (always on in debug builds),
+    // --swap vsync|adaptive|uncapped|limited picks the swap mode (F3 cycles them), --fps the limited mode's rate
+    unsigned int allocCheckFrames = 0;
+    bool swapModeSet = false;
+    SwapMode swapMode = SWAP_VSYNC;
+    double limiterRate = 0.0;   // 0: monitor refresh rate
+    for (int a = 1; a < argc; a++) {
+        if (std::strcmp(argv[a], "--alloc-check") == 0)
+            allocCheckFrames = (a + 1 < argc && std::atoi(argv[a + 1]) > 0) ? (unsigned int)std::atoi(argv[a + 1]) : 600;
+        if (std::strcmp(argv[a], "--validate-shaders") == 0)
+            shaderValidation() = true;
+        if (std::strcmp(argv[a], "--swap") == 0 && a + 1 < argc) {
+            swapModeSet = swapModeFromName(argv[++a], swapMode);
+            if (!swapModeSet) std::cout << "Unknown swap mode " << argv[a] << " (vsync, adaptive, uncapped, limited)" << std::endl;
+        }
+        if (std::strcmp(argv[a], "--fps") == 0 && a + 1 < argc)
+            limiterRate = std::atof(argv[++a]);
+    }
+    if (!swapModeSet && allocCheckFrames) swapMode = SWAP_LIMITED;   // Hidden window: no vblank to wait for
+
     // GLFW 
-    GLFWwindow* window = createWindow();
+    GLFWwindow* window = createWindow(allocCheckFrames == 0);
     if (!window) return -1;
 
     // GLEW
@@ -91,34 +137,208 @@ int main()
     std::cout << "OpenGL version supported: " << version << std::endl;
     */
 
-    /* Texture */
-    unsigned int texture = loadTexture("./archive/Images/Img.jpg");
+    /* Assets: ./Assets.pack when present (tools/PackBuilder), loose files otherwise */
+    AssetPack assets;
+    bool packed = assets.open("./Assets.pack");
+
+    /* Residency: textures stream in on request (pack or loose files) and are evicted over budget, F2 prints the report */
+    Residency residency;
+    residency.pack = packed ? &assets : nullptr;
+    ResidencyLoader textureLoader = textureResidencyLoader();
+    ResidencyID texture = residency.add("./Archive/Images/Img.jpg", RESIDENCY_TEXTURE, &textureLoader);
 
     /* Shader */
     Shader Shader("./shaders/Vertex_Shader/vertex_shader.glsl", "./shaders/Fragment_Shader/fragment_shader.glsl");
 
-    /* Window Loop */
+    /* Materials: variants of the material template compiled in the background, the fallback draws until they are ready */
+    MaterialLibrary materials(window, "./shaders/Vertex_Shader/material_vertex.glsl", "./shaders/Fragment_Shader/material_fragment.glsl");
+    Material quadMaterial;
+    quadMaterial.name = "Img";
+    quadMaterial.features = MATERIAL_TEXTURED;
+    quadMaterial.sampler = samplerCache().get(samplerAnisotropic(16.0f, GL_CLAMP_TO_EDGE));   // One image, no tiling
+
+    /* Shader Hot Reload: edited material templates are rebuilt and swapped in at the next frame */
+    ShaderHotReload hotReload;
+    hotReload.watch(materials, "./shaders/Vertex_Shader/material_vertex.glsl", "./shaders/Fragment_Shader/material_fragment.glsl");
+
+    /* Scene Target: the frame is drawn in linear light into an HDR target (sized by the render thread), tonemapped and
+       sRGB encoded into the window's framebuffer */
+    RenderTarget sceneTarget;
+    sceneTarget.format = RENDER_TARGET_RGBA16F;
+    TonemapPass tonemap;
+    tonemap.create();
+
+    /* Camera */
+    Camera camera;
+
+    /* Culling: world space bounds of every object (the quad), visible object indices per frame (frame arena) */
+    CullingBounds objectBounds;
+    objectBounds.add(glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f));
+    std::vector<glm::mat4> objectModels = {glm::mat4(1.0f)};
+    std::vector<ResidencyID> objectTextures = {texture};
+    bool reportKey = false;
+    unsigned int validatedProgram = 0;
+    FrameArenas& arenas = frameArenas();
+
+    /* Frame Clock: 120 Hz fixed step simulation, swap mode from the command line / F3, limiter only paces the limited
+       mode (--fps, monitor refresh rate by default) */
+    FrameClock clock(1.0 / 120.0);
+    FrameStats frameStats;
+    if (limiterRate <= 0.0) limiterRate = glfwGetVideoMode(glfwGetPrimaryMonitor())->refreshRate;
+    FrameLimiter limiter(swapMode == SWAP_LIMITED ? limiterRate : 0.0);
+    int swapIntervals[SWAP_MODE_COUNT];         // Queried while this thread has the context (extension checks)
+    for (int mode = 0; mode < SWAP_MODE_COUNT; mode++) swapIntervals[mode] = swapModeInterval((SwapMode)mode);
+    bool swapKey = false;
+    glm::vec3 previousPosition = camera.position;
+
+    /* Render Thread: owns the GL context, submits frame packets published by this (update) thread */
+    FramePacketQueue framePackets(2);
+    RenderThread renderThread(window, framePackets, [&](const FramePacket& packet) {
+        AllocTag allocTag("render");
+        residency.update(packet.frameIndex);
+        hotReload.update();
+
+        // Frame Color (scene target, reallocated only when the window size changes)
+        sceneTarget.resize(packet.width, packet.height);
+        sceneTarget.bind();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Render: material program + texture (0 = black until streamed in)
+        quadMaterial.texture = residency.handle(texture);
+        MaterialVariant& material = quadMaterial.bind(materials);
+        glUniformMatrix4fv(material.uniformLocation("vsViewProjection"), 1, GL_FALSE, glm::value_ptr(packet.uniforms.viewProjection));
+
+        /* Geometry (quad buffers of the Shader) */
+        glBindVertexArray(Shader.VAO);
+
+        // Validation: a new program (variant ready, hot reload) is checked once against the state of its first draw
+        unsigned int program = material.program.load(std::memory_order_acquire);
+        if (shaderValidation() && program != validatedProgram) {
+            shaderValidate(program, quadMaterial.name);
+            validatedProgram = program;
+        }
+        for (const FrameDraw& draw : packet.draws) {
+            glUniformMatrix4fv(material.uniformLocation("vsModel"), 1, GL_FALSE, glm::value_ptr(draw.model));
+            glDrawElements(GL_TRIANGLES, (int)Shader.indices.size(), GL_UNSIGNED_INT, 0);
+        }
+
+        // Tonemap: scene target -> window (sRGB)
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, packet.width, packet.height);
+        tonemap.draw(sceneTarget);
+    });
+    renderThread.swapInterval = swapIntervals[swapMode];
+    renderThread.start();
+
+    /* Window Loop (update thread) */
+    AllocTag allocTag("update");
+    unsigned int allocFailedFrames = 0;
+    double latencyReport = glfwGetTime();
     while (!glfwWindowShouldClose(window))
     {
+        frameStats.add(clock.tick());
+        glfwPollEvents();
         inputWindow(window);
 
-        // Frame Color
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // Simulation (fixed steps)
+        glm::vec3 movement = inputMovement(window);
+        while (clock.step()) {
+            previousPosition = camera.position;
+            camera.move(movement, 2.0f, (float)clock.fixedStep);
+        }
 
-        // Render
+        // Camera: interpolated between the last two simulation steps
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        camera.resize(width, height);
+        Camera renderCamera = camera;
+        renderCamera.position = glm::mix(previousPosition, camera.position, clock.alpha());
 
-        /* Texture */
-        // glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        Shader.bindUniformInt("fsTex", 0); 
+        // Culling
+        FrameVector<unsigned int> visible(arenas.local());
+        cullObjects(objectBounds, renderCamera.frustum(), visible);
 
-        /* Shader */
-        Shader.shaderDraw();
+        // Frame Packet: waits while the render thread is a full buffer behind
+        FramePacket* packet = framePackets.beginWrite();
+        if (!packet) break;
+        packet->width = width;
+        packet->height = height;
+        packet->uniforms.view = renderCamera.view();
+        packet->uniforms.projection = renderCamera.projection();
+        packet->uniforms.viewProjection = renderCamera.viewProjection();
+        packet->uniforms.cameraPosition = glm::vec4(renderCamera.position, 1.0f);
+        packet->uniforms.time = (float)clock.time;
+        packet->uniforms.interpolation = clock.alpha();
+        for (unsigned int object : visible)
+            packet->draws.push_back({object, objectModels[object]});
 
-        // Render and Frozen screen
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // Residency requests: every object by distance / screen size, visible objects first
+        for (unsigned int object = 0; object < (unsigned int)objectTextures.size(); object++)
+            residency.request(objectTextures[object], packet->frameIndex,
+                              residencyPriority(objectBounds.center(object), objectBounds.radius[object], renderCamera.position, glm::radians(renderCamera.fov), false));
+        for (unsigned int object : visible)
+            residency.request(objectTextures[object], packet->frameIndex,
+                              residencyPriority(objectBounds.center(object), objectBounds.radius[object], renderCamera.position, glm::radians(renderCamera.fov), true));
+        framePackets.endWrite();
+
+        bool reportPressed = glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS;
+        if (reportPressed && !reportKey) residency.reportRequested = true;
+        reportKey = reportPressed;
+
+        // F3: next swap mode (interval applied by the render thread at its next frame)
+        bool swapPressed = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+        if (swapPressed && !swapKey) {
+            swapMode = (SwapMode)((swapMode + 1) % SWAP_MODE_COUNT);
+            renderThread.swapInterval = swapIntervals[swapMode];
+            limiter.setTarget(swapMode == SWAP_LIMITED ? limiterRate : 0.0);
+        }
+        swapKey = swapPressed;
+
+        // Frame time (p50 / p99 / stutters) and update -> render latency (publish to swap), once per second
+        if (glfwGetTime() - latencyReport >= 1.0) {
+            double last, average, maximum;
+            framePackets.latency(last, average, maximum, true);
+            char title[256];
+            std::snprintf(title, sizeof(title), "OpenGL | %s | frame p50 %.2f ms p99 %.2f ms stutters %llu | latency %.2f ms (max %.2f ms)",
+                          SWAP_MODE_NAMES[swapMode], frameStats.percentile(0.5) * 1000.0, frameStats.percentile(0.99) * 1000.0, frameStats.stutters, average, maximum);
+            glfwSetWindowTitle(window, title);
+            latencyReport = glfwGetTime();
+        }
+
+        // Frame data released (update thread + workers are done with it)
+        arenas.reset();
+        limiter.wait();
+
+        // Allocation check: every frame after the warm up must be allocation free
+        if (allocCheckFrames) {
+            if (allocTrackerEnabled()) {
+                AllocStats allocations = allocTrackerFrame();
+                if (allocations.allocations > 0) allocFailedFrames++;
+                allocTrackerFrameBegin();
+            }
+            if (clock.frame == ALLOC_CHECK_WARMUP) {
+                allocTrackerReset();
+                allocTrackerEnable(true);
+            }
+            if (clock.frame == ALLOC_CHECK_WARMUP + allocCheckFrames) glfwSetWindowShouldClose(window, true);
+        }
+    }
+
+    // Context back on this thread for the cleanup
+    renderThread.stop();
+    residency.clear();
+    materials.release();
+    sceneTarget.release();
+    tonemap.release();
+    samplerCache().release();
+
+    if (allocCheckFrames) {
+        allocTrackerEnable(false);
+        std::cout << "Allocation check: " << allocFailedFrames << " of " << allocCheckFrames << " frames allocated" << std::endl;
+        if (allocFailedFrames > 0) allocTrackerReport();
+        glfwTerminate();
+        return allocFailedFrames > 0 ? 1 : 0;
     }
 
     glfwTerminate();
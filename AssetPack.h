@@ -0,0 +1,486 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <vector>
+#include <string>
+#include <span>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>         // CreateFileMapping / MapViewOfFile
+#else
+    #include <fcntl.h>           // open
+    #include <unistd.h>          // close
+    #include <sys/mman.h>        // mmap
+    #include <sys/stat.h>        // fstat
+#endif
+
+// Asset Pack
+// One file holding every asset: header, entry data (each entry aligned), table of contents sorted by name hash,
+// then the names (listing / debugging). The reader maps the file and hands out views into the mapping: stored
+// entries are used in place, LZ4 entries are decompressed into a caller buffer.
+// Names are normalized (lower case, '/' separators, no leading "./"), so "./archive/Images/Img.jpg" and
+// "Archive\images\img.jpg" are the same entry. Little endian.
+//
+// Layout (offsets in bytes):
+//     AssetPackHeader
+//     entry data          (aligned to header.alignment)
+//     AssetPackEntry[]    (tocOffset, entryCount entries, ascending hash)
+//     names               (namesOffset, namesSize bytes, 0 terminated)
+
+const char ASSET_PACK_MAGIC[4] = {'P', 'A', 'C', 'K'};
+const uint32_t ASSET_PACK_VERSION = 1;
+const uint32_t ASSET_PACK_ALIGNMENT = 64;        // Default entry alignment (cache line, enough for any SIMD load)
+const uint32_t ASSET_PACK_LZ4 = 1;               // Entry flag: LZ4 block compressed
+
+struct AssetPackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct AssetPackEntry {
+    uint64_t hash;             // assetPackHash(name)
+    uint64_t offset;           // From the start of the file
+    uint64_t size;             // Stored size
+    uint64_t originalSize;     // Size once decompressed (= size when stored)
+    uint32_t flags;
+    uint32_t nameOffset;       // Into the names block
+};
+
+static_assert(sizeof(AssetPackHeader) == 40, "AssetPackHeader layout");
+static_assert(sizeof(AssetPackEntry) == 40, "AssetPackEntry layout");
+
+// Name normalization + FNV-1a 64 hash
+inline std::string assetPackName (const std::string& path)
+{
+    std::string name = path;
+    for (char& c : name) {
+        if (c == '\\') c = '/';
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    while (name.compare(0, 2, "./") == 0) name.erase(0, 2);
+    return name;
+}
+
+inline uint64_t assetPackHash (const std::string& path)
+{
+    std::string name = assetPackName(path);
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) hash = (hash ^ c) * 1099511628211ull;
+    return hash;
+}
+
+// LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+// Greedy compressor with a single hash table: fast to decode, modest ratio; streams decode with any LZ4 decoder
+const unsigned int LZ4_HASH_BITS = 14;
+const size_t LZ4_MIN_MATCH = 4;
+const size_t LZ4_LAST_LITERALS = 5;   // The block ends with at least 5 literals
+const size_t LZ4_MATCH_LIMIT = 12;    // The last match starts at least 12 bytes before the end
+
+inline void lz4WriteLength (std::vector<unsigned char>& out, size_t length)
+{
+    for (; length >= 255; length -= 255) out.push_back(255);
+    out.push_back((unsigned char)length);
+}
+
+inline void lz4Compress (const unsigned char* source, size_t size, std::vector<unsigned char>& out)
+{
+    out.clear();
+    out.reserve(size + size / 255 + 16);
+
+    std::vector<int64_t> table((size_t)1 << LZ4_HASH_BITS, -1);
+    size_t anchor = 0;
+
+    if (size > LZ4_MATCH_LIMIT) {
+        size_t matchEnd = size - LZ4_LAST_LITERALS;
+        size_t i = 0;
+        while (i + LZ4_MATCH_LIMIT <= size) {
+            uint32_t sequence;
+            std::memcpy(&sequence, source + i, 4);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+            int64_t candidate = table[hash];
+            table[hash] = (int64_t)i;
+
+            uint32_t candidateSequence = 0;
+            if (candidate >= 0) std::memcpy(&candidateSequence, source + candidate, 4);
+            if (candidate < 0 || i - (size_t)candidate > 65535 || candidateSequence != sequence) {
+                i++;
+                continue;
+            }
+
+            // Match: extend forward
+            size_t match = (size_t)candidate;
+            size_t length = LZ4_MIN_MATCH;
+            while (i + length < matchEnd && source[match + length] == source[i + length]) length++;
+
+            // Sequence: token, literals, offset, match length
+            size_t literals = i - anchor;
+            size_t matchCode = length - LZ4_MIN_MATCH;
+            out.push_back((unsigned char)((std::min<size_t>(literals, 15) << 4) | std::min<size_t>(matchCode, 15)));
+            if (literals >= 15) lz4WriteLength(out, literals - 15);
+            out.insert(out.end(), source + anchor, source + i);
+            size_t offset = i - match;
+            out.push_back((unsigned char)(offset & 0xFF));
+            out.push_back((unsigned char)(offset >> 8));
+            if (matchCode >= 15) lz4WriteLength(out, matchCode - 15);
+
+            i += length;
+            anchor = i;
+        }
+    }
+
+    // Last literals
+    size_t literals = size - anchor;
+    out.push_back((unsigned char)(std::min<size_t>(literals, 15) << 4));
+    if (literals >= 15) lz4WriteLength(out, literals - 15);
+    out.insert(out.end(), source + anchor, source + size);
+}
+
+// False on malformed input (never reads or writes out of bounds)
+inline bool lz4Decompress (const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize)
+{
+    size_t s = 0, d = 0;
+    while (s < sourceSize) {
+        unsigned char token = source[s++];
+
+        // Literals
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            unsigned char b;
+            do {
+                if (s >= sourceSize) return false;
+                b = source[s++];
+                literals += b;
+            } while (b == 255);
+        }
+        if (literals > sourceSize - s || literals > destinationSize - d) return false;
+        if (literals > 0) std::memcpy(destination + d, source + s, literals);   // Empty block: destination may be null
+        s += literals;
+        d += literals;
+        if (s == sourceSize) break;   // Last sequence has no match
+
+        // Match
+        if (sourceSize - s < 2) return false;
+        size_t offset = source[s] | ((size_t)source[s + 1] << 8);
+        s += 2;
+        if (offset == 0 || offset > d) return false;
+        size_t length = token & 15;
+        if (length == 15) {
+            unsigned char b;
+            do {
+                if (s >= sourceSize) return false;
+                b = source[s++];
+                length += b;
+            } while (b == 255);
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > destinationSize - d) return false;
+        for (size_t k = 0; k < length; k++, d++) destination[d] = destination[d - offset];   // Overlapping copies repeat
+    }
+    return d == destinationSize;
+}
+
+// File Mapping: read only view of a whole file
+struct AssetFileMapping {
+
+    const unsigned char* data;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file, mapping;
+#else
+    int file;
+#endif
+
+    // Constructor
+#if defined(_WIN32)
+    AssetFileMapping () : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {}
+#else
+    AssetFileMapping () : data(nullptr), size(0), file(-1) {}
+#endif
+
+    AssetFileMapping (const AssetFileMapping&) = delete;
+    AssetFileMapping& operator= (const AssetFileMapping&) = delete;
+
+    bool open (const std::string& filePath)
+    {
+        close();
+#if defined(_WIN32)
+        file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { close(); return false; }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { close(); return false; }
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) { close(); return false; }
+        size = (size_t)fileSize.QuadPart;
+#else
+        file = ::open(filePath.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size == 0) { close(); return false; }
+        void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) { close(); return false; }
+        data = static_cast<const unsigned char*>(view);
+        size = (size_t)status.st_size;
+#endif
+        return true;
+    }
+
+    void close ()
+    {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+        if (file >= 0) ::close(file);
+        file = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    // Destructor
+    ~AssetFileMapping ()
+    {
+        close();
+    }
+};
+
+// Asset Pack: reader
+struct AssetPack {
+
+    AssetFileMapping file;
+    const AssetPackHeader* header;
+    const AssetPackEntry* entries;
+    const char* names;
+
+    // Constructor
+    AssetPack () : header(nullptr), entries(nullptr), names(nullptr) {}
+
+    bool open (const std::string& packFilePath)
+    {
+        close();
+        if (!file.open(packFilePath)) return false;
+
+        // Validate the header and every entry against the file size
+        if (file.size < sizeof(AssetPackHeader)) return fail(packFilePath, "truncated header");
+        header = reinterpret_cast<const AssetPackHeader*>(file.data);
+        if (std::memcmp(header->magic, ASSET_PACK_MAGIC, 4) != 0 || header->version != ASSET_PACK_VERSION)
+            return fail(packFilePath, "not a pack file (version " + std::to_string(ASSET_PACK_VERSION) + ")");
+        if (header->tocOffset % alignof(AssetPackEntry) != 0 || header->tocOffset > file.size ||
+            header->entryCount > (file.size - header->tocOffset) / sizeof(AssetPackEntry) ||
+            header->namesOffset > file.size || header->namesSize > file.size - header->namesOffset)
+            return fail(packFilePath, "table of contents out of bounds");
+
+        entries = reinterpret_cast<const AssetPackEntry*>(file.data + header->tocOffset);
+        names = reinterpret_cast<const char*>(file.data + header->namesOffset);
+        if (header->entryCount > 0 && (header->namesSize == 0 || names[header->namesSize - 1] != '\0'))
+            return fail(packFilePath, "names block not 0 terminated");  // Names are printed as C strings
+        for (uint32_t e = 0; e < header->entryCount; e++) {
+            const AssetPackEntry& entry = entries[e];
+            if (entry.offset > file.size || entry.size > file.size - entry.offset || entry.nameOffset >= header->namesSize ||
+                (!(entry.flags & ASSET_PACK_LZ4) && entry.size != entry.originalSize))
+                return fail(packFilePath, "entry out of bounds");
+        }
+        return true;
+    }
+
+    bool fail (const std::string& packFilePath, const std::string& reason)
+    {
+        std::cout << "Failed to open the asset pack: " << packFilePath << " (" << reason << ")" << std::endl;
+        close();
+        return false;
+    }
+
+    void close ()
+    {
+        file.close();
+        header = nullptr;
+        entries = nullptr;
+        names = nullptr;
+    }
+
+    bool isOpen () const { return header != nullptr; }
+    uint32_t size () const { return header ? header->entryCount : 0; }
+
+    // Binary search in the table of contents
+    const AssetPackEntry* find (const std::string& name) const
+    {
+        if (!header) return nullptr;
+        uint64_t hash = assetPackHash(name);
+        const AssetPackEntry* end = entries + header->entryCount;
+        const AssetPackEntry* entry = std::lower_bound(entries, end, hash,
+            [](const AssetPackEntry& a, uint64_t h) { return a.hash < h; });
+        return (entry != end && entry->hash == hash) ? entry : nullptr;
+    }
+
+    bool contains (const std::string& name) const { return find(name) != nullptr; }
+
+    const char* entryName (const AssetPackEntry& entry) const { return names + entry.nameOffset; }
+
+    // Bytes as stored (compressed entries stay compressed)
+    std::span<const unsigned char> stored (const AssetPackEntry& entry) const
+    {
+        return std::span<const unsigned char>(file.data + entry.offset, (size_t)entry.size);
+    }
+
+    // Zero copy view of a stored entry, empty when missing or compressed
+    std::span<const unsigned char> view (const std::string& name) const
+    {
+        const AssetPackEntry* entry = find(name);
+        if (!entry || (entry->flags & ASSET_PACK_LZ4)) return {};
+        return stored(*entry);
+    }
+
+    // Contents: view into the mapping when stored, decompressed into buffer otherwise; empty when missing / corrupt
+    std::span<const unsigned char> read (const std::string& name, std::vector<unsigned char>& buffer) const
+    {
+        const AssetPackEntry* entry = find(name);
+        if (!entry) return {};
+        if (!(entry->flags & ASSET_PACK_LZ4)) return stored(*entry);
+
+        buffer.resize((size_t)entry->originalSize);
+        std::span<const unsigned char> source = stored(*entry);
+        if (!lz4Decompress(source.data(), source.size(), buffer.data(), buffer.size())) {
+            std::cout << "Corrupt asset pack entry: " << entryName(*entry) << std::endl;
+            return {};
+        }
+        return std::span<const unsigned char>(buffer.data(), buffer.size());
+    }
+};
+
+// Asset Pack Builder: collects entries in memory, write() lays out the pack
+struct AssetPackBuilder {
+
+    struct Item {
+        std::string name;
+        uint64_t hash;
+        std::vector<unsigned char> data;   // Stored bytes
+        uint64_t originalSize;
+        uint32_t flags;
+    };
+
+    std::vector<Item> items;
+
+    // Add (or replace) an entry; compress keeps the LZ4 version only when it saves at least 1/8
+    bool add (const std::string& path, const unsigned char* data, size_t size, bool compress)
+    {
+        Item item;
+        item.name = assetPackName(path);
+        item.hash = assetPackHash(item.name);
+        item.originalSize = size;
+        item.flags = 0;
+
+        if (compress && size > 0) {
+            lz4Compress(data, size, item.data);
+            if (item.data.size() <= size - size / 8) item.flags = ASSET_PACK_LZ4;
+        }
+        if (!item.flags) item.data.assign(data, data + size);
+
+        for (Item& existing : items) {
+            if (existing.hash != item.hash) continue;
+            if (existing.name != item.name) {
+                std::cout << "Asset name hash collision: " << existing.name << " / " << item.name << std::endl;
+                return false;
+            }
+            existing = std::move(item);
+            return true;
+        }
+        items.push_back(std::move(item));
+        return true;
+    }
+
+    bool addFile (const std::string& filePath, bool compress)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file) {
+            std::cout << "Failed to read the asset: " << filePath << std::endl;
+            return false;
+        }
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return add(filePath, data.data(), data.size(), compress);
+    }
+
+    bool write (const std::string& packFilePath, uint32_t alignment = ASSET_PACK_ALIGNMENT) const
+    {
+        alignment = std::max<uint32_t>(alignment, 8);
+        std::vector<const Item*> sorted;
+        for (const Item& item : items) sorted.push_back(&item);
+        std::sort(sorted.begin(), sorted.end(), [](const Item* a, const Item* b) { return a->hash < b->hash; });
+
+        auto alignUp = [](uint64_t value, uint64_t to) { return (value + to - 1) / to * to; };
+
+        // Layout
+        std::vector<AssetPackEntry> toc(sorted.size());
+        std::string names;
+        uint64_t offset = alignUp(sizeof(AssetPackHeader), alignment);
+        for (size_t e = 0; e < sorted.size(); e++) {
+            toc[e].hash = sorted[e]->hash;
+            toc[e].offset = offset;
+            toc[e].size = sorted[e]->data.size();
+            toc[e].originalSize = sorted[e]->originalSize;
+            toc[e].flags = sorted[e]->flags;
+            toc[e].nameOffset = (uint32_t)names.size();
+            names += sorted[e]->name;
+            names += '\0';
+            offset = alignUp(offset + toc[e].size, alignment);
+        }
+
+        AssetPackHeader header;
+        std::memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+        header.version = ASSET_PACK_VERSION;
+        header.entryCount = (uint32_t)toc.size();
+        header.alignment = alignment;
+        header.tocOffset = offset;
+        header.namesOffset = offset + toc.size() * sizeof(AssetPackEntry);
+        header.namesSize = names.size();
+
+        // Write
+        std::ofstream file(packFilePath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "Failed to write the asset pack: " << packFilePath << std::endl;
+            return false;
+        }
+        const char padding[4096] = {};
+        auto padTo = [&](uint64_t position) {
+            uint64_t current = (uint64_t)file.tellp();
+            while (current < position) {
+                uint64_t count = std::min<uint64_t>(position - current, sizeof(padding));
+                file.write(padding, (std::streamsize)count);
+                current += count;
+            }
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t e = 0; e < sorted.size(); e++) {
+            padTo(toc[e].offset);
+            file.write(reinterpret_cast<const char*>(sorted[e]->data.data()), (std::streamsize)sorted[e]->data.size());
+        }
+        padTo(header.tocOffset);
+        file.write(reinterpret_cast<const char*>(toc.data()), (std::streamsize)(toc.size() * sizeof(AssetPackEntry)));
+        file.write(names.data(), (std::streamsize)names.size());
+        return (bool)file;
+    }
+};
+
+#endif
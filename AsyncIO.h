@@ -0,0 +1,515 @@
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include "JobSystem.h"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>             // CreateFile / ReadFile
+#else
+    #include <fcntl.h>               // open
+    #include <unistd.h>              // pread / close / syscall
+    #include <sys/stat.h>            // fstat
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #define ASYNC_IO_URING 1
+    #include <linux/io_uring.h>      // io_uring ABI (no liburing: raw syscalls)
+    #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
+#endif
+
+// Async IO
+// File read service: requests are queued by priority (visible assets first), read in the background and their
+// callbacks run on the job system (never on the GL thread: callbacks hand the data over, the GL upload happens later).
+// Linux: one service thread drives an io_uring, large files are split in chunks so many reads are in flight and
+// every batch of reads is one io_uring_enter. Elsewhere (or when io_uring is unavailable, e.g. blocked by a
+// container's seccomp profile): a thread pool doing positional reads.
+
+const unsigned int ASYNC_IO_QUEUE_DEPTH = 64;   // Reads in flight (io_uring entries)
+const size_t ASYNC_IO_CHUNK = 1 << 20;          // 1 MB per read
+const unsigned int ASYNC_IO_THREADS = 4;        // Fallback pool
+
+enum AsyncIOPriority {
+    IO_PRIORITY_VISIBLE,    // Needed for the current frame
+    IO_PRIORITY_NORMAL,
+    IO_PRIORITY_PREFETCH,   // Might be needed soon
+    IO_PRIORITY_COUNT
+};
+
+enum AsyncIOBackend {
+    IO_BACKEND_AUTO,
+    IO_BACKEND_URING,
+    IO_BACKEND_THREADS
+};
+
+struct AsyncReadResult {
+    std::string path;
+    std::vector<unsigned char> data;
+    bool success;
+    double latencyMs;       // Queued -> read complete
+};
+
+typedef std::function<void(AsyncReadResult&)> AsyncReadCallback;
+
+// File: positional reads, no shared file pointer
+struct AsyncFile {
+#if defined(_WIN32)
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int handle = -1;
+#endif
+    uint64_t size = 0;
+
+    bool open (const std::string& filePath)
+    {
+#if defined(_WIN32)
+        handle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(handle, &fileSize)) { close(); return false; }
+        size = (uint64_t)fileSize.QuadPart;
+#else
+        handle = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (handle < 0) return false;
+        struct stat status;
+        if (fstat(handle, &status) != 0) { close(); return false; }
+        size = (uint64_t)status.st_size;
+#endif
+        return true;
+    }
+
+    // Bytes read, -1 on error
+    long long readAt (uint64_t offset, unsigned char* destination, size_t length)
+    {
+#if defined(_WIN32)
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD read = 0;
+        if (!ReadFile(handle, destination, (DWORD)length, &read, &overlapped)) return -1;
+        return read;
+#else
+        ssize_t read;
+        do { read = pread(handle, destination, length, (off_t)offset); } while (read < 0 && errno == EINTR);
+        return read;
+#endif
+    }
+
+    void close ()
+    {
+#if defined(_WIN32)
+        if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+#else
+        if (handle >= 0) ::close(handle);
+        handle = -1;
+#endif
+    }
+};
+
+// Read Request (one per file)
+struct AsyncReadRequest {
+    AsyncReadResult result;
+    AsyncReadCallback callback;
+    AsyncIOPriority priority;
+    std::chrono::steady_clock::time_point queued;
+    AsyncFile file;
+    unsigned int pendingChunks;
+    bool failed;
+};
+
+#ifdef ASYNC_IO_URING
+// io_uring: submission / completion rings shared with the kernel
+struct IoUring {
+
+    int ring;
+    unsigned int entries;
+    unsigned int *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned int *cqHead, *cqTail, *cqMask;
+    io_uring_sqe* sqes;
+    io_uring_cqe* cqes;
+    void *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize, sqesSize;
+    unsigned int sqLocalTail;   // Filled but not yet published submissions
+
+    IoUring () : ring(-1), entries(0), sqes(nullptr), cqes(nullptr), sqRing(MAP_FAILED), cqRing(MAP_FAILED),
+                 sqRingSize(0), cqRingSize(0), sqesSize(0), sqLocalTail(0) {}
+
+    bool setup (unsigned int queueDepth)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring = (int)syscall(__NR_io_uring_setup, queueDepth, &params);
+        if (ring < 0) return false;
+        entries = params.sq_entries;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) { release(); return false; }
+        cqRing = singleMap ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) { release(); return false; }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (sqeMap == MAP_FAILED) { release(); return false; }
+        sqes = static_cast<io_uring_sqe*>(sqeMap);
+
+        unsigned char* sq = static_cast<unsigned char*>(sqRing);
+        unsigned char* cq = static_cast<unsigned char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqLocalTail = *sqTail;
+        return true;
+    }
+
+    // Next free submission entry, nullptr when the ring is full
+    io_uring_sqe* nextSubmission ()
+    {
+        unsigned int head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqLocalTail - head >= entries) return nullptr;
+        unsigned int index = sqLocalTail & *sqMask;
+        sqArray[index] = index;
+        sqLocalTail++;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Publish the filled entries and wait for at least minComplete completions (one syscall)
+    int submit (unsigned int minComplete)
+    {
+        __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+        int result;
+        do {
+            unsigned int toSubmit = sqLocalTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);   // Not yet consumed by the kernel
+            result = (int)syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, minComplete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+
+    template <typename F>
+    unsigned int reap (const F& function)
+    {
+        unsigned int head = *cqHead;
+        unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned int count = 0;
+        for (; head != tail; head++, count++) function(cqes[head & *cqMask]);
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    void release ()
+    {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (ring >= 0) ::close(ring);
+        sqes = nullptr;
+        sqRing = cqRing = MAP_FAILED;
+        ring = -1;
+    }
+
+    ~IoUring () { release(); }
+};
+
+// One read in flight
+struct AsyncReadChunk {
+    AsyncReadRequest* request;
+    uint64_t offset;
+    size_t length;
+    iovec vector;
+};
+#endif
+
+// Async IO service
+struct AsyncIO {
+
+    AsyncIOBackend backend;
+    std::mutex mutex;
+    std::condition_variable wake;       // New requests / shutdown
+    std::condition_variable idle;       // Everything completed
+    std::deque<AsyncReadRequest*> queues[IO_PRIORITY_COUNT];
+    std::vector<std::thread> threads;
+    bool running;
+    unsigned int outstanding;           // Queued + reading + callback not yet run
+
+    // Statistics
+    std::atomic<unsigned long long> bytesRead, filesRead, filesFailed;
+    std::atomic<unsigned long long> depthSamples, depthSum;
+    std::atomic<unsigned int> depthMax, busyThreads;
+
+#ifdef ASYNC_IO_URING
+    IoUring uring;
+#endif
+
+    // Constructor: IO_BACKEND_AUTO = io_uring when the kernel allows it, thread pool otherwise
+    AsyncIO (AsyncIOBackend requested = IO_BACKEND_AUTO, unsigned int threadCount = ASYNC_IO_THREADS)
+        : backend(IO_BACKEND_THREADS), running(true), outstanding(0), bytesRead(0), filesRead(0), filesFailed(0),
+          depthSamples(0), depthSum(0), depthMax(0), busyThreads(0)
+    {
+        jobSystem();   // Constructed first, destroyed last: completions run on it until ~AsyncIO
+#ifdef ASYNC_IO_URING
+        if (requested != IO_BACKEND_THREADS && uring.setup(ASYNC_IO_QUEUE_DEPTH)) backend = IO_BACKEND_URING;
+#endif
+        if (backend == IO_BACKEND_URING) {
+#ifdef ASYNC_IO_URING
+            threads.emplace_back([this]() { uringLoop(); });
+#endif
+        } else {
+            for (unsigned int t = 0; t < std::max(1u, threadCount); t++) threads.emplace_back([this]() { threadLoop(); });
+        }
+    }
+
+    const char* backendName () const { return backend == IO_BACKEND_URING ? "io_uring" : "thread pool"; }
+
+    // Queue a whole file read; callback (optional) runs on the job system with the data
+    void read (const std::string& filePath, AsyncIOPriority priority, AsyncReadCallback callback)
+    {
+        AsyncReadRequest* request = new AsyncReadRequest();
+        request->result.path = filePath;
+        request->result.success = false;
+        request->result.latencyMs = 0.0;
+        request->callback = std::move(callback);
+        request->priority = priority;
+        request->queued = std::chrono::steady_clock::now();
+        request->pendingChunks = 0;
+        request->failed = false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        queues[priority].push_back(request);
+        outstanding++;
+        wake.notify_one();
+    }
+
+    // Block until every queued read has completed and its callback has run (runs jobs meanwhile)
+    void drain ()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (outstanding != 0) {
+            lock.unlock();
+            bool helped = jobSystem().help();
+            lock.lock();
+            if (!helped && outstanding != 0) idle.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    // Average / maximum reads in flight
+    double averageQueueDepth () const
+    {
+        unsigned long long samples = depthSamples.load();
+        return samples ? (double)depthSum.load() / (double)samples : 0.0;
+    }
+
+    void resetStatistics ()
+    {
+        bytesRead = 0; filesRead = 0; filesFailed = 0;
+        depthSamples = 0; depthSum = 0; depthMax = 0;
+    }
+
+    void sampleDepth (unsigned int depth)
+    {
+        depthSamples.fetch_add(1, std::memory_order_relaxed);
+        depthSum.fetch_add(depth, std::memory_order_relaxed);
+        unsigned int maximum = depthMax.load(std::memory_order_relaxed);
+        while (depth > maximum && !depthMax.compare_exchange_weak(maximum, depth)) {}
+    }
+
+    // Highest priority queued request (mutex held)
+    AsyncReadRequest* popRequest ()
+    {
+        for (std::deque<AsyncReadRequest*>& queue : queues) {
+            if (queue.empty()) continue;
+            AsyncReadRequest* request = queue.front();
+            queue.pop_front();
+            return request;
+        }
+        return nullptr;
+    }
+
+    bool queued () const
+    {
+        for (const std::deque<AsyncReadRequest*>& queue : queues)
+            if (!queue.empty()) return true;
+        return false;
+    }
+
+    // Read finished: statistics, then the callback on the job system
+    void complete (AsyncReadRequest* request, bool success)
+    {
+        request->file.close();
+        request->result.success = success;
+        request->result.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - request->queued).count();
+        if (success) {
+            bytesRead.fetch_add(request->result.data.size(), std::memory_order_relaxed);
+            filesRead.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            request->result.data.clear();
+            filesFailed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        jobSystem().run([this, request]() {
+            if (request->callback) request->callback(request->result);
+            delete request;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--outstanding == 0) idle.notify_all();
+        });
+    }
+
+    // Thread pool backend: one file at a time per thread, chunked positional reads
+    void threadLoop ()
+    {
+        while (true) {
+            AsyncReadRequest* request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return !running || queued(); });
+                request = popRequest();
+                if (!request) return;   // Stopped and empty
+            }
+
+            sampleDepth(busyThreads.fetch_add(1) + 1);
+            bool success = request->file.open(request->result.path);
+            if (success) {
+                request->result.data.resize((size_t)request->file.size);
+                for (uint64_t offset = 0; success && offset < request->file.size; ) {
+                    size_t length = (size_t)std::min<uint64_t>(ASYNC_IO_CHUNK, request->file.size - offset);
+                    long long read = request->file.readAt(offset, request->result.data.data() + offset, length);
+                    if (read <= 0) success = false;
+                    else offset += (uint64_t)read;
+                }
+            }
+            busyThreads.fetch_sub(1);
+            complete(request, success);
+        }
+    }
+
+#ifdef ASYNC_IO_URING
+    // io_uring backend: keep up to the queue depth of chunk reads in flight, highest priority files first
+    void uringLoop ()
+    {
+        std::deque<AsyncReadChunk*> ready;   // Chunks waiting for a submission entry
+        unsigned int inFlight = 0;
+
+        while (true) {
+            // New requests: block only when nothing is in flight
+            std::vector<AsyncReadRequest*> finished;   // Failed to open, or empty
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (inFlight == 0 && ready.empty())
+                    wake.wait(lock, [this]() { return !running || queued(); });
+                if (!running && inFlight == 0 && ready.empty() && !queued()) return;
+
+                while (ready.size() < uring.entries) {
+                    AsyncReadRequest* request = popRequest();
+                    if (!request) break;
+                    request->failed = !request->file.open(request->result.path);
+                    if (request->failed || request->file.size == 0) { finished.push_back(request); continue; }
+
+                    request->result.data.resize((size_t)request->file.size);
+                    for (uint64_t offset = 0; offset < request->file.size; offset += ASYNC_IO_CHUNK) {
+                        AsyncReadChunk* chunk = new AsyncReadChunk();
+                        chunk->request = request;
+                        chunk->offset = offset;
+                        chunk->length = (size_t)std::min<uint64_t>(ASYNC_IO_CHUNK, request->file.size - offset);
+                        ready.push_back(chunk);
+                        request->pendingChunks++;
+                    }
+                }
+            }
+            for (AsyncReadRequest* request : finished) complete(request, !request->failed);
+
+            // Fill the submission ring, one syscall submits the batch and waits for a completion
+            while (!ready.empty() && inFlight < uring.entries) {
+                io_uring_sqe* sqe = uring.nextSubmission();
+                if (!sqe) break;
+                AsyncReadChunk* chunk = ready.front();
+                ready.pop_front();
+                chunk->vector.iov_base = chunk->request->result.data.data() + chunk->offset;
+                chunk->vector.iov_len = chunk->length;
+                sqe->opcode = IORING_OP_READV;   // Linux 5.1+
+                sqe->fd = chunk->request->file.handle;
+                sqe->addr = (uint64_t)(uintptr_t)&chunk->vector;
+                sqe->len = 1;
+                sqe->off = chunk->offset;
+                sqe->user_data = (uint64_t)(uintptr_t)chunk;
+                inFlight++;
+            }
+            if (inFlight == 0) continue;
+            sampleDepth(inFlight);
+            if (uring.submit(1) < 0) {
+                std::this_thread::yield();   // EBUSY / EAGAIN: completions pending, reap first
+            }
+
+            uring.reap([&](const io_uring_cqe& cqe) {
+                AsyncReadChunk* chunk = reinterpret_cast<AsyncReadChunk*>((uintptr_t)cqe.user_data);
+                AsyncReadRequest* request = chunk->request;
+                inFlight--;
+
+                if (cqe.res > 0 && (size_t)cqe.res < chunk->length) {
+                    // Short read: queue the rest
+                    chunk->offset += (uint64_t)cqe.res;
+                    chunk->length -= (size_t)cqe.res;
+                    ready.push_front(chunk);
+                    return;
+                }
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR) { ready.push_front(chunk); return; }
+                if (cqe.res <= 0) request->failed = true;   // Error, or the file shrank
+
+                delete chunk;
+                if (--request->pendingChunks == 0) complete(request, !request->failed);
+            });
+        }
+    }
+#endif
+
+    // Destructor: finishes the queued reads
+    ~AsyncIO ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+            wake.notify_all();
+        }
+        for (std::thread& thread : threads) thread.join();
+        drain();
+    }
+};
+
+// Shared IO service
+inline AsyncIO& asyncIO ()
+{
+    static AsyncIO io;
+    return io;
+}
+
+#endif
@@ -0,0 +1,619 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+#include "JobSystem.h"
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+// 4 wide node tests with SSE2 (every x86-64 CPU), scalar loop otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define BVH_SSE 1
+#endif
+
+// Bounding Volume Hierarchy
+// Build: binary BVH with binned SAH (16 bins x 3 axes), large subtrees are built as jobs (JobSystem.h).
+// The binary tree is then collapsed into a flat array of 4 wide nodes whose child boxes are stored as
+// structure of arrays, so one SSE instruction tests a ray (or box / point) against 4 children.
+// Primitives are triangles (meshes, ray picking) or boxes (scene objects).
+
+const unsigned int BVH_BINS = 16;
+const unsigned int BVH_MAX_LEAF = 4;             // Leaf size when the SAH would still split
+const unsigned int BVH_PARALLEL_THRESHOLD = 4096; // Subtrees smaller than this are built by the current job
+const unsigned int BVH_INVALID = 0xFFFFFFFF;
+const unsigned int BVH_STACK_SIZE = 256;         // Traversal stack on the stack; deeper trees traverse with a heap stack
+
+// Ray (tMax = closest hit so far)
+struct BVHRay {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float tMax;
+};
+
+// Ray hit: distance, primitive (BVH_INVALID = miss) and barycentrics for triangles
+struct BVHHit {
+    float t;
+    unsigned int primitive;
+    float u, v;
+};
+
+// 4 wide node: child boxes as SoA, child[i] = node index (count 0) or first primitive (count > 0)
+struct BVH4Node {
+    float minX[4], minY[4], minZ[4];
+    float maxX[4], maxY[4], maxZ[4];
+    unsigned int child[4];
+    unsigned int count[4];
+};
+
+// Picking ray through a cursor position (pixels, origin top left as reported by glfwGetCursorPos)
+inline BVHRay pickingRay (const glm::mat4& viewProjection, const glm::vec2& cursor, const glm::vec2& viewport)
+{
+    glm::vec2 ndc(cursor.x / viewport.x * 2.0f - 1.0f, 1.0f - cursor.y / viewport.y * 2.0f);
+    glm::mat4 inverse = glm::inverse(viewProjection);
+    glm::vec4 nearPoint = inverse * glm::vec4(ndc, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverse * glm::vec4(ndc, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+    return BVHRay{origin, direction, std::numeric_limits<float>::max()};
+}
+
+// Closest point on a triangle (Ericson, Real-Time Collision Detection 5.1.5)
+inline glm::vec3 closestPointTriangle (const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// BVH
+struct BVH {
+
+    std::vector<BVH4Node> nodes;                 // nodes[0] = root
+    std::vector<unsigned int> primitiveIndices;  // Leaf order -> primitive
+    std::vector<glm::vec3> primitiveMin, primitiveMax;
+    unsigned int depth = 0;                      // 4 wide levels, root = 1 (set by the build, refit keeps it)
+
+    // Triangle primitives (empty for a box BVH)
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+
+    // Build over the triangles of a mesh (loadModel output positions + indices), threadCount 1 = single threaded
+    void buildTriangles (const std::vector<glm::vec3>& meshPositions, const std::vector<unsigned int>& meshIndices, unsigned int threadCount = 0)
+    {
+        positions = meshPositions;
+        indices = meshIndices;
+        unsigned int count = (unsigned int)(indices.size() / 3);
+        primitiveMin.resize(count);
+        primitiveMax.resize(count);
+        for (unsigned int t = 0; t < count; t++) {
+            const glm::vec3& a = positions[indices[t * 3]];
+            const glm::vec3& b = positions[indices[t * 3 + 1]];
+            const glm::vec3& c = positions[indices[t * 3 + 2]];
+            primitiveMin[t] = glm::min(a, glm::min(b, c));
+            primitiveMax[t] = glm::max(a, glm::max(b, c));
+        }
+        build(threadCount);
+    }
+
+    // Build over object bounds
+    void buildBoxes (const std::vector<glm::vec3>& boxMin, const std::vector<glm::vec3>& boxMax, unsigned int threadCount = 0)
+    {
+        positions.clear();
+        indices.clear();
+        primitiveMin = boxMin;
+        primitiveMax = boxMax;
+        build(threadCount);
+    }
+
+    bool isTriangles () const { return !indices.empty(); }
+
+    // Binary build node (only lives during the build)
+    struct BuildNode {
+        glm::vec3 boundsMin, boundsMax;
+        unsigned int leftFirst;   // Left child (right = left + 1) or first primitive
+        unsigned int count;       // 0 = internal
+    };
+
+    static float area (const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    void build (unsigned int threadCount)
+    {
+        nodes.clear();
+        depth = 0;
+        unsigned int count = (unsigned int)primitiveMin.size();
+        primitiveIndices.resize(count);
+        for (unsigned int i = 0; i < count; i++) primitiveIndices[i] = i;
+        if (count == 0) return;
+
+        bool parallel = threadCount != 1 && jobSystem().threadCount() > 1;
+
+        // A binary tree over n primitives has at most 2n - 1 nodes; children are claimed in pairs atomically
+        std::vector<BuildNode> buildNodes(2 * (size_t)count);
+        std::atomic<unsigned int> nodeCount(1);
+        buildNodes[0].leftFirst = 0;
+        buildNodes[0].count = count;
+        subdivide(buildNodes, nodeCount, 0, parallel);
+
+        collapse(buildNodes);
+    }
+
+    void nodeBounds (BuildNode& node) const
+    {
+        node.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        node.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+        for (unsigned int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+            node.boundsMin = glm::min(node.boundsMin, primitiveMin[primitiveIndices[i]]);
+            node.boundsMax = glm::max(node.boundsMax, primitiveMax[primitiveIndices[i]]);
+        }
+    }
+
+    void subdivide (std::vector<BuildNode>& buildNodes, std::atomic<unsigned int>& nodeCount, unsigned int nodeIndex, bool parallel)
+    {
+        BuildNode& node = buildNodes[nodeIndex];
+        nodeBounds(node);
+        if (node.count <= 1) return;
+
+        // Centroid bounds
+        glm::vec3 centroidMin(std::numeric_limits<float>::max()), centroidMax(-std::numeric_limits<float>::max());
+        for (unsigned int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+            glm::vec3 centroid = (primitiveMin[primitiveIndices[i]] + primitiveMax[primitiveIndices[i]]) * 0.5f;
+            centroidMin = glm::min(centroidMin, centroid);
+            centroidMax = glm::max(centroidMax, centroid);
+        }
+
+        // Binned SAH over the 3 axes
+        int bestAxis = -1;
+        unsigned int bestSplit = 0;
+        float bestCost = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = centroidMax[axis] - centroidMin[axis];
+            if (extent <= 1e-12f) continue;
+            float scale = BVH_BINS / extent;
+
+            unsigned int binCount[BVH_BINS] = {};
+            glm::vec3 binMin[BVH_BINS], binMax[BVH_BINS];
+            for (unsigned int b = 0; b < BVH_BINS; b++) {
+                binMin[b] = glm::vec3(std::numeric_limits<float>::max());
+                binMax[b] = glm::vec3(-std::numeric_limits<float>::max());
+            }
+            for (unsigned int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                unsigned int p = primitiveIndices[i];
+                float centroid = (primitiveMin[p][axis] + primitiveMax[p][axis]) * 0.5f;
+                unsigned int b = std::min(BVH_BINS - 1, (unsigned int)((centroid - centroidMin[axis]) * scale));
+                binCount[b]++;
+                binMin[b] = glm::min(binMin[b], primitiveMin[p]);
+                binMax[b] = glm::max(binMax[b], primitiveMax[p]);
+            }
+
+            // Sweep: left areas / counts forward, right ones backward
+            float leftArea[BVH_BINS - 1];
+            unsigned int leftCount[BVH_BINS - 1];
+            glm::vec3 sweepMin(std::numeric_limits<float>::max()), sweepMax(-std::numeric_limits<float>::max());
+            unsigned int sweepCount = 0;
+            for (unsigned int b = 0; b < BVH_BINS - 1; b++) {
+                sweepCount += binCount[b];
+                sweepMin = glm::min(sweepMin, binMin[b]);
+                sweepMax = glm::max(sweepMax, binMax[b]);
+                leftCount[b] = sweepCount;
+                leftArea[b] = area(sweepMin, sweepMax);
+            }
+            sweepMin = glm::vec3(std::numeric_limits<float>::max());
+            sweepMax = glm::vec3(-std::numeric_limits<float>::max());
+            sweepCount = 0;
+            for (unsigned int b = BVH_BINS - 1; b > 0; b--) {
+                sweepCount += binCount[b];
+                sweepMin = glm::min(sweepMin, binMin[b]);
+                sweepMax = glm::max(sweepMax, binMax[b]);
+                if (leftCount[b - 1] == 0 || sweepCount == 0) continue;
+                float cost = leftCount[b - 1] * leftArea[b - 1] + sweepCount * area(sweepMin, sweepMax);
+                if (cost < bestCost) { bestCost = cost; bestAxis = axis; bestSplit = b; }
+            }
+        }
+
+        // Stop when splitting costs more than intersecting every primitive (traversal cost = 1 primitive)
+        float leafCost = node.count * area(node.boundsMin, node.boundsMax);
+        float splitCost = bestCost + area(node.boundsMin, node.boundsMax);
+        if (node.count <= BVH_MAX_LEAF && (bestAxis < 0 || splitCost >= leafCost)) return;
+
+        // Partition (identical centroids: split the range in half)
+        unsigned int first = node.leftFirst;
+        unsigned int* begin = primitiveIndices.data() + first;
+        unsigned int* middle = begin + node.count / 2;
+        if (bestAxis >= 0) {
+            float scale = BVH_BINS / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+            float minimum = centroidMin[bestAxis];
+            middle = std::partition(begin, begin + node.count, [&](unsigned int p) {
+                float centroid = (primitiveMin[p][bestAxis] + primitiveMax[p][bestAxis]) * 0.5f;
+                return std::min(BVH_BINS - 1, (unsigned int)((centroid - minimum) * scale)) < bestSplit;
+            });
+        }
+        unsigned int leftCount = (unsigned int)(middle - begin);
+        if (leftCount == 0 || leftCount == node.count) leftCount = node.count / 2;
+
+        unsigned int left = nodeCount.fetch_add(2);
+        buildNodes[left].leftFirst = first;
+        buildNodes[left].count = leftCount;
+        buildNodes[left + 1].leftFirst = first + leftCount;
+        buildNodes[left + 1].count = node.count - leftCount;
+        node.leftFirst = left;
+        node.count = 0;
+
+        // The two halves are independent: a large left half becomes a job another worker can steal
+        if (parallel && buildNodes[left].count >= BVH_PARALLEL_THRESHOLD) {
+            JobSystem& jobs = jobSystem();
+            JobCounter counter;
+            std::vector<BuildNode>* nodesPointer = &buildNodes;
+            std::atomic<unsigned int>* countPointer = &nodeCount;
+            jobs.run([this, nodesPointer, countPointer, left]() { subdivide(*nodesPointer, *countPointer, left, true); }, &counter);
+            subdivide(buildNodes, nodeCount, left + 1, true);
+            jobs.wait(counter);
+        } else {
+            subdivide(buildNodes, nodeCount, left, parallel);
+            subdivide(buildNodes, nodeCount, left + 1, parallel);
+        }
+    }
+
+    // Binary -> 4 wide: open the largest internal child until a node has 4 children
+    // Nodes are emitted depth first, so children always follow their parent (refit walks backwards)
+    void collapse (const std::vector<BuildNode>& buildNodes)
+    {
+        if (buildNodes[0].count > 0) {
+            // Single leaf: wrap it in a root with one child
+            nodes.resize(1);
+            clearNode(nodes[0]);
+            setChild(nodes[0], 0, buildNodes[0], 0);
+            depth = 1;
+            return;
+        }
+        nodes.reserve(buildNodes.size() / 2 + 1);
+        collapseNode(buildNodes, 0, 1);
+    }
+
+    static void clearNode (BVH4Node& node)
+    {
+        for (int i = 0; i < 4; i++) {
+            node.minX[i] = node.minY[i] = node.minZ[i] = std::numeric_limits<float>::max();
+            node.maxX[i] = node.maxY[i] = node.maxZ[i] = -std::numeric_limits<float>::max();
+            node.child[i] = BVH_INVALID;
+            node.count[i] = 0;
+        }
+    }
+
+    static void setChild (BVH4Node& node, int slot, const BuildNode& source, unsigned int child)
+    {
+        node.minX[slot] = source.boundsMin.x; node.minY[slot] = source.boundsMin.y; node.minZ[slot] = source.boundsMin.z;
+        node.maxX[slot] = source.boundsMax.x; node.maxY[slot] = source.boundsMax.y; node.maxZ[slot] = source.boundsMax.z;
+        node.child[slot] = source.count > 0 ? source.leftFirst : child;
+        node.count[slot] = source.count;
+    }
+
+    unsigned int collapseNode (const std::vector<BuildNode>& buildNodes, unsigned int binaryIndex, unsigned int level)
+    {
+        depth = std::max(depth, level);
+        // Gather up to 4 binary descendants
+        unsigned int gathered[4] = {buildNodes[binaryIndex].leftFirst, buildNodes[binaryIndex].leftFirst + 1, 0, 0};
+        unsigned int gatheredCount = 2;
+        while (gatheredCount < 4) {
+            int open = -1;
+            float openArea = -1.0f;
+            for (unsigned int i = 0; i < gatheredCount; i++) {
+                const BuildNode& candidate = buildNodes[gathered[i]];
+                float candidateArea = area(candidate.boundsMin, candidate.boundsMax);
+                if (candidate.count == 0 && candidateArea > openArea) { open = (int)i; openArea = candidateArea; }
+            }
+            if (open < 0) break;
+            unsigned int left = buildNodes[gathered[open]].leftFirst;
+            gathered[open] = left;
+            gathered[gatheredCount++] = left + 1;
+        }
+
+        unsigned int nodeIndex = (unsigned int)nodes.size();
+        nodes.emplace_back();
+        clearNode(nodes[nodeIndex]);
+        for (unsigned int i = 0; i < gatheredCount; i++) {
+            const BuildNode& source = buildNodes[gathered[i]];
+            unsigned int child = source.count > 0 ? 0 : collapseNode(buildNodes, gathered[i], level + 1);
+            setChild(nodes[nodeIndex], (int)i, source, child);
+        }
+        return nodeIndex;
+    }
+
+    // Refit: recompute the boxes after primitives moved (same topology, quality degrades with large motion)
+    // Triangles: update positions first; boxes: update primitiveMin / primitiveMax (or use updateBox)
+    void refit ()
+    {
+        if (isTriangles()) {
+            for (size_t t = 0; t < primitiveMin.size(); t++) {
+                const glm::vec3& a = positions[indices[t * 3]];
+                const glm::vec3& b = positions[indices[t * 3 + 1]];
+                const glm::vec3& c = positions[indices[t * 3 + 2]];
+                primitiveMin[t] = glm::min(a, glm::min(b, c));
+                primitiveMax[t] = glm::max(a, glm::max(b, c));
+            }
+        }
+
+        for (size_t n = nodes.size(); n-- > 0;) {
+            BVH4Node& node = nodes[n];
+            for (int slot = 0; slot < 4; slot++) {
+                if (node.child[slot] == BVH_INVALID) continue;
+                glm::vec3 boundsMin(std::numeric_limits<float>::max()), boundsMax(-std::numeric_limits<float>::max());
+                if (node.count[slot] > 0) {
+                    for (unsigned int i = node.child[slot]; i < node.child[slot] + node.count[slot]; i++) {
+                        boundsMin = glm::min(boundsMin, primitiveMin[primitiveIndices[i]]);
+                        boundsMax = glm::max(boundsMax, primitiveMax[primitiveIndices[i]]);
+                    }
+                } else {
+                    const BVH4Node& child = nodes[node.child[slot]];
+                    for (int c = 0; c < 4; c++) {
+                        if (child.child[c] == BVH_INVALID) continue;
+                        boundsMin = glm::min(boundsMin, glm::vec3(child.minX[c], child.minY[c], child.minZ[c]));
+                        boundsMax = glm::max(boundsMax, glm::vec3(child.maxX[c], child.maxY[c], child.maxZ[c]));
+                    }
+                }
+                node.minX[slot] = boundsMin.x; node.minY[slot] = boundsMin.y; node.minZ[slot] = boundsMin.z;
+                node.maxX[slot] = boundsMax.x; node.maxY[slot] = boundsMax.y; node.maxZ[slot] = boundsMax.z;
+            }
+        }
+    }
+
+    void updateBox (unsigned int primitive, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        primitiveMin[primitive] = boxMin;
+        primitiveMax[primitive] = boxMax;
+    }
+
+    // Entries a depth first traversal can hold at once: every level above the deepest node leaves up to 3 siblings
+    // on the stack, the deepest node pushes 4 children
+    unsigned int stackSize () const { return 3 * depth + 1; }
+
+    // Traversal stack: the local array when the tree fits it (every tree of a sane build), the heap otherwise
+    template <typename Entry>
+    Entry* traversalStack (Entry* localStack, std::vector<Entry>& heapStack) const
+    {
+        if (stackSize() <= BVH_STACK_SIZE) return localStack;
+        heapStack.resize(stackSize());
+        return heapStack.data();
+    }
+
+    // Ray vs the 4 child boxes of a node: hit mask and entry distances
+    static unsigned int intersectNode (const BVH4Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float tMax, float tEntry[4])
+    {
+#ifdef BVH_SSE
+        __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+        __m128 ix = _mm_set1_ps(inverseDirection.x), iy = _mm_set1_ps(inverseDirection.y), iz = _mm_set1_ps(inverseDirection.z);
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minX), ox), ix);
+        __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxX), ox), ix);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minY), oy), iy);
+        __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxY), oy), iy);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minZ), oz), iz);
+        __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxZ), oz), iz);
+        __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_max_ps(_mm_min_ps(t1z, t2z), _mm_setzero_ps()));
+        __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_min_ps(_mm_max_ps(t1z, t2z), _mm_set1_ps(tMax)));
+        _mm_storeu_ps(tEntry, tNear);
+        return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < 4; i++) {
+            float t1x = (node.minX[i] - origin.x) * inverseDirection.x, t2x = (node.maxX[i] - origin.x) * inverseDirection.x;
+            float t1y = (node.minY[i] - origin.y) * inverseDirection.y, t2y = (node.maxY[i] - origin.y) * inverseDirection.y;
+            float t1z = (node.minZ[i] - origin.z) * inverseDirection.z, t2z = (node.maxZ[i] - origin.z) * inverseDirection.z;
+            float tNear = std::max(std::max(std::min(t1x, t2x), std::min(t1y, t2y)), std::max(std::min(t1z, t2z), 0.0f));
+            float tFar = std::min(std::min(std::max(t1x, t2x), std::max(t1y, t2y)), std::min(std::max(t1z, t2z), tMax));
+            tEntry[i] = tNear;
+            mask |= (tNear <= tFar) << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Ray vs triangle (Moller-Trumbore), double sided
+    bool intersectTriangle (unsigned int triangle, const BVHRay& ray, BVHHit& hit) const
+    {
+        const glm::vec3& a = positions[indices[triangle * 3]];
+        glm::vec3 ab = positions[indices[triangle * 3 + 1]] - a;
+        glm::vec3 ac = positions[indices[triangle * 3 + 2]] - a;
+        glm::vec3 p = glm::cross(ray.direction, ac);
+        float determinant = glm::dot(ab, p);
+        if (std::abs(determinant) < 1e-12f) return false;
+        float inverse = 1.0f / determinant;
+        glm::vec3 s = ray.origin - a;
+        float u = glm::dot(s, p) * inverse;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, ab);
+        float v = glm::dot(ray.direction, q) * inverse;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        float t = glm::dot(ac, q) * inverse;
+        if (t < 0.0f || t >= hit.t) return false;
+        hit.t = t; hit.u = u; hit.v = v; hit.primitive = triangle;
+        return true;
+    }
+
+    // Ray vs box primitive (entry distance, 0 when the origin is inside)
+    bool intersectBox (unsigned int box, const BVHRay& ray, const glm::vec3& inverseDirection, BVHHit& hit) const
+    {
+        glm::vec3 t1 = (primitiveMin[box] - ray.origin) * inverseDirection;
+        glm::vec3 t2 = (primitiveMax[box] - ray.origin) * inverseDirection;
+        glm::vec3 tSmall = glm::min(t1, t2), tLarge = glm::max(t1, t2);
+        float tNear = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+        float tFar = std::min(std::min(tLarge.x, tLarge.y), tLarge.z);
+        if (tNear > tFar || tNear >= hit.t) return false;
+        hit.t = tNear; hit.u = hit.v = 0.0f; hit.primitive = box;
+        return true;
+    }
+
+    // Closest hit along the ray; children are visited nearest first so far subtrees are pruned by hit.t
+    bool raycast (const BVHRay& ray, BVHHit& hit) const
+    {
+        hit.t = ray.tMax;
+        hit.primitive = BVH_INVALID;
+        hit.u = hit.v = 0.0f;
+        if (nodes.empty()) return false;
+
+        glm::vec3 inverseDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+        struct Entry { unsigned int child, count; float t; };
+        Entry localStack[BVH_STACK_SIZE];
+        std::vector<Entry> heapStack;
+        Entry* stack = traversalStack(localStack, heapStack);
+        int top = 0;
+        stack[top++] = {0, 0, 0.0f};
+
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.t >= hit.t) continue;
+
+            // Leaf
+            if (entry.count > 0) {
+                for (unsigned int i = entry.child; i < entry.child + entry.count; i++) {
+                    if (isTriangles()) intersectTriangle(primitiveIndices[i], ray, hit);
+                    else intersectBox(primitiveIndices[i], ray, inverseDirection, hit);
+                }
+                continue;
+            }
+
+            // Node: push hit children far to near
+            const BVH4Node& node = nodes[entry.child];
+            float tEntry[4];
+            unsigned int mask = intersectNode(node, ray.origin, inverseDirection, hit.t, tEntry);
+            Entry hits[4];
+            int hitCount = 0;
+            for (int i = 0; i < 4; i++)
+                if (((mask >> i) & 1) && node.child[i] != BVH_INVALID) hits[hitCount++] = {node.child[i], node.count[i], tEntry[i]};
+            for (int i = 1; i < hitCount; i++)
+                for (int j = i; j > 0 && hits[j - 1].t < hits[j].t; j--) std::swap(hits[j - 1], hits[j]);
+            for (int i = 0; i < hitCount; i++) stack[top++] = hits[i];
+        }
+
+        return hit.primitive != BVH_INVALID;
+    }
+
+    // Every primitive whose box overlaps the query box
+    void overlap (const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<unsigned int>& result) const
+    {
+        result.clear();
+        if (nodes.empty()) return;
+
+        unsigned int localStack[BVH_STACK_SIZE];
+        std::vector<unsigned int> heapStack;
+        unsigned int* stack = traversalStack(localStack, heapStack);
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BVH4Node& node = nodes[stack[--top]];
+            unsigned int mask = 0;
+#ifdef BVH_SSE
+            __m128 outside = _mm_or_ps(
+                _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.minX), _mm_set1_ps(boxMax.x)), _mm_cmplt_ps(_mm_loadu_ps(node.maxX), _mm_set1_ps(boxMin.x))),
+                          _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.minY), _mm_set1_ps(boxMax.y)), _mm_cmplt_ps(_mm_loadu_ps(node.maxY), _mm_set1_ps(boxMin.y)))),
+                _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.minZ), _mm_set1_ps(boxMax.z)), _mm_cmplt_ps(_mm_loadu_ps(node.maxZ), _mm_set1_ps(boxMin.z))));
+            mask = ~(unsigned int)_mm_movemask_ps(outside) & 0xF;
+#else
+            for (int i = 0; i < 4; i++)
+                mask |= (node.minX[i] <= boxMax.x && node.maxX[i] >= boxMin.x && node.minY[i] <= boxMax.y &&
+                         node.maxY[i] >= boxMin.y && node.minZ[i] <= boxMax.z && node.maxZ[i] >= boxMin.z) << i;
+#endif
+            for (int i = 0; i < 4; i++) {
+                if (!((mask >> i) & 1) || node.child[i] == BVH_INVALID) continue;
+                if (node.count[i] == 0) {
+                    stack[top++] = node.child[i];
+                    continue;
+                }
+                for (unsigned int p = node.child[i]; p < node.child[i] + node.count[i]; p++) {
+                    unsigned int primitive = primitiveIndices[p];
+                    if (glm::all(glm::lessThanEqual(primitiveMin[primitive], boxMax)) && glm::all(glm::greaterThanEqual(primitiveMax[primitive], boxMin)))
+                        result.push_back(primitive);
+                }
+            }
+        }
+    }
+
+    // Nearest point on any primitive within maxDistance (closest surface point for triangles, box surface / inside for boxes)
+    bool nearestPoint (const glm::vec3& point, float maxDistance, glm::vec3& closest, unsigned int& primitive) const
+    {
+        primitive = BVH_INVALID;
+        if (nodes.empty()) return false;
+        float bestSquared = maxDistance * maxDistance;
+
+        struct Entry { unsigned int child, count; float distanceSquared; };
+        Entry localStack[BVH_STACK_SIZE];
+        std::vector<Entry> heapStack;
+        Entry* stack = traversalStack(localStack, heapStack);
+        int top = 0;
+        stack[top++] = {0, 0, 0.0f};
+
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.distanceSquared > bestSquared) continue;
+
+            if (entry.count > 0) {
+                for (unsigned int i = entry.child; i < entry.child + entry.count; i++) {
+                    unsigned int candidate = primitiveIndices[i];
+                    glm::vec3 p = isTriangles()
+                        ? closestPointTriangle(point, positions[indices[candidate * 3]], positions[indices[candidate * 3 + 1]], positions[indices[candidate * 3 + 2]])
+                        : glm::clamp(point, primitiveMin[candidate], primitiveMax[candidate]);
+                    float distanceSquared = glm::dot(p - point, p - point);
+                    if (distanceSquared <= bestSquared) { bestSquared = distanceSquared; closest = p; primitive = candidate; }
+                }
+                continue;
+            }
+
+            // Squared distance from the point to the 4 child boxes
+            const BVH4Node& node = nodes[entry.child];
+            float distance[4];
+#ifdef BVH_SSE
+            __m128 px = _mm_set1_ps(point.x), py = _mm_set1_ps(point.y), pz = _mm_set1_ps(point.z);
+            __m128 dx = _mm_sub_ps(_mm_min_ps(_mm_max_ps(px, _mm_loadu_ps(node.minX)), _mm_loadu_ps(node.maxX)), px);
+            __m128 dy = _mm_sub_ps(_mm_min_ps(_mm_max_ps(py, _mm_loadu_ps(node.minY)), _mm_loadu_ps(node.maxY)), py);
+            __m128 dz = _mm_sub_ps(_mm_min_ps(_mm_max_ps(pz, _mm_loadu_ps(node.minZ)), _mm_loadu_ps(node.maxZ)), pz);
+            _mm_storeu_ps(distance, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+#else
+            for (int i = 0; i < 4; i++) {
+                glm::vec3 d = glm::clamp(point, glm::vec3(node.minX[i], node.minY[i], node.minZ[i]), glm::vec3(node.maxX[i], node.maxY[i], node.maxZ[i])) - point;
+                distance[i] = glm::dot(d, d);
+            }
+#endif
+            Entry children[4];
+            int childCount = 0;
+            for (int i = 0; i < 4; i++)
+                if (node.child[i] != BVH_INVALID && distance[i] <= bestSquared) children[childCount++] = {node.child[i], node.count[i], distance[i]};
+            for (int i = 1; i < childCount; i++)
+                for (int j = i; j > 0 && children[j - 1].distanceSquared < children[j].distanceSquared; j--) std::swap(children[j - 1], children[j]);
+            for (int i = 0; i < childCount; i++) stack[top++] = children[i];
+        }
+
+        return primitive != BVH_INVALID;
+    }
+};
+
+#endif
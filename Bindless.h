@@ -0,0 +1,166 @@
+#ifndef BINDLESS_H
+#define BINDLESS_H
+
+#include <GL/glew.h>                  // GLEW for OpenGL functions
+#include <glm/glm.hpp>                // Include all GLM core / GLSL features
+
+#include "TexturePacker.h"            // TextureAtlasEntry (fallback materials)
+#include "Sampler.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+
+// Bindless Textures
+// Every material is one entry of a table in a shader storage buffer, indexed by the material ID of the draw
+// (gl_BaseInstance: the baseInstance of a multi-draw-indirect command or glDraw*BaseInstance), so one
+// multi-draw batch can span any number of materials without a single texture bind in between.
+// With ARB_bindless_texture the entry holds the 64-bit handle of a resident texture (fragment_shader_bindless.glsl);
+// without it (llvmpipe, older drivers) it holds a layer and UV rectangle of one packed texture array
+// (TexturePacker.h) bound once for the batch (fragment_shader_material.glsl).
+// A resident handle must be made non resident before its texture is deleted (Residency eviction: release()).
+// Handles are texture + sampler pairs (glGetTextureSamplerHandleARB): the filtering of a bindless material is its
+// sampler's (SamplerCache), the fallback array is sampled with a clamped trilinear sampler.
+// The same pair always yields the same handle, so materials sharing a texture and a sampler share one handle:
+// residency is reference counted per handle, made resident by its first user and non resident by its last.
+
+const unsigned int BINDLESS_MATERIAL_BINDING = 6;   // layout(std430, binding = 6) MaterialBuffer
+
+// Material table entry (std430: 32 bytes)
+struct BindlessMaterial {
+    uint64_t handle;      // Bindless texture handle (uvec2 in GLSL), 0 in fallback mode
+    uint32_t layer;       // Fallback: texture array layer
+    uint32_t flags;
+    glm::vec4 uvRect;     // UV offset (xy) and scale (zw): (0, 0, 1, 1) for whole textures
+};
+
+static_assert(sizeof(BindlessMaterial) == 32, "BindlessMaterial must match the std430 layout");
+
+inline bool bindlessSupported ()
+{
+    return GLEW_ARB_bindless_texture != 0;
+}
+
+// Fragment shader for the material path in use
+inline std::string bindlessFragmentShader (bool bindless)
+{
+    return bindless ? "./shaders/Fragment_Shader/fragment_shader_bindless.glsl" : "./shaders/Fragment_Shader/fragment_shader_material.glsl";
+}
+
+struct BindlessTextureTable {
+
+    bool bindless;                          // ARB_bindless_texture path (false: texture array fallback)
+    unsigned int materialSSBO = 0;
+    unsigned int fallbackArray = 0;         // Fallback: the one texture array every material samples
+    std::vector<BindlessMaterial> materials;
+    std::vector<unsigned int> textures;     // Bindless: texture of every material (0 in fallback mode)
+    std::vector<unsigned int> samplers;     // Bindless: sampler of every material's handle
+    std::vector<std::pair<uint64_t, unsigned int>> residentHandles;   // Bindless: resident handle, materials using it
+    unsigned int arraySampler = 0;          // Fallback array sampler
+    bool dirty = false;
+
+    // Constructor: bindless when the extension is present, unless forced off (tests of the fallback path)
+    BindlessTextureTable (bool allowBindless = true) : bindless(allowBindless && bindlessSupported())
+    {
+        glGenBuffers(1, &materialSSBO);
+        arraySampler = samplerCache().get(samplerTrilinear(GL_CLAMP_TO_EDGE));
+    }
+
+    // Destructor
+    ~BindlessTextureTable ()
+    {
+        for (unsigned int material = 0; material < (unsigned int)materials.size(); material++) release(material);
+        glDeleteBuffers(1, &materialSSBO);
+    }
+
+    // Bindless material from a complete texture and a sampler (0: the cache's default), both frozen once the handle exists
+    unsigned int add (unsigned int texture, unsigned int sampler = 0)
+    {
+        BindlessMaterial material = {0, 0, 0, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)};
+        if (!sampler) sampler = samplerCache().defaultSampler();
+        if (bindless) material.handle = acquireHandle(texture, sampler);
+        materials.push_back(material);
+        textures.push_back(texture);
+        samplers.push_back(sampler);
+        dirty = true;
+        return (unsigned int)materials.size() - 1;
+    }
+
+    // Fallback material: a texture packed into the fallback array
+    unsigned int add (const TextureAtlasEntry& entry)
+    {
+        materials.push_back({0, entry.layer, 0, entry.uvRect});
+        textures.push_back(0);
+        samplers.push_back(arraySampler);
+        dirty = true;
+        return (unsigned int)materials.size() - 1;
+    }
+
+    // Replace the texture of a material (re-streamed texture), same sampler: the old handle is released first
+    void set (unsigned int material, unsigned int texture)
+    {
+        release(material);
+        if (bindless && texture) materials[material].handle = acquireHandle(texture, samplers[material]);
+        textures[material] = texture;
+        dirty = true;
+    }
+
+    // Handle of a texture + sampler pair, made resident by its first user
+    uint64_t acquireHandle (unsigned int texture, unsigned int sampler)
+    {
+        uint64_t handle = glGetTextureSamplerHandleARB(texture, sampler);
+        for (std::pair<uint64_t, unsigned int>& resident : residentHandles)
+            if (resident.first == handle) {
+                resident.second++;
+                return handle;
+            }
+        glMakeTextureHandleResidentARB(handle);
+        residentHandles.push_back({handle, 1});
+        return handle;
+    }
+
+    // One user less: non resident once no material uses the handle
+    void releaseHandle (uint64_t handle)
+    {
+        for (size_t i = 0; i < residentHandles.size(); i++) {
+            if (residentHandles[i].first != handle) continue;
+            if (--residentHandles[i].second == 0) {
+                glMakeTextureHandleNonResidentARB(handle);
+                residentHandles[i] = residentHandles.back();
+                residentHandles.pop_back();
+            }
+            return;
+        }
+    }
+
+    // Release the material's handle (before the texture is deleted / evicted): non resident when it was the last user
+    void release (unsigned int material)
+    {
+        if (materials[material].handle) releaseHandle(materials[material].handle);
+        materials[material].handle = 0;
+        textures[material] = 0;
+        dirty = true;
+    }
+
+    // Upload the table when it changed, bind it (and the fallback array) for the draws
+    void bind ()
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialSSBO);
+        if (dirty) {
+            glBufferData(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(BindlessMaterial), materials.data(), GL_DYNAMIC_DRAW);
+            dirty = false;
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDLESS_MATERIAL_BINDING, materialSSBO);
+
+        if (!bindless) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, fallbackArray);
+            glBindSampler(0, arraySampler);
+        }
+    }
+};
+
+#endif
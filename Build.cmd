@@ -6,7 +6,7 @@ set project_dir=%~dp0
 
 :: Compile C++ / OpenGL
 echo Compiling C++ / OpenGL
-g++ App.cpp -o App ^
+g++ -std=c++20 App.cpp ImageDecoder.cpp -o App -msse2 -mstackrealign ^
 -I"%project_dir%/include" ^
 -L"%project_dir%/lib" ^
 -lglfw3 -lglew32 -lassimp -lopengl32 -luser32 -lgdi32 -lshell32
@@ -17,28 +17,23 @@ if errorlevel 1 (
     echo Compiled
 )
 
-:: Compile Shaders
+:: Validate Shaders: every shader (material templates: every variant) through glslang, as the app preprocesses it
 set bin_dir=%project_dir%bin
-set shader_dir=%project_dir%shaders
 
-:: Vertex Shader
-echo Compiling Vertex Shader
-%bin_dir%/glslang -V -S vert "%shader_dir%/vertex_shader/vertex_shader.glsl" -o "%shader_dir%/vertex_shader/vertex_shader.spv"
+echo Validating Shaders
+g++ -std=c++20 -O2 "%project_dir%tools/ShaderValidator.cpp" -o "%project_dir%tools/ShaderValidator" ^
+-I"%project_dir%/include"
 
 if errorlevel 1 (
     echo Error
 ) else (
-    echo Compiled
+    "%project_dir%tools\ShaderValidator" --glslang "%bin_dir%/glslang" "%project_dir%shaders"
 )
 
-:: Fragment Shader
-echo Compiling Fragment Shader
-%bin_dir%/glslang -V -S frag "%shader_dir%/fragment_shader/fragment_shader.glsl" -o "%shader_dir%/fragment_shader/fragment_shader.spv"
-
 if errorlevel 1 (
     echo Error
 ) else (
-    echo Compiled
+    echo Validated
 )
 
 pause
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+#include "Frustum.h"
+
+// Camera
+// Position + yaw / pitch (degrees) looking down -Z at yaw = -90, perspective projection with OpenGL clip space
+struct Camera {
+
+    glm::vec3 position;
+    float yaw, pitch;
+    float fov;            // Vertical field of view (degrees)
+    float aspect;         // Width / height
+    float nearPlane, farPlane;
+
+    // Constructor
+    Camera (const glm::vec3& cameraPosition = glm::vec3(0.0f, 0.0f, 2.0f), float cameraYaw = -90.0f, float cameraPitch = 0.0f)
+        : position(cameraPosition), yaw(cameraYaw), pitch(cameraPitch), fov(45.0f), aspect(16.0f / 9.0f), nearPlane(0.1f), farPlane(1000.0f) {}
+
+    // Direction the camera looks at
+    glm::vec3 front () const
+    {
+        float yawRadians = glm::radians(yaw);
+        float pitchRadians = glm::radians(pitch);
+        return glm::normalize(glm::vec3(cos(yawRadians) * cos(pitchRadians), sin(pitchRadians), sin(yawRadians) * cos(pitchRadians)));
+    }
+
+    glm::vec3 right () const
+    {
+        return glm::normalize(glm::cross(front(), glm::vec3(0.0f, 1.0f, 0.0f)));
+    }
+
+    // Matrices
+    glm::mat4 view () const
+    {
+        return glm::lookAt(position, position + front(), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    glm::mat4 projection () const
+    {
+        return glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+    }
+
+    glm::mat4 viewProjection () const
+    {
+        return projection() * view();
+    }
+
+    // World space frustum used by the culling
+    Frustum frustum () const
+    {
+        return Frustum::fromMatrix(viewProjection());
+    }
+
+    // Window resize: keep the projection aspect in sync with the framebuffer
+    void resize (int width, int height)
+    {
+        if (width > 0 && height > 0)
+            aspect = (float)width / (float)height;
+    }
+
+    // Free fly movement (units per second) and mouse look (degrees per pixel)
+    void move (const glm::vec3& direction, float speed, float deltaTime)
+    {
+        position += (front() * direction.z + right() * direction.x + glm::vec3(0.0f, 1.0f, 0.0f) * direction.y) * speed * deltaTime;
+    }
+
+    void look (float deltaX, float deltaY, float sensitivity = 0.1f)
+    {
+        yaw += deltaX * sensitivity;
+        pitch = glm::clamp(pitch - deltaY * sensitivity, -89.0f, 89.0f);
+    }
+};
+
+#endif
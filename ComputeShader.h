@@ -0,0 +1,98 @@
+#ifndef COMPUTE_SHADER_H
+#define COMPUTE_SHADER_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+
+#include "ShaderPreprocessor.h"  // #include / #line / dependencies
+#include "ShaderDiagnostics.h"   // Full logs, source excerpts, failure propagation
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <sstream>
+#include <fstream>
+
+// Compute Shader
+struct ComputeShader {
+
+    std::string computeShader;
+    std::string shaderName;              // Compute shader path (logs)
+    unsigned int shaderProgramID;        // 0 when the program failed to build
+    std::vector<std::pair<std::string, int>> uniformLocations;   // Cleared when the program is relinked
+
+    // Constructor
+    ComputeShader (const std::string& computeShaderPath) : shaderProgramID(0)
+    {
+        computeShader = shaderRead(computeShaderPath);
+        shaderName = computeShaderPath;
+        shaderProgram();
+    }
+
+    // Reader: source with its #includes resolved (memoized by the shared preprocessor)
+    std::string shaderRead (const std::string& filePath)
+    {
+        return shaderPreprocessor().preprocess(filePath).text;
+    }
+
+    // Program: 0 when the shader does not compile or link (the log points at the source lines)
+    bool shaderProgram ()
+    {
+        uniformLocations.clear();
+        ShaderResult program = shaderLink({{GL_COMPUTE_SHADER, computeShader}}, shaderName);
+        shaderProgramID = program.id;
+        return program.success;
+    }
+
+    // Dispatch: work groups in x, y, z
+    void shaderDispatch (unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1)
+    {
+        if (!shaderProgramID) return;    // Failed build: nothing dispatched (the pass keeps its previous results)
+        glUseProgram(shaderProgramID);
+        glDispatchCompute(groupsX, groupsY, groupsZ);
+    }
+
+    // Uniform Location: looked up once per name, then served from the cache
+    int uniformLocation (const char* name)
+    {
+        for (const std::pair<std::string, int>& uniform : uniformLocations)
+            if (uniform.first == name) return uniform.second;
+        int location = glGetUniformLocation(shaderProgramID, name);
+        uniformLocations.push_back({name, location});
+        return location;
+    }
+
+    // Bind Uniform
+    void bindUniformInt (const char* name, int value)
+    {
+        glProgramUniform1i(shaderProgramID, uniformLocation(name), value);
+    }
+
+    void bindUniformUint (const char* name, unsigned int value)
+    {
+        glProgramUniform1ui(shaderProgramID, uniformLocation(name), value);
+    }
+
+    void bindUniformVec3 (const char* name, const float* value)
+    {
+        glProgramUniform3fv(shaderProgramID, uniformLocation(name), 1, value);
+    }
+
+    void bindUniformVec4Array (const char* name, const float* value, int count)
+    {
+        glProgramUniform4fv(shaderProgramID, uniformLocation(name), count, value);
+    }
+
+    void bindUniformMat4 (const char* name, const float* value)
+    {
+        glProgramUniformMatrix4fv(shaderProgramID, uniformLocation(name), 1, GL_FALSE, value);
+    }
+
+    // Destructor
+    ~ComputeShader ()
+    {
+        glDeleteProgram(shaderProgramID);
+    }
+};
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+
+#include "Frustum.h"
+#include "DrawCommand.h"
+#include "JobSystem.h"
+
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+// SIMD width used by the culling loops: AVX = 8 objects, SSE2 = 4 objects (every x86-64 CPU), scalar otherwise
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define CULLING_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CULLING_SIMD_WIDTH 4
+#else
+    #define CULLING_SIMD_WIDTH 1
+#endif
+
+// Below this many objects the cull runs on the calling thread (scheduling costs more than the test)
+const unsigned int CULLING_PARALLEL_THRESHOLD = 32768;
+
+// Aligned Allocator: 32 byte aligned storage so a SoA row can be loaded into AVX registers
+template <typename T, std::size_t Alignment = 32>
+struct AlignedAllocator {
+    typedef T value_type;
+    template <typename U> struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator () {}
+    template <typename U> AlignedAllocator (const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate (std::size_t n)
+    {
+        void* memory = ::operator new(n * sizeof(T), std::align_val_t(Alignment));
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate (T* memory, std::size_t)
+    {
+        ::operator delete(memory, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator== (const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!= (const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float>> AlignedFloats;
+
+// Culling volume
+enum CullingVolume {
+    CULL_SPHERE,   // Bounding sphere (center, radius): 4 multiply-adds per plane
+    CULL_AABB      // Axis aligned box (center, half extent): tighter, 3 more multiply-adds per plane
+};
+
+// Culling Bounds: structure of arrays, one row per component, index = object ID
+struct CullingBounds {
+
+    AlignedFloats centerX, centerY, centerZ, radius;
+    AlignedFloats extentX, extentY, extentZ;
+
+    unsigned int size () const { return (unsigned int)centerX.size(); }
+    glm::vec3 center (unsigned int index) const { return glm::vec3(centerX[index], centerY[index], centerZ[index]); }
+
+    void reserve (unsigned int count)
+    {
+        for (AlignedFloats* row : {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ})
+            row->reserve(count);
+    }
+
+    void clear ()
+    {
+        for (AlignedFloats* row : {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ})
+            row->clear();
+    }
+
+    // Add an object from its world space AABB, returns its index
+    unsigned int add (const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        for (AlignedFloats* row : {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ})
+            row->push_back(0.0f);
+        set(size() - 1, boxMin, boxMax);
+        return size() - 1;
+    }
+
+    // Update a moved object
+    void set (unsigned int index, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        glm::vec3 center = (boxMin + boxMax) * 0.5f;
+        glm::vec3 extent = (boxMax - boxMin) * 0.5f;
+        centerX[index] = center.x; centerY[index] = center.y; centerZ[index] = center.z;
+        extentX[index] = extent.x; extentY[index] = extent.y; extentZ[index] = extent.z;
+        radius[index] = glm::length(extent);
+    }
+};
+
+// Scalar reference: writes the visible indices of [begin, end) to out, returns how many
+inline unsigned int cullScalar (const CullingBounds& bounds, const Frustum& frustum, CullingVolume volume,
+                                unsigned int begin, unsigned int end, unsigned int* out)
+{
+    unsigned int visible = 0;
+    for (unsigned int i = begin; i < end; i++) {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++) {
+            const glm::vec4& plane = frustum.planes[p];
+            float distance = plane.x * bounds.centerX[i] + plane.y * bounds.centerY[i] + plane.z * bounds.centerZ[i] + plane.w;
+            float reach = (volume == CULL_SPHERE)
+                ? bounds.radius[i]
+                : std::abs(plane.x) * bounds.extentX[i] + std::abs(plane.y) * bounds.extentY[i] + std::abs(plane.z) * bounds.extentZ[i];
+            inside = distance >= -reach;
+        }
+        out[visible] = i;
+        visible += inside;
+    }
+    return visible;
+}
+
+// SIMD: CULLING_SIMD_WIDTH objects per instruction, the planes are broadcast once per call
+// Compaction is branchless: every lane writes its index, the count only advances for visible lanes
+inline unsigned int cullSimd (const CullingBounds& bounds, const Frustum& frustum, CullingVolume volume,
+                              unsigned int begin, unsigned int end, unsigned int* out)
+{
+#if CULLING_SIMD_WIDTH == 8
+    typedef __m256 simd;
+    #define CULL_SET1 _mm256_set1_ps
+    #define CULL_LOAD _mm256_loadu_ps
+    #define CULL_ADD _mm256_add_ps
+    #define CULL_MUL _mm256_mul_ps
+    #define CULL_SUB _mm256_sub_ps
+    #define CULL_AND _mm256_and_ps
+    #define CULL_GE(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+    #define CULL_MASK _mm256_movemask_ps
+    #define CULL_TRUE _mm256_castsi256_ps(_mm256_set1_epi32(-1))
+#elif CULLING_SIMD_WIDTH == 4
+    typedef __m128 simd;
+    #define CULL_SET1 _mm_set1_ps
+    #define CULL_LOAD _mm_loadu_ps
+    #define CULL_ADD _mm_add_ps
+    #define CULL_MUL _mm_mul_ps
+    #define CULL_SUB _mm_sub_ps
+    #define CULL_AND _mm_and_ps
+    #define CULL_GE(a, b) _mm_cmpge_ps(a, b)
+    #define CULL_MASK _mm_movemask_ps
+    #define CULL_TRUE _mm_castsi128_ps(_mm_set1_epi32(-1))
+#endif
+
+#if CULLING_SIMD_WIDTH > 1
+    const unsigned int width = CULLING_SIMD_WIDTH;
+
+    // Broadcast planes: (x, y, z, w) and |x|, |y|, |z| for the box reach
+    simd planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+    for (int p = 0; p < 6; p++) {
+        const glm::vec4& plane = frustum.planes[p];
+        planeX[p] = CULL_SET1(plane.x); planeY[p] = CULL_SET1(plane.y);
+        planeZ[p] = CULL_SET1(plane.z); planeW[p] = CULL_SET1(plane.w);
+        absX[p] = CULL_SET1(std::abs(plane.x)); absY[p] = CULL_SET1(std::abs(plane.y)); absZ[p] = CULL_SET1(std::abs(plane.z));
+    }
+    const simd zero = CULL_SET1(0.0f);
+
+    unsigned int visible = 0;
+    unsigned int i = begin;
+    for (; i + width <= end; i += width) {
+        simd cx = CULL_LOAD(&bounds.centerX[i]);
+        simd cy = CULL_LOAD(&bounds.centerY[i]);
+        simd cz = CULL_LOAD(&bounds.centerZ[i]);
+        simd inside = CULL_TRUE;
+
+        if (volume == CULL_SPHERE) {
+            simd negativeRadius = CULL_SUB(zero, CULL_LOAD(&bounds.radius[i]));
+            for (int p = 0; p < 6; p++) {
+                simd distance = CULL_ADD(CULL_ADD(CULL_MUL(cx, planeX[p]), CULL_MUL(cy, planeY[p])), CULL_ADD(CULL_MUL(cz, planeZ[p]), planeW[p]));
+                inside = CULL_AND(inside, CULL_GE(distance, negativeRadius));
+            }
+        } else {
+            simd ex = CULL_LOAD(&bounds.extentX[i]);
+            simd ey = CULL_LOAD(&bounds.extentY[i]);
+            simd ez = CULL_LOAD(&bounds.extentZ[i]);
+            for (int p = 0; p < 6; p++) {
+                simd distance = CULL_ADD(CULL_ADD(CULL_MUL(cx, planeX[p]), CULL_MUL(cy, planeY[p])), CULL_ADD(CULL_MUL(cz, planeZ[p]), planeW[p]));
+                simd reach = CULL_ADD(CULL_ADD(CULL_MUL(ex, absX[p]), CULL_MUL(ey, absY[p])), CULL_MUL(ez, absZ[p]));
+                inside = CULL_AND(inside, CULL_GE(distance, CULL_SUB(zero, reach)));
+            }
+        }
+
+        unsigned int mask = (unsigned int)CULL_MASK(inside);
+        for (unsigned int lane = 0; lane < width; lane++) {
+            out[visible] = i + lane;
+            visible += (mask >> lane) & 1;
+        }
+    }
+
+    // Tail
+    return visible + cullScalar(bounds, frustum, volume, i, end, out + visible);
+
+    #undef CULL_SET1
+    #undef CULL_LOAD
+    #undef CULL_ADD
+    #undef CULL_MUL
+    #undef CULL_SUB
+    #undef CULL_AND
+    #undef CULL_GE
+    #undef CULL_MASK
+    #undef CULL_TRUE
+#else
+    return cullScalar(bounds, frustum, volume, begin, end, out);
+#endif
+}
+
+// Cull every object: compact list of visible indices (ascending) in visible (any allocator, e.g. FrameVector)
+// Large scenes are split in SIMD aligned chunks run on the job system (chunkCount 0 = one per thread); each
+// chunk compacts into its own slice of the output, the slices are then moved together
+template <typename Allocator>
+void cullObjects (const CullingBounds& bounds, const Frustum& frustum, std::vector<unsigned int, Allocator>& visible,
+                  CullingVolume volume = CULL_SPHERE, unsigned int chunkCount = 0)
+{
+    unsigned int count = bounds.size();
+    visible.resize(count);
+    if (count == 0) return;
+
+    JobSystem& jobs = jobSystem();
+    if (chunkCount == 0) chunkCount = jobs.threadCount();
+    if (count < CULLING_PARALLEL_THRESHOLD || chunkCount == 1) {
+        visible.resize(cullSimd(bounds, frustum, volume, 0, count, visible.data()));
+        return;
+    }
+
+    const unsigned int width = CULLING_SIMD_WIDTH;
+    chunkCount = std::min(chunkCount, 64u);
+    unsigned int chunk = ((count + chunkCount - 1) / chunkCount + width - 1) / width * width;
+    unsigned int chunkVisible[64];
+
+    jobs.parallelFor(chunkCount, 1, [&](unsigned int first, unsigned int last) {
+        for (unsigned int c = first; c < last; c++) {
+            unsigned int begin = std::min(count, c * chunk);
+            unsigned int end = std::min(count, begin + chunk);
+            chunkVisible[c] = cullSimd(bounds, frustum, volume, begin, end, visible.data() + begin);
+        }
+    });
+
+    // Compact the chunk slices
+    unsigned int total = chunkVisible[0];
+    for (unsigned int c = 1; c < chunkCount; c++) {
+        unsigned int begin = std::min(count, c * chunk);
+        for (unsigned int v = 0; v < chunkVisible[c]; v++) visible[total + v] = visible[begin + v];
+        total += chunkVisible[c];
+    }
+    visible.resize(total);
+}
+
+// Draw submission: one indirect command per visible object, baseInstance = object index
+// (lets the vertex shader fetch per object data through gl_BaseInstance)
+template <typename Allocator>
+void cullingDrawCommands (const std::vector<unsigned int, Allocator>& visible, const std::vector<DrawElementsIndirectCommand>& objectCommands,
+                          std::vector<DrawElementsIndirectCommand>& commands)
+{
+    commands.resize(visible.size());
+    for (size_t v = 0; v < visible.size(); v++) {
+        commands[v] = objectCommands[visible[v]];
+        commands[v].baseInstance = visible[v];
+    }
+}
+
+#endif
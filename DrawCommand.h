@@ -0,0 +1,27 @@
+#ifndef DRAW_COMMAND_H
+#define DRAW_COMMAND_H
+
+// Indirect draw commands: same memory layout as the structs read by glDrawElementsIndirect / glDrawArraysIndirect
+// (GL_DRAW_INDIRECT_BUFFER), so they can be written by the CPU or by a compute shader
+
+// glDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    unsigned int count;          // Number of indices
+    unsigned int instanceCount;  // Number of instances (0 = skipped)
+    unsigned int firstIndex;     // First index in the element buffer
+    int baseVertex;              // Added to every index
+    unsigned int baseInstance;   // First instance (gl_BaseInstance / instanced attributes)
+};
+
+// glDrawArraysIndirect
+struct DrawArraysIndirectCommand {
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int first;
+    unsigned int baseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the GL layout");
+static_assert(sizeof(DrawArraysIndirectCommand) == 16, "DrawArraysIndirectCommand must match the GL layout");
+
+#endif
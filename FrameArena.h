@@ -0,0 +1,230 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "JobSystem.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+// Frame Arena
+// Bump allocator for data that lives one update frame (draw lists, visible sets, uniform data): allocation is
+// a pointer increment, there is no free, reset() drops everything at the end of the frame.
+// A full block chains an overflow block; on reset the chain is merged into one block large enough for the
+// high-water mark, so steady state frames make no heap allocation at all.
+// Debug builds (FRAME_ARENA_DEBUG, on unless NDEBUG) poison released memory to catch use-after-frame.
+
+#ifndef FRAME_ARENA_DEBUG
+    #ifdef NDEBUG
+        #define FRAME_ARENA_DEBUG 0
+    #else
+        #define FRAME_ARENA_DEBUG 1
+    #endif
+#endif
+
+const std::size_t FRAME_ARENA_BLOCK_SIZE = 1 << 20;   // 1 MB first block per thread
+const unsigned char FRAME_ARENA_POISON = 0xCD;
+
+// Arena Block: header followed by the memory
+struct FrameArenaBlock {
+    FrameArenaBlock* next;
+    std::size_t size;
+    std::size_t used;
+
+    unsigned char* data () { return reinterpret_cast<unsigned char*>(this + 1); }
+
+    static FrameArenaBlock* create (std::size_t size)
+    {
+        FrameArenaBlock* block = static_cast<FrameArenaBlock*>(std::malloc(sizeof(FrameArenaBlock) + size));
+        if (!block) throw std::bad_alloc();
+        block->next = nullptr;
+        block->size = size;
+        block->used = 0;
+        return block;
+    }
+};
+
+// Frame Arena
+struct FrameArena {
+
+    FrameArenaBlock* first;
+    FrameArenaBlock* current;
+    std::size_t blockSize;
+    std::size_t frameBytes;       // Allocated this frame (including alignment padding)
+    std::size_t highWater;        // Largest frameBytes seen
+    unsigned int overflowBlocks;  // Blocks chained since the last reset
+    unsigned long long heapAllocations;
+
+    // Constructor
+    FrameArena (std::size_t size = FRAME_ARENA_BLOCK_SIZE)
+        : first(nullptr), current(nullptr), blockSize(size), frameBytes(0), highWater(0), overflowBlocks(0), heapAllocations(0) {}
+
+    FrameArena (const FrameArena&) = delete;
+    FrameArena& operator= (const FrameArena&) = delete;
+
+    // Allocate: alignment must be a power of 2
+    void* allocate (std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (!current) {
+            first = current = FrameArenaBlock::create(std::max(blockSize, size + alignment));
+            heapAllocations++;
+        }
+
+        while (true) {
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(current->data());
+            std::uintptr_t aligned = (base + current->used + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+            std::size_t end = (std::size_t)(aligned - base) + size;
+            if (end <= current->size) {
+                frameBytes += end - current->used;
+                highWater = std::max(highWater, frameBytes);
+                current->used = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            // Overflow: next chained block, or a new one
+            if (!current->next || current->next->size < size + alignment) {
+                FrameArenaBlock* block = FrameArenaBlock::create(std::max(blockSize, size + alignment));
+                block->next = current->next;
+                current->next = block;
+                heapAllocations++;
+            }
+            frameBytes += current->size - current->used;   // The unused tail counts: it is lost for this frame
+            current->used = current->size;
+            current = current->next;
+            current->used = 0;
+            overflowBlocks++;
+        }
+    }
+
+    template <typename T>
+    T* allocateArray (std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // End of frame: everything allocated since the last reset is released
+    void reset ()
+    {
+        if (FRAME_ARENA_DEBUG)
+            for (FrameArenaBlock* block = first; block; block = block->next)
+                std::memset(block->data(), FRAME_ARENA_POISON, block->used);
+
+        // Merge an overflow chain into one block sized for the high-water mark
+        if (first && first->next) {
+            std::size_t size = blockSize;
+            while (size < highWater + alignof(std::max_align_t)) size *= 2;
+            release();
+            first = FrameArenaBlock::create(size);
+            heapAllocations++;
+            blockSize = size;
+        }
+
+        current = first;
+        if (current) current->used = 0;
+        frameBytes = 0;
+        overflowBlocks = 0;
+    }
+
+    void release ()
+    {
+        while (first) {
+            FrameArenaBlock* next = first->next;
+            std::free(first);
+            first = next;
+        }
+        current = nullptr;
+    }
+
+    // Destructor
+    ~FrameArena ()
+    {
+        release();
+    }
+};
+
+// Arena Allocator: STL adapter (std::vector<T, ArenaAllocator<T>>), deallocate is a no-op
+// Containers using it must not outlive the arena's frame
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    FrameArena* arena;
+
+    ArenaAllocator (FrameArena& frameArena) : arena(&frameArena) {}
+    template <typename U> ArenaAllocator (const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate (std::size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate (T*, std::size_t) {}
+
+    template <typename U> bool operator== (const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U> bool operator!= (const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// Frame Arenas: one arena per job system thread, index = JobSystem::threadIndex()
+// [0] belongs to the update thread, [1..n] to the workers; other threads (render thread, loaders) own a FrameArena
+// of their own. reset() runs on the update thread at the end of the frame, once the frame's jobs are done.
+struct FrameArenas {
+
+    std::vector<FrameArena*> arenas;
+
+    // Constructor
+    FrameArenas (unsigned int threadCount = jobSystem().threadCount(), std::size_t blockSize = FRAME_ARENA_BLOCK_SIZE)
+    {
+        for (unsigned int t = 0; t < threadCount; t++) arenas.push_back(new FrameArena(blockSize));
+    }
+
+    // Arena of the calling thread
+    FrameArena& local ()
+    {
+        return *arenas[JobSystem::threadIndex()];
+    }
+
+    void reset ()
+    {
+        for (FrameArena* arena : arenas) arena->reset();
+    }
+
+    // Report: largest frame of any thread, sum of the high-water marks, heap allocations since start
+    std::size_t highWater () const
+    {
+        std::size_t maximum = 0;
+        for (FrameArena* arena : arenas) maximum = std::max(maximum, arena->highWater);
+        return maximum;
+    }
+
+    std::size_t totalHighWater () const
+    {
+        std::size_t total = 0;
+        for (FrameArena* arena : arenas) total += arena->highWater;
+        return total;
+    }
+
+    unsigned long long heapAllocations () const
+    {
+        unsigned long long total = 0;
+        for (FrameArena* arena : arenas) total += arena->heapAllocations;
+        return total;
+    }
+
+    // Destructor
+    ~FrameArenas ()
+    {
+        for (FrameArena* arena : arenas) delete arena;
+    }
+};
+
+// Shared frame arenas (same threads as jobSystem())
+inline FrameArenas& frameArenas ()
+{
+    static FrameArenas arenas;
+    return arenas;
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <GLFW/glfw3.h>          // GLFW for swap interval / extension queries
+
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+// Frame Clock
+// Fixed step simulation (accumulator) + interpolation alpha for rendering, swap interval modes,
+// a sleep + spin frame limiter and frame time statistics.
+
+typedef std::chrono::steady_clock FrameTimer;
+
+// Swap Mode
+enum SwapMode {
+    SWAP_VSYNC,      // Wait for vertical blank (interval 1)
+    SWAP_ADAPTIVE,   // Vsync, but swap immediately (tear) when the frame is late (interval -1, *_swap_control_tear)
+    SWAP_UNCAPPED,   // No wait (interval 0), no pacing: as many frames as the GPU can render
+    SWAP_LIMITED,    // No wait (interval 0), paced by FrameLimiter at a target rate
+    SWAP_MODE_COUNT
+};
+
+const char* const SWAP_MODE_NAMES[SWAP_MODE_COUNT] = {"vsync", "adaptive", "uncapped", "limited"};
+
+// Mode from its name (command lines), false when unknown
+inline bool swapModeFromName (const char* name, SwapMode& mode)
+{
+    for (int m = 0; m < SWAP_MODE_COUNT; m++)
+        if (std::strcmp(name, SWAP_MODE_NAMES[m]) == 0) {
+            mode = (SwapMode)m;
+            return true;
+        }
+    return false;
+}
+
+// Swap interval for a mode, needs the context current on the calling thread
+// Adaptive falls back to vsync when the driver has no swap control tear extension
+inline int swapModeInterval (SwapMode mode)
+{
+    switch (mode) {
+        case SWAP_ADAPTIVE:
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+                return -1;
+            return 1;
+        case SWAP_UNCAPPED:
+        case SWAP_LIMITED:  return 0;
+        default:            return 1;
+    }
+}
+
+// Frame Clock: one tick() per frame, then while (step()) simulate(fixedStep)
+struct FrameClock {
+
+    double fixedStep;        // Simulation step (seconds)
+    double maxFrameTime;     // Longer frames are clamped (breakpoints, window drags): no spiral of death
+    double frameTime;        // Last frame (seconds, unclamped)
+    double accumulator;      // Unsimulated time
+    double time;             // Simulated time
+    unsigned long long frame;
+    FrameTimer::time_point previous;
+
+    // Constructor
+    FrameClock (double step = 1.0 / 120.0, double maxFrame = 0.25)
+        : fixedStep(step), maxFrameTime(maxFrame), frameTime(0.0), accumulator(0.0), time(0.0), frame(0), previous(FrameTimer::now()) {}
+
+    // Start of a frame: measure the elapsed time and feed the accumulator, returns the frame time
+    double tick ()
+    {
+        FrameTimer::time_point now = FrameTimer::now();
+        frameTime = std::chrono::duration<double>(now - previous).count();
+        previous = now;
+        accumulator += std::min(frameTime, maxFrameTime);
+        frame++;
+        return frameTime;
+    }
+
+    // Consume one fixed step, false once the accumulator holds less than a step
+    bool step ()
+    {
+        if (accumulator < fixedStep) return false;
+        accumulator -= fixedStep;
+        time += fixedStep;
+        return true;
+    }
+
+    // Render interpolation between the previous and current simulation states [0, 1)
+    float alpha () const
+    {
+        return (float)(accumulator / fixedStep);
+    }
+};
+
+// Frame Limiter: sleeps for the bulk of the wait, spins for the rest
+// The sleep overshoot is measured (mean + standard deviation, Welford) so the spin phase only covers the OS timer jitter
+struct FrameLimiter {
+
+    double targetFrameTime;      // Seconds (0 = unlimited)
+    double sleepEstimate;        // Expected cost of a 1 ms sleep (seconds)
+    double sleepMean, sleepM2;
+    unsigned long long sleepCount;
+    FrameTimer::time_point next;
+
+    // Constructor
+    FrameLimiter (double framesPerSecond = 0.0)
+        : targetFrameTime(framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0),
+          sleepEstimate(0.002), sleepMean(0.0), sleepM2(0.0), sleepCount(0), next(FrameTimer::now()) {}
+
+    void setTarget (double framesPerSecond)
+    {
+        targetFrameTime = framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0;
+        next = FrameTimer::now();
+    }
+
+    // End of a frame: wait until the next frame is due
+    void wait ()
+    {
+        if (targetFrameTime <= 0.0) return;
+
+        next += std::chrono::duration_cast<FrameTimer::duration>(std::chrono::duration<double>(targetFrameTime));
+        FrameTimer::time_point now = FrameTimer::now();
+        if (next < now) {
+            next = now;   // Late: do not try to catch up with a burst of short frames
+            return;
+        }
+
+        // Sleep while there is more left than a sleep may take
+        while (std::chrono::duration<double>(next - now).count() > sleepEstimate) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            FrameTimer::time_point woke = FrameTimer::now();
+            double observed = std::chrono::duration<double>(woke - now).count();
+            now = woke;
+
+            sleepCount++;
+            double delta = observed - sleepMean;
+            sleepMean += delta / (double)sleepCount;
+            sleepM2 += delta * (observed - sleepMean);
+            if (sleepCount > 1) sleepEstimate = sleepMean + std::sqrt(sleepM2 / (double)(sleepCount - 1));
+
+            // Keep adapting to the current timer resolution
+            if (sleepCount > 1000) { sleepCount = 1; sleepM2 = 0.0; }
+        }
+
+        // Spin the remainder
+        while (FrameTimer::now() < next) std::this_thread::yield();
+    }
+};
+
+// Frame Statistics: rolling window of frame times
+struct FrameStats {
+
+    std::vector<double> frameTimes;   // Seconds, ring buffer
+    std::vector<double> sorted;
+    unsigned int next;
+    unsigned int count;
+    unsigned long long stutters;      // Frames over stutterFactor x the median
+    double stutterFactor;
+
+    // Constructor
+    FrameStats (unsigned int window = 512, double stutterThreshold = 2.0)
+        : frameTimes(window, 0.0), next(0), count(0), stutters(0), stutterFactor(stutterThreshold) { sorted.reserve(window); }
+
+    void add (double frameTime)
+    {
+        // Compare against the median of the frames before this one
+        if (count >= 16 && frameTime > stutterFactor * percentile(0.5)) stutters++;
+        frameTimes[next] = frameTime;
+        next = (next + 1) % (unsigned int)frameTimes.size();
+        count = std::min(count + 1, (unsigned int)frameTimes.size());
+    }
+
+    // Percentile (0..1) of the window, seconds
+    double percentile (double p)
+    {
+        if (count == 0) return 0.0;
+        sorted.assign(frameTimes.begin(), frameTimes.begin() + count);
+        size_t index = std::min(sorted.size() - 1, (size_t)(p * (double)(sorted.size() - 1) + 0.5));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    double average () const
+    {
+        double sum = 0.0;
+        for (unsigned int i = 0; i < count; i++) sum += frameTimes[i];
+        return count ? sum / (double)count : 0.0;
+    }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+// Frustum
+// 6 planes (a, b, c, d) with inward facing normals: a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+struct Frustum {
+
+    enum { Left, Right, Bottom, Top, Near, Far };
+
+    glm::vec4 planes[6];
+
+    // Extract the planes from a view-projection matrix (Gribb-Hartmann, OpenGL clip space z = -w..w)
+    static Frustum fromMatrix (const glm::mat4& viewProjection)
+    {
+        // glm is column major: row i = (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::vec4 row0 = glm::row(viewProjection, 0);
+        glm::vec4 row1 = glm::row(viewProjection, 1);
+        glm::vec4 row2 = glm::row(viewProjection, 2);
+        glm::vec4 row3 = glm::row(viewProjection, 3);
+
+        Frustum frustum;
+        frustum.planes[Left]   = row3 + row0;
+        frustum.planes[Right]  = row3 - row0;
+        frustum.planes[Bottom] = row3 + row1;
+        frustum.planes[Top]    = row3 - row1;
+        frustum.planes[Near]   = row3 + row2;
+        frustum.planes[Far]    = row3 - row2;
+
+        // Normalize so that plane distances are in world units (needed for sphere radius tests)
+        for (glm::vec4& plane : frustum.planes)
+            plane /= glm::length(glm::vec3(plane));
+
+        return frustum;
+    }
+
+    // Sphere: outside if it is completely behind any plane
+    bool sphereVisible (const glm::vec3& center, float radius) const
+    {
+        for (const glm::vec4& plane : planes)
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        return true;
+    }
+
+    // AABB: test the corner furthest along the plane normal (positive vertex)
+    bool aabbVisible (const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        for (const glm::vec4& plane : planes) {
+            glm::vec3 positive(plane.x >= 0.0f ? boxMax.x : boxMin.x,
+                               plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                               plane.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+#endif
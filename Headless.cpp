@@ -0,0 +1,331 @@
+#include <GL/glew.h>                  // GLEW for OpenGL functions
+#include <GLFW/glfw3.h>               // GLFW for the hidden window context (without EGL)
+#include <glm/glm.hpp>                // Include all GLM core / GLSL features for math
+#include <glm/ext.hpp>                // Include all GLM extensions
+
+#if defined(HEADLESS_EGL)
+    #include <EGL/egl.h>              // Context without a display server (Mesa surfaceless, GPU drivers)
+    #include <EGL/eglext.h>
+#endif
+
+#include "Shader.h"
+#include "Texture.h"
+#include "Camera.h"
+#include "Residency.h"
+#include "Material.h"
+#include "Sampler.h"
+#include "RenderTarget.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// Headless Renderer
+// Renders the app's scene (material quad, streamed texture) into an offscreen framebuffer and writes the last
+// frame as a binary PPM: reference images and perf runs on machines without a display. Same pipeline as the app:
+// scene in linear light into the HDR target (--target), tonemapped and sRGB encoded into an RGBA8 framebuffer that is
+// read back. With --reference the frame is compared to a reference PPM: fails (exit code 1) when a channel differs by
+// more than --tolerance, --diff writes the differences (amplified) for a look.
+// Usage: Headless [--width pixels] [--height pixels] [--frames count] [--output image.ppm] [--target rgba16f|r11g11b10f|rgba8]
+//                 [--tonemap clamp|reinhard|aces] [--exposure value] [--reference image.ppm] [--tolerance value] [--diff image.ppm]
+// Context: EGL without a window system when built with HEADLESS_EGL (CMake on Linux), a hidden GLFW window otherwise.
+// Frames go on past --frames until the texture is resident and the material variant compiled (at most
+// HEADLESS_SETTLE_TIMEOUT), so the image does not depend on streaming or compile timing.
+
+const std::chrono::seconds HEADLESS_SETTLE_TIMEOUT(10);   // Longest wait for streaming / compiles past --frames
+
+// Offscreen context (current on this thread), false when none can be created
+struct HeadlessContext {
+#if defined(HEADLESS_EGL)
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+#else
+    GLFWwindow* window = nullptr;
+#endif
+
+    bool create ()
+    {
+#if defined(HEADLESS_EGL)
+        // Surfaceless platform first (no X / Wayland), default display otherwise
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        EGLint major, minor;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+            std::cout << "Failed to initialize EGL" << std::endl;
+            return false;
+        }
+
+        // Core profile (the driver returns its highest compatible version), no surface: rendering goes to the framebuffer
+        const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+                                            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+        context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            std::cout << "Failed to create the EGL context (0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+            return false;
+        }
+#else
+        if (!glfwInit()) {
+            std::cout << "Failed to initialize GLFW" << std::endl;
+            return false;
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(64, 64, "Headless", nullptr, nullptr);
+        if (!window) {
+            std::cout << "Failed to create GLFW window" << std::endl;
+            return false;
+        }
+        glfwMakeContextCurrent(window);
+#endif
+        // GLEW: without a GLX display only the GLX entry points are missing
+        GLenum glewStatus = glewInit();
+        if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY) {
+            std::cout << "Failed to initialize GLEW" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Destructor
+    ~HeadlessContext ()
+    {
+#if defined(HEADLESS_EGL)
+        if (display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+            eglTerminate(display);
+        }
+#else
+        glfwTerminate();
+#endif
+    }
+};
+
+// Write RGBA8 pixels (bottom row first, as read back) as a binary PPM (top row first)
+bool writePPM (const std::string& filePath, const std::vector<unsigned char>& pixels, int width, int height)
+{
+    std::ofstream image(filePath, std::ios::binary);
+    if (!image) return false;
+    image << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<unsigned char> row((size_t)width * 3);
+    for (int y = height - 1; y >= 0; y--) {
+        const unsigned char* source = pixels.data() + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++) std::memcpy(&row[(size_t)x * 3], source + (size_t)x * 4, 3);
+        image.write((const char*)row.data(), (std::streamsize)row.size());
+    }
+    return (bool)image;
+}
+
+// Read a binary PPM (P6, 8 bits) as RGB, top row first
+bool readPPM (const std::string& filePath, std::vector<unsigned char>& pixels, int& width, int& height)
+{
+    std::ifstream image(filePath, std::ios::binary);
+    std::string magic;
+    image >> magic;
+    int values[3];
+    for (int v = 0; v < 3 && image; v++) {
+        image >> std::ws;
+        while (image.peek() == '#') {        // Comment lines between the header fields
+            std::string comment;
+            std::getline(image, comment);
+            image >> std::ws;
+        }
+        image >> values[v];
+    }
+    if (!image || magic != "P6" || values[0] <= 0 || values[1] <= 0 || values[2] != 255) return false;
+    image.get();                             // One whitespace after maxval, then the samples
+    width = values[0];
+    height = values[1];
+    pixels.resize((size_t)width * height * 3);
+    image.read((char*)pixels.data(), (std::streamsize)pixels.size());
+    return (bool)image;
+}
+
+// Frame (RGBA8, bottom row first) vs reference (RGB, top row first): largest and mean channel difference, PSNR and the
+// pixels with a channel over the tolerance. diff: absolute differences x 16 (RGB, top row first)
+struct ImageComparison {
+    int maxDifference = 0;
+    double meanDifference = 0.0;
+    double psnr = INFINITY;                  // dB, infinite for identical images
+    size_t pixelsOver = 0;
+};
+
+ImageComparison compareImages (const std::vector<unsigned char>& frame, const std::vector<unsigned char>& reference, int width, int height,
+                               int tolerance, std::vector<unsigned char>& diff)
+{
+    ImageComparison comparison;
+    diff.assign((size_t)width * height * 3, 0);
+    double squaredSum = 0.0, sum = 0.0;
+    for (int y = 0; y < height; y++) {
+        const unsigned char* frameRow = frame.data() + (size_t)(height - 1 - y) * width * 4;
+        const unsigned char* referenceRow = reference.data() + (size_t)y * width * 3;
+        unsigned char* diffRow = diff.data() + (size_t)y * width * 3;
+        for (int x = 0; x < width; x++) {
+            bool over = false;
+            for (int c = 0; c < 3; c++) {
+                int difference = std::abs((int)frameRow[(size_t)x * 4 + c] - (int)referenceRow[(size_t)x * 3 + c]);
+                comparison.maxDifference = std::max(comparison.maxDifference, difference);
+                sum += difference;
+                squaredSum += (double)difference * difference;
+                over = over || difference > tolerance;
+                diffRow[(size_t)x * 3 + c] = (unsigned char)std::min(difference * 16, 255);
+            }
+            if (over) comparison.pixelsOver++;
+        }
+    }
+    double samples = (double)width * height * 3;
+    comparison.meanDifference = sum / samples;
+    if (squaredSum > 0.0) comparison.psnr = 10.0 * std::log10(255.0 * 255.0 / (squaredSum / samples));
+    return comparison;
+}
+
+int main (int argc, char* argv[])
+{
+    int width = 1280, height = 720;
+    unsigned int frames = 60;
+    std::string outputPath = "headless.ppm", referencePath, diffPath;
+    RenderTargetFormat targetFormat = RENDER_TARGET_RGBA16F;
+    TonemapOperator tonemapSetting = TONEMAP_CLAMP;
+    float exposure = 1.0f;
+    int tolerance = 2;                       // Rounding / driver differences, an 8 bit target is further off in the darks
+    bool validArguments = true;
+    for (int a = 1; a < argc; a++) {
+        if (std::strcmp(argv[a], "--width") == 0 && a + 1 < argc) width = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--height") == 0 && a + 1 < argc) height = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--frames") == 0 && a + 1 < argc) frames = (unsigned int)std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--output") == 0 && a + 1 < argc) outputPath = argv[++a];
+        else if (std::strcmp(argv[a], "--target") == 0 && a + 1 < argc) validArguments &= renderTargetFormat(argv[++a], targetFormat);
+        else if (std::strcmp(argv[a], "--tonemap") == 0 && a + 1 < argc) validArguments &= tonemapOperator(argv[++a], tonemapSetting);
+        else if (std::strcmp(argv[a], "--exposure") == 0 && a + 1 < argc) exposure = (float)std::atof(argv[++a]);
+        else if (std::strcmp(argv[a], "--reference") == 0 && a + 1 < argc) referencePath = argv[++a];
+        else if (std::strcmp(argv[a], "--tolerance") == 0 && a + 1 < argc) tolerance = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--diff") == 0 && a + 1 < argc) diffPath = argv[++a];
+    }
+    if (width <= 0 || height <= 0 || !validArguments) {
+        std::cout << "Usage: Headless [--width pixels] [--height pixels] [--frames count] [--output image.ppm] [--target rgba16f|r11g11b10f|rgba8]\n"
+                     "                [--tonemap clamp|reinhard|aces] [--exposure value] [--reference image.ppm] [--tolerance value] [--diff image.ppm]" << std::endl;
+        return 1;
+    }
+
+    HeadlessContext headless;
+    if (!headless.create()) return 1;
+    std::cout << "Headless: " << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION) << std::endl;
+
+    /* Output Framebuffer (RGBA8, sRGB encoded by the tonemap pass: what the display gets) */
+    unsigned int colorTexture, framebuffer;
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Incomplete headless framebuffer" << std::endl;
+        return 1;
+    }
+
+    /* Scene: the app's quad, material and streamed texture (loose files) */
+    Residency residency;
+    ResidencyLoader textureLoader = textureResidencyLoader();
+    ResidencyID texture = residency.add("./Archive/Images/Img.jpg", RESIDENCY_TEXTURE, &textureLoader);
+    Shader Shader("./shaders/Vertex_Shader/vertex_shader.glsl", "./shaders/Fragment_Shader/fragment_shader.glsl");
+    MaterialLibrary materials(nullptr, "./shaders/Vertex_Shader/material_vertex.glsl", "./shaders/Fragment_Shader/material_fragment.glsl");
+    Material quadMaterial;
+    quadMaterial.name = "Img";
+    quadMaterial.features = MATERIAL_TEXTURED;
+    quadMaterial.sampler = samplerCache().get(samplerAnisotropic(16.0f, GL_CLAMP_TO_EDGE));   // One image, no tiling
+    Camera camera;
+    camera.resize(width, height);
+
+    /* Scene Target (linear HDR) + tonemap into the output framebuffer */
+    RenderTarget sceneTarget;
+    sceneTarget.format = targetFormat;
+    TonemapPass tonemap;
+    tonemap.tonemap = tonemapSetting;
+    tonemap.exposure = exposure;
+    if (!sceneTarget.resize(width, height) || !tonemap.create()) return 1;
+    std::cout << "Scene target: " << RENDER_TARGET_FORMAT_NAMES[targetFormat] << " (" << sceneTarget.bytes() / 1024 << " KB), tonemap: "
+              << TONEMAP_OPERATOR_NAMES[tonemapSetting] << ", exposure " << exposure << std::endl;
+    glm::mat4 model(1.0f);
+
+    /* Frames: same work as the app's render thread, timed */
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned int frame = 0;
+    for (;; frame++) {
+        if (frame >= frames) {
+            bool settled = residency.resident(texture) && materials.ready(quadMaterial.features);
+            if (settled || std::chrono::steady_clock::now() - start > HEADLESS_SETTLE_TIMEOUT) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));   // Waiting on IO / compiles
+        }
+
+        residency.request(texture, frame, 1.0f);
+        residency.update(frame);
+
+        sceneTarget.bind();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        quadMaterial.texture = residency.handle(texture);
+        MaterialVariant& material = quadMaterial.bind(materials);
+        glUniformMatrix4fv(material.uniformLocation("vsViewProjection"), 1, GL_FALSE, glm::value_ptr(camera.viewProjection()));
+        glUniformMatrix4fv(material.uniformLocation("vsModel"), 1, GL_FALSE, glm::value_ptr(model));
+        glBindVertexArray(Shader.VAO);
+        glDrawElements(GL_TRIANGLES, (int)Shader.indices.size(), GL_UNSIGNED_INT, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, width, height);
+        tonemap.draw(sceneTarget);
+    }
+    glFinish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << frame << " frames in " << seconds * 1000.0 << " ms (" << seconds * 1000.0 / (frame ? frame : 1) << " ms per frame)" << std::endl;
+
+    /* Read back the last frame */
+    std::vector<unsigned char> pixels((size_t)width * height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    bool written = writePPM(outputPath, pixels, width, height);
+    std::cout << (written ? "Wrote " : "Failed to write ") << outputPath << std::endl;
+
+    /* Reference comparison */
+    bool matches = true;
+    if (!referencePath.empty()) {
+        std::vector<unsigned char> reference, diff;
+        int referenceWidth, referenceHeight;
+        if (!readPPM(referencePath, reference, referenceWidth, referenceHeight)) {
+            std::cout << "Failed to read the reference: " << referencePath << std::endl;
+            matches = false;
+        } else if (referenceWidth != width || referenceHeight != height) {
+            std::cout << "Reference size " << referenceWidth << "x" << referenceHeight << " != frame size " << width << "x" << height << std::endl;
+            matches = false;
+        } else {
+            ImageComparison comparison = compareImages(pixels, reference, width, height, tolerance, diff);
+            matches = comparison.pixelsOver == 0;
+            std::cout << "Reference " << referencePath << ": max difference " << comparison.maxDifference << ", mean " << comparison.meanDifference
+                      << ", PSNR " << comparison.psnr << " dB, " << comparison.pixelsOver << " pixels over " << tolerance
+                      << (matches ? " (match)" : " (MISMATCH)") << std::endl;
+            if (!diffPath.empty()) {
+                std::ofstream diffImage(diffPath, std::ios::binary);
+                diffImage << "P6\n" << width << " " << height << "\n255\n";
+                diffImage.write((const char*)diff.data(), (std::streamsize)diff.size());
+                std::cout << (diffImage ? "Wrote " : "Failed to write ") << diffPath << std::endl;
+            }
+        }
+    }
+
+    residency.clear();
+    materials.release();
+    sceneTarget.release();
+    tonemap.release();
+    samplerCache().release();
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTexture);
+    return (written && matches) ? 0 : 1;
+}
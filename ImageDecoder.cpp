@@ -0,0 +1,635 @@
+// Image Decoder: the one translation unit with the decoder implementations (ImageDecoder.h)
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+
+// stb_image: SIMD on every x86 target (32-bit MinGW only aligns the stack with -mstackrealign, Build.cmd sets it)
+// and on ARM (NEON is opt-in)
+#define STBI_MINGW_ENABLE_SSE2
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define STBI_NEON
+#endif
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image/stb_image.h>
+
+#if defined(IMAGE_DECODER_LIBJPEG)
+    #include <cstdio>                 // jpeglib.h needs FILE
+    #include <csetjmp>
+    #include <jpeglib.h>
+#endif
+
+#include <fstream>
+#include <vector>
+#include <iterator>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+static thread_local const char* imageDecodeFailure = "";
+static thread_local unsigned int imageDecodeStripeCount = 1;
+
+DecodedImage& DecodedImage::operator= (DecodedImage&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        pixels = other.pixels;
+        width = other.width;
+        height = other.height;
+        channels = other.channels;
+        other.pixels = nullptr;
+        other.width = other.height = other.channels = 0;
+    }
+    return *this;
+}
+
+void DecodedImage::release ()
+{
+    std::free(pixels);    // stb_image and the libjpeg / PNG stripe paths all allocate with malloc
+    pixels = nullptr;
+}
+
+static bool isJPEG (const unsigned char* encodedData, size_t encodedSize)
+{
+    return encodedSize >= 3 && encodedData[0] == 0xFF && encodedData[1] == 0xD8 && encodedData[2] == 0xFF;
+}
+
+static bool isPNG (const unsigned char* encodedData, size_t encodedSize)
+{
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    return encodedSize >= 8 && std::memcmp(encodedData, signature, 8) == 0;
+}
+
+static unsigned int bigEndian16 (const unsigned char* bytes) { return (bytes[0] << 8) | bytes[1]; }
+static unsigned int bigEndian32 (const unsigned char* bytes) { return ((unsigned int)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3]; }
+
+// Stripes of a rows long image for the job system threads (several per thread: stripes don't cost the same)
+static unsigned int stripeTarget (unsigned int rows, unsigned int minimumRows)
+{
+    unsigned int threads = jobSystem().threadCount();
+    return std::max(1u, std::min(threads * 2, rows / std::max(1u, minimumRows)));
+}
+
+// Result of a native (non stb_image) decode: NOT_HANDLED falls back to stb_image
+enum StripeResult {
+    STRIPE_DECODED,
+    STRIPE_FAILED,
+    STRIPE_NOT_HANDLED
+};
+
+#if defined(IMAGE_DECODER_LIBJPEG)
+// libjpeg reports fatal errors through error_exit: back to the decode call instead of exit()
+struct JPEGErrorManager {
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+};
+
+static void jpegErrorExit (j_common_ptr decoder)
+{
+    std::longjmp(reinterpret_cast<JPEGErrorManager*>(decoder->err)->jump, 1);
+}
+
+// JPEG header as libjpeg reads it (grey and YCbCr only: CMYK is left to stb_image)
+struct JPEGHeader {
+    int width = 0, height = 0, components = 0;
+    int mcuWidth = 0, mcuHeight = 0;           // Pixels
+    unsigned int restartInterval = 0;          // MCUs, 0: no restart markers
+    bool progressive = false;
+};
+
+static bool readJPEGHeader (const unsigned char* encodedData, size_t encodedSize, JPEGHeader& header)
+{
+    jpeg_decompress_struct decoder;
+    JPEGErrorManager error;
+    decoder.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&decoder);
+        imageDecodeFailure = "corrupt JPEG (libjpeg)";
+        return false;
+    }
+
+    jpeg_create_decompress(&decoder);
+    jpeg_mem_src(&decoder, encodedData, (unsigned long)encodedSize);
+    jpeg_read_header(&decoder, TRUE);
+    header.width = (int)decoder.image_width;
+    header.height = (int)decoder.image_height;
+    header.components = decoder.num_components;
+    // Single component scans: one 8x8 block per MCU
+    header.mcuWidth = (decoder.num_components == 1) ? DCTSIZE : decoder.max_h_samp_factor * DCTSIZE;
+    header.mcuHeight = (decoder.num_components == 1) ? DCTSIZE : decoder.max_v_samp_factor * DCTSIZE;
+    header.restartInterval = decoder.restart_interval;
+    header.progressive = decoder.progressive_mode;
+    jpeg_destroy_decompress(&decoder);
+
+    if (header.components != 1 && header.components != 3) {
+        imageDecodeFailure = "unsupported JPEG color space (libjpeg)";
+        return false;
+    }
+    return true;
+}
+
+// Rows [firstRow, lastRow) of a JPEG stream (firstRow lands at destination): the rows above are skipped, only
+// entropy decoded (libjpeg-turbo jpeg_skip_scanlines), the decode stops after lastRow
+static bool decodeJPEGRows (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch,
+                            int channels, int firstRow, int lastRow)
+{
+    jpeg_decompress_struct decoder;
+    JPEGErrorManager error;
+    decoder.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&decoder);
+        imageDecodeFailure = "corrupt JPEG (libjpeg)";
+        return false;
+    }
+
+    jpeg_create_decompress(&decoder);
+    jpeg_mem_src(&decoder, encodedData, (unsigned long)encodedSize);
+    jpeg_read_header(&decoder, TRUE);
+    decoder.out_color_space = (channels == 1) ? JCS_GRAYSCALE : (channels == 3) ? JCS_RGB : JCS_EXT_RGBA;
+    decoder.dct_method = JDCT_ISLOW;    // Same accuracy as stb_image
+
+    jpeg_start_decompress(&decoder);
+    if (firstRow > 0) jpeg_skip_scanlines(&decoder, (JDIMENSION)firstRow);
+    while ((int)decoder.output_scanline < lastRow) {
+        JSAMPROW row = destination + rowPitch * (decoder.output_scanline - firstRow);
+        jpeg_read_scanlines(&decoder, &row, 1);
+    }
+    jpeg_destroy_decompress(&decoder);   // Rows past lastRow are not needed: no jpeg_finish_decompress
+    return true;
+}
+
+// Single scan JPEG layout: where the SOF height is, where the entropy coded data starts / ends, and the restart markers
+struct JPEGScan {
+    size_t heightOffset = 0;
+    size_t entropyBegin = 0;
+    size_t entropyEnd = 0;
+    std::vector<size_t> restartMarkers;        // Offsets of the RSTn markers, in stream order
+};
+
+static bool readJPEGScan (const unsigned char* encodedData, size_t encodedSize, JPEGScan& scan)
+{
+    // Marker segments up to the (only) start of scan
+    size_t position = 2;
+    while (scan.entropyBegin == 0) {
+        while (position + 1 < encodedSize && encodedData[position] == 0xFF && encodedData[position + 1] == 0xFF) position++;
+        if (position + 4 > encodedSize || encodedData[position] != 0xFF) return false;
+        unsigned char marker = encodedData[position + 1];
+        size_t length = bigEndian16(encodedData + position + 2);
+        if (position + 2 + length > encodedSize) return false;
+        bool startOfFrame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (startOfFrame) scan.heightOffset = position + 5;
+        if (marker == 0xDA) scan.entropyBegin = position + 2 + length;
+        position += 2 + length;
+    }
+    if (scan.heightOffset == 0) return false;
+
+    // Entropy coded data: stuffed 0xFF00 bytes and restart markers until EOI (another scan: not a single scan JPEG)
+    position = scan.entropyBegin;
+    while (true) {
+        const void* next = std::memchr(encodedData + position, 0xFF, encodedSize - position);
+        if (!next) return false;
+        position = (const unsigned char*)next - encodedData;
+        if (position + 1 >= encodedSize) return false;
+        unsigned char marker = encodedData[position + 1];
+        if (marker == 0x00) { position += 2; continue; }
+        if (marker == 0xFF) { position += 1; continue; }
+        if (marker >= 0xD0 && marker <= 0xD7) { scan.restartMarkers.push_back(position); position += 2; continue; }
+        if (marker != 0xD9) return false;
+        scan.entropyEnd = position;
+        return true;
+    }
+}
+
+// Restart interval stripes: every stripe starts at a restart marker on an MCU row boundary (the DC predictions are
+// reset there), so it decodes as a JPEG of its own: the headers with the stripe height, its entropy coded data with
+// the markers renumbered from RST0, EOI. One MCU row above and below is decoded too (upsampling context), not kept.
+static StripeResult decodeJPEGRestartStripes (const unsigned char* encodedData, size_t encodedSize, const JPEGHeader& header,
+                                              unsigned char* destination, size_t rowPitch, int channels)
+{
+    JPEGScan scan;
+    if (!readJPEGScan(encodedData, encodedSize, scan)) return STRIPE_NOT_HANDLED;
+
+    unsigned int mcusPerRow = (header.width + header.mcuWidth - 1) / header.mcuWidth;
+    unsigned int mcuRows = (header.height + header.mcuHeight - 1) / header.mcuHeight;
+    unsigned int interval = header.restartInterval;
+    unsigned long long intervals = ((unsigned long long)mcusPerRow * mcuRows + interval - 1) / interval;
+    if (scan.restartMarkers.size() + 1 < intervals) return STRIPE_NOT_HANDLED;
+
+    // MCU rows starting a restart interval, stripes on the ones closest to an even split
+    std::vector<unsigned int> alignedRows;
+    for (unsigned int row = 0; row < mcuRows; row++)
+        if ((unsigned long long)row * mcusPerRow % interval == 0) alignedRows.push_back(row);
+    unsigned int stripes = std::min(stripeTarget(mcuRows, 4), (unsigned int)alignedRows.size());
+    std::vector<unsigned int> stripeRows;      // Index into alignedRows of each stripe start
+    for (unsigned int s = 0; s < stripes; s++) {
+        unsigned int target = (unsigned int)((unsigned long long)s * mcuRows / stripes);
+        unsigned int aligned = (unsigned int)(std::lower_bound(alignedRows.begin(), alignedRows.end(), target) - alignedRows.begin());
+        if (aligned < alignedRows.size() && (stripeRows.empty() || aligned > stripeRows.back())) stripeRows.push_back(aligned);
+    }
+    if (stripeRows.size() < 2) return STRIPE_NOT_HANDLED;
+
+    // Entropy data of an aligned MCU row: after the marker ending the previous interval
+    auto rowOffset = [&](unsigned int row) {
+        size_t restart = (size_t)((unsigned long long)row * mcusPerRow / interval);
+        return (restart == 0) ? scan.entropyBegin : scan.restartMarkers[restart - 1] + 2;
+    };
+
+    std::atomic<const char*> failure{nullptr};
+    jobSystem().parallelFor((unsigned int)stripeRows.size(), 1, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int s = begin; s < end; s++) {
+            unsigned int rowBegin = alignedRows[stripeRows[s]];
+            unsigned int rowEnd = (s + 1 < stripeRows.size()) ? alignedRows[stripeRows[s + 1]] : mcuRows;
+            unsigned int decodeBegin = (stripeRows[s] == 0) ? 0 : alignedRows[stripeRows[s] - 1];
+            unsigned int decodeEnd = std::min(rowEnd + 1, mcuRows);
+            auto after = std::lower_bound(alignedRows.begin(), alignedRows.end(), decodeEnd);
+            size_t dataBegin = rowOffset(decodeBegin);
+            size_t dataEnd = (after == alignedRows.end()) ? scan.entropyEnd : rowOffset(*after) - 2;
+            int stripeHeight = std::min(header.height, (int)(decodeEnd * header.mcuHeight)) - (int)(decodeBegin * header.mcuHeight);
+
+            std::vector<unsigned char> stripe;
+            stripe.reserve(scan.entropyBegin + (dataEnd - dataBegin) + 2);
+            stripe.insert(stripe.end(), encodedData, encodedData + scan.entropyBegin);
+            stripe[scan.heightOffset] = (unsigned char)(stripeHeight >> 8);
+            stripe[scan.heightOffset + 1] = (unsigned char)(stripeHeight & 0xFF);
+            stripe.insert(stripe.end(), encodedData + dataBegin, encodedData + dataEnd);
+            size_t firstRestart = (size_t)((unsigned long long)decodeBegin * mcusPerRow / interval);
+            for (size_t marker = firstRestart; marker < scan.restartMarkers.size() && scan.restartMarkers[marker] < dataEnd; marker++)
+                stripe[scan.entropyBegin + (scan.restartMarkers[marker] - dataBegin) + 1] = (unsigned char)(0xD0 + ((marker - firstRestart) & 7));
+            stripe.push_back(0xFF);
+            stripe.push_back(0xD9);
+
+            int firstRow = (int)((rowBegin - decodeBegin) * header.mcuHeight);
+            int lastRow = std::min(header.height, (int)(rowEnd * header.mcuHeight)) - (int)(decodeBegin * header.mcuHeight);
+            if (!decodeJPEGRows(stripe.data(), stripe.size(), destination + rowPitch * rowBegin * header.mcuHeight, rowPitch, channels, firstRow, lastRow)) {
+                failure.store(imageDecodeFailure);
+            }
+        }
+    });
+    imageDecodeStripeCount = (unsigned int)stripeRows.size();
+    if (failure.load()) {
+        imageDecodeFailure = failure.load();
+        return STRIPE_FAILED;
+    }
+    return STRIPE_DECODED;
+}
+
+// libjpeg-turbo decode (its own SIMD): grey, RGB or RGBA out. Large baseline images are split in MCU row stripes,
+// on restart markers when there are some, else every stripe skips the rows above it (entropy decode only, no IDCT)
+static StripeResult decodeJPEG (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch,
+                                int channels, bool parallel)
+{
+    JPEGHeader header;
+    if (channels == 2 || !readJPEGHeader(encodedData, encodedSize, header)) return STRIPE_NOT_HANDLED;
+#if !defined(JCS_EXTENSIONS)
+    if (channels == 4) return STRIPE_NOT_HANDLED;
+#endif
+
+    bool split = parallel && !header.progressive && (long long)header.width * header.height >= IMAGE_PARALLEL_PIXELS && jobSystem().threadCount() > 1;
+    if (split && header.restartInterval > 0) {
+        StripeResult result = decodeJPEGRestartStripes(encodedData, encodedSize, header, destination, rowPitch, channels);
+        if (result != STRIPE_NOT_HANDLED) return result;
+    }
+
+    unsigned int mcuRows = (header.height + header.mcuHeight - 1) / header.mcuHeight;
+    unsigned int stripes = split ? stripeTarget(mcuRows, 4) : 1;
+    std::atomic<const char*> failure{nullptr};
+    jobSystem().parallelFor(stripes, 1, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int s = begin; s < end; s++) {
+            int firstRow = (int)((unsigned long long)s * mcuRows / stripes) * header.mcuHeight;
+            int lastRow = std::min(header.height, (int)((unsigned long long)(s + 1) * mcuRows / stripes) * header.mcuHeight);
+            if (!decodeJPEGRows(encodedData, encodedSize, destination + rowPitch * firstRow, rowPitch, channels, firstRow, lastRow)) {
+                failure.store(imageDecodeFailure);
+            }
+        }
+    });
+    imageDecodeStripeCount = stripes;
+    if (failure.load()) {
+        imageDecodeFailure = failure.load();
+        return STRIPE_FAILED;
+    }
+    return STRIPE_DECODED;
+}
+#endif
+
+// PNG row unfiltering (filter bytes 0-4): filtered -> row (the same memory for in place unfiltering), previous is the
+// unfiltered row above (zeros above the first row). The pixel size is a template constant and the left / upper left
+// pixels are carried in registers, Paeth in the branch free form of stb_image: the serial dependency along the row is
+// what bounds the single threaded speed
+template <unsigned int PixelSize, int Filter>
+static void unfilterPNGPixels (const unsigned char* filtered, unsigned char* row, const unsigned char* previous, size_t rowSize)
+{
+    int left[PixelSize] = {}, upLeft[PixelSize] = {};
+    for (size_t i = 0; i < rowSize; i += PixelSize)
+        for (unsigned int c = 0; c < PixelSize; c++) {
+            int a = left[c], b = previous[i + c], d = upLeft[c], predictor;
+            if (Filter == 1) {
+                predictor = a;
+            } else if (Filter == 3) {
+                predictor = (a + b) >> 1;
+            } else {
+                int threshold = d * 3 - (a + b), low = std::min(a, b), high = std::max(a, b);
+                predictor = (threshold <= low) ? high : (high <= threshold) ? low : d;
+            }
+            unsigned char value = (unsigned char)(filtered[i + c] + predictor);
+            row[i + c] = value;
+            left[c] = value;
+            upLeft[c] = b;
+        }
+}
+
+template <unsigned int PixelSize>
+static bool unfilterPNGRow (const unsigned char* filtered, unsigned char* row, const unsigned char* previous, size_t rowSize, unsigned char filter)
+{
+    switch (filter) {
+        case 0: if (row != filtered) std::memcpy(row, filtered, rowSize); break;
+        case 1: unfilterPNGPixels<PixelSize, 1>(filtered, row, previous, rowSize); break;
+        case 2: for (size_t i = 0; i < rowSize; i++) row[i] = (unsigned char)(filtered[i] + previous[i]); break;
+        case 3: unfilterPNGPixels<PixelSize, 3>(filtered, row, previous, rowSize); break;
+        case 4: unfilterPNGPixels<PixelSize, 4>(filtered, row, previous, rowSize); break;
+        default: return false;
+    }
+    return true;
+}
+
+static bool unfilterPNGRow (const unsigned char* filtered, unsigned char* row, const unsigned char* previous, size_t rowSize,
+                            unsigned int pixelSize, unsigned char filter)
+{
+    switch (pixelSize) {
+        case 1:  return unfilterPNGRow<1>(filtered, row, previous, rowSize, filter);
+        case 2:  return unfilterPNGRow<2>(filtered, row, previous, rowSize, filter);
+        case 3:  return unfilterPNGRow<3>(filtered, row, previous, rowSize, filter);
+        case 4:  return unfilterPNGRow<4>(filtered, row, previous, rowSize, filter);
+        case 6:  return unfilterPNGRow<6>(filtered, row, previous, rowSize, filter);
+        default: return unfilterPNGRow<8>(filtered, row, previous, rowSize, filter);   // 16 bit RGBA (sizes: 1, 2, 3, 4, 6, 8)
+    }
+}
+
+// Unfiltered PNG row -> 8 bit destination row (16 bit: high byte), channel conversion as stb_image does it
+static void convertPNGRow (const unsigned char* row, unsigned char* destination, int width, int components, int sampleSize, int channels)
+{
+    for (int x = 0; x < width; x++) {
+        const unsigned char* pixel = row + (size_t)x * components * sampleSize;
+        unsigned char r = pixel[0];
+        unsigned char g = (components >= 3) ? pixel[sampleSize] : r;
+        unsigned char b = (components >= 3) ? pixel[2 * sampleSize] : r;
+        unsigned char a = (components == 2 || components == 4) ? pixel[(components - 1) * sampleSize] : 255;
+        unsigned char* out = destination + (size_t)x * channels;
+        unsigned char grey = r;
+        if (components >= 3 && sampleSize == 2) {           // stb_image: luminance of the 16 bit values, then to 8 bit
+            unsigned int r16 = bigEndian16(pixel), g16 = bigEndian16(pixel + 2), b16 = bigEndian16(pixel + 4);
+            grey = (unsigned char)(((r16 * 77 + g16 * 150 + b16 * 29) >> 8) >> 8);
+        } else if (components >= 3) grey = (unsigned char)((r * 77 + g * 150 + b * 29) >> 8);
+        switch (channels) {
+            case 1: out[0] = grey; break;
+            case 2: out[0] = grey; out[1] = a; break;
+            case 3: out[0] = r; out[1] = g; out[2] = b; break;
+            default: out[0] = r; out[1] = g; out[2] = b; out[3] = a; break;
+        }
+    }
+}
+
+// Large PNG (8 / 16 bit grey, grey + alpha, RGB, RGBA, not interlaced): one inflate into a buffer, then stripes
+// unfiltered and converted in parallel. A stripe starts at a None / Sub filtered row (no dependency on the row above),
+// so the stripes depend on the encoder: one stripe (serial unfilter) when every row is Up / Average / Paeth. No work
+// is added over stb_image in that case: a single IDAT chunk is inflated from the file data (several are joined, as
+// stb_image does), and 8 bit rows already in the output format are copied to the destination with one memcpy. Rows are
+// unfiltered in place in the inflate buffer: the destination (a write only mapped pixel unpack buffer) is never read.
+// Palettes, low bit depths, interlacing and transparency chunks are left to stb_image.
+static StripeResult decodePNG (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch, int channels)
+{
+    int width = 0, height = 0, depth = 0, colorType = -1, interlace = 0;
+    const unsigned char* idat = nullptr;
+    size_t idatSize = 0;
+    std::vector<unsigned char> joined;       // Several IDAT chunks, joined
+    size_t position = 8;
+    while (position + 12 <= encodedSize) {
+        size_t length = bigEndian32(encodedData + position);
+        const unsigned char* type = encodedData + position + 4;
+        const unsigned char* data = type + 4;
+        if (position + 12 + length > encodedSize) return STRIPE_NOT_HANDLED;
+        if (std::memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = (int)bigEndian32(data);
+            height = (int)bigEndian32(data + 4);
+            depth = data[8];
+            colorType = data[9];
+            interlace = data[12];
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            if (!idat) {
+                idat = data;
+                idatSize = length;
+            } else {
+                if (joined.empty()) joined.assign(idat, idat + idatSize);
+                joined.insert(joined.end(), data, data + length);
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0 || std::memcmp(type, "CgBI", 4) == 0) {
+            return STRIPE_NOT_HANDLED;
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        position += 12 + length;
+    }
+    const int componentCounts[7] = {1, 0, 3, 0, 2, 0, 4};
+    if (colorType < 0 || colorType > 6 || componentCounts[colorType] == 0 || (depth != 8 && depth != 16) || interlace != 0 ||
+        width <= 0 || height <= 0 || !idat) return STRIPE_NOT_HANDLED;
+    const unsigned char* compressed = joined.empty() ? idat : joined.data();
+    size_t compressedSize = joined.empty() ? idatSize : joined.size();
+
+    int components = componentCounts[colorType];
+    int sampleSize = depth / 8;
+    unsigned int pixelSize = components * sampleSize;
+    size_t rowSize = (size_t)width * pixelSize;
+    size_t filteredSize = (rowSize + 1) * height;
+    if (filteredSize > 0x7FFFFFFF || compressedSize > 0x7FFFFFFF) return STRIPE_NOT_HANDLED;
+    bool direct = components == channels && sampleSize == 1;    // Copied to the destination, no conversion
+
+    // Inflate (serial): rows of a filter byte + rowSize bytes
+    unsigned char* filtered = (unsigned char*)std::malloc(filteredSize);
+    if (!filtered) {
+        imageDecodeFailure = "out of memory";
+        return STRIPE_FAILED;
+    }
+    int inflated = stbi_zlib_decode_buffer((char*)filtered, (int)filteredSize, (const char*)compressed, (int)compressedSize);
+    if (inflated < (int)filteredSize) {
+        std::free(filtered);
+        imageDecodeFailure = "corrupt PNG data";
+        return STRIPE_FAILED;
+    }
+
+    // Stripe starts: the None / Sub rows closest after an even split
+    unsigned int target = stripeTarget((unsigned int)height, 64);
+    std::vector<int> stripeRows = {0};
+    for (unsigned int s = 1; s < target; s++) {
+        int row = std::max((int)((long long)s * height / target), stripeRows.back() + 1);
+        while (row < height && filtered[(size_t)row * (rowSize + 1)] > 1) row++;
+        if (row < height) stripeRows.push_back(row);
+    }
+    stripeRows.push_back(height);
+
+    std::vector<unsigned char> zeros(rowSize, 0);
+    std::atomic<bool> failed{false};
+    jobSystem().parallelFor((unsigned int)stripeRows.size() - 1, 1, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int s = begin; s < end && !failed.load(std::memory_order_relaxed); s++) {
+            for (int y = stripeRows[s]; y < stripeRows[s + 1]; y++) {
+                unsigned char* filteredRow = filtered + (size_t)y * (rowSize + 1);
+                unsigned char* row = filteredRow + 1;
+                const unsigned char* previous = (y == stripeRows[s]) ? zeros.data() : row - (rowSize + 1);   // Stripe starts: None / Sub
+                if (!unfilterPNGRow(row, row, previous, rowSize, pixelSize, filteredRow[0])) {
+                    failed.store(true);
+                    break;
+                }
+                if (direct) std::memcpy(destination + rowPitch * y, row, rowSize);
+                else convertPNGRow(row, destination + rowPitch * y, width, components, sampleSize, channels);
+            }
+        }
+    });
+    std::free(filtered);
+    imageDecodeStripeCount = (unsigned int)stripeRows.size() - 1;
+    if (failed.load()) {
+        imageDecodeFailure = "corrupt PNG filter";
+        return STRIPE_FAILED;
+    }
+    return STRIPE_DECODED;
+}
+
+// Native decode into the destination (libjpeg-turbo JPEG, large PNG stripes), NOT_HANDLED: stb_image decodes it
+static StripeResult decodeStripes (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch,
+                                   int width, int height, int channels, ImageBackend backend, bool parallel)
+{
+    imageDecodeStripeCount = 1;
+#if defined(IMAGE_DECODER_LIBJPEG)
+    if (backend != IMAGE_BACKEND_STB && isJPEG(encodedData, encodedSize)) {
+        StripeResult result = decodeJPEG(encodedData, encodedSize, destination, rowPitch, channels, parallel);
+        if (result == STRIPE_DECODED) return result;
+        if (backend == IMAGE_BACKEND_LIBJPEG) return STRIPE_FAILED;    // AUTO: stb_image tries it
+    }
+#endif
+    if (backend == IMAGE_BACKEND_LIBJPEG) {
+        imageDecodeFailure = !isJPEG(encodedData, encodedSize) ? "not a JPEG" :
+                             imageBackendAvailable(IMAGE_BACKEND_LIBJPEG) ? "unsupported JPEG (libjpeg)" : "libjpeg backend not compiled in";
+        return STRIPE_FAILED;
+    }
+    bool split = parallel && (long long)width * height >= IMAGE_PARALLEL_PIXELS && jobSystem().threadCount() > 1;
+    if (split && isPNG(encodedData, encodedSize)) return decodePNG(encodedData, encodedSize, destination, rowPitch, channels);
+    return STRIPE_NOT_HANDLED;
+}
+
+// Only JPEG (libjpeg-turbo) and large PNG go through the stripe paths: everything else is decoded by stb_image directly
+static bool stripeCandidate (const unsigned char* encodedData, size_t encodedSize, int width, int height, ImageBackend backend)
+{
+    if (backend == IMAGE_BACKEND_LIBJPEG) return true;
+    if (backend == IMAGE_BACKEND_AUTO && imageBackendAvailable(IMAGE_BACKEND_LIBJPEG) && isJPEG(encodedData, encodedSize)) return true;
+    return (long long)width * height >= IMAGE_PARALLEL_PIXELS && isPNG(encodedData, encodedSize);
+}
+
+bool imageInfo (const unsigned char* encodedData, size_t encodedSize, int& width, int& height, int& channels)
+{
+    return stbi_info_from_memory(encodedData, (int)encodedSize, &width, &height, &channels) != 0;
+}
+
+bool decodeImage (const unsigned char* encodedData, size_t encodedSize, DecodedImage& image, int desiredChannels, ImageBackend backend)
+{
+    int width, height, channels;
+    imageDecodeStripeCount = 1;
+    if (imageInfo(encodedData, encodedSize, width, height, channels) && stripeCandidate(encodedData, encodedSize, width, height, backend)) {
+        int outputChannels = desiredChannels ? desiredChannels : channels;
+        unsigned char* pixels = (unsigned char*)std::malloc((size_t)width * height * outputChannels);
+        if (!pixels) {
+            imageDecodeFailure = "out of memory";
+            return false;
+        }
+        StripeResult result = decodeStripes(encodedData, encodedSize, pixels, (size_t)width * outputChannels, width, height, outputChannels, backend, true);
+        if (result == STRIPE_DECODED) {
+            image.release();
+            image.pixels = pixels;
+            image.width = width;
+            image.height = height;
+            image.channels = outputChannels;
+            return true;
+        }
+        std::free(pixels);
+        if (result == STRIPE_FAILED) return false;
+    } else if (backend == IMAGE_BACKEND_LIBJPEG) {
+        imageDecodeFailure = stbi_failure_reason();
+        return false;
+    }
+
+    unsigned char* pixels = stbi_load_from_memory(encodedData, (int)encodedSize, &width, &height, &channels, desiredChannels);
+    if (!pixels) {
+        imageDecodeFailure = stbi_failure_reason();
+        return false;
+    }
+    image.release();
+    image.pixels = pixels;
+    image.width = width;
+    image.height = height;
+    image.channels = desiredChannels ? desiredChannels : channels;
+    return true;
+}
+
+bool decodeImageFile (const std::string& imageFilePath, DecodedImage& image, int desiredChannels, ImageBackend backend)
+{
+    std::ifstream file(imageFilePath, std::ios::binary);
+    if (!file) {
+        imageDecodeFailure = "can't open the file";
+        return false;
+    }
+    std::vector<unsigned char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decodeImage(encoded.data(), encoded.size(), image, desiredChannels, backend);
+}
+
+bool decodeImageInto (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch,
+                      int desiredChannels, ImageBackend backend, bool parallel)
+{
+    int width, height, channels;
+    imageDecodeStripeCount = 1;
+    if (!imageInfo(encodedData, encodedSize, width, height, channels)) {
+        imageDecodeFailure = stbi_failure_reason();
+        return false;
+    }
+    int outputChannels = desiredChannels ? desiredChannels : channels;
+    StripeResult result = decodeStripes(encodedData, encodedSize, destination, rowPitch, width, height, outputChannels, backend, parallel);
+    if (result != STRIPE_NOT_HANDLED) return result == STRIPE_DECODED;
+
+    // stb_image decodes into its own allocation: copied row by row
+    unsigned char* pixels = stbi_load_from_memory(encodedData, (int)encodedSize, &width, &height, &channels, outputChannels);
+    if (!pixels) {
+        imageDecodeFailure = stbi_failure_reason();
+        return false;
+    }
+    size_t rowSize = (size_t)width * outputChannels;
+    for (int y = 0; y < height; y++) std::memcpy(destination + rowPitch * y, pixels + rowSize * y, rowSize);
+    stbi_image_free(pixels);
+    return true;
+}
+
+const char* imageDecodeError ()
+{
+    return imageDecodeFailure;
+}
+
+unsigned int imageDecodeStripes ()
+{
+    return imageDecodeStripeCount;
+}
+
+bool imageBackendAvailable (ImageBackend backend)
+{
+#if defined(IMAGE_DECODER_LIBJPEG)
+    (void)backend;
+    return true;
+#else
+    return backend != IMAGE_BACKEND_LIBJPEG;
+#endif
+}
+
+const char* imageDecoderSimd ()
+{
+#if defined(STBI_SSE2)
+    return "SSE2";
+#elif defined(STBI_NEON)
+    return "NEON";
+#else
+    return "none";
+#endif
+}
@@ -0,0 +1,65 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <string>
+#include <cstddef>
+
+// Image Decoder
+// One interface for every image decode (textures, residency streaming, atlas packing). The decoders are compiled
+// once in ImageDecoder.cpp, not in every translation unit that includes a texture header: stb_image with its
+// SSE2 (x86, MinGW included) or NEON (ARM) paths, plus libjpeg-turbo for JPEG when built with IMAGE_DECODER_LIBJPEG
+// (CMake: found libjpeg). Decodes are independent, any thread can run one (the error message is per thread).
+// Large images are also split inside one decode over the job system: JPEG in stripes of MCU rows (libjpeg-turbo: each
+// stripe starts at a restart marker when the file has them, skips to its rows otherwise), PNG by unfiltering stripes
+// that start at rows not depending on the row above (None / Sub filters; the inflate itself stays serial).
+
+enum ImageBackend {
+    IMAGE_BACKEND_AUTO,       // libjpeg-turbo for JPEG when available, stb_image otherwise
+    IMAGE_BACKEND_STB,
+    IMAGE_BACKEND_LIBJPEG     // JPEG only
+};
+
+// Decoded image: 8 bits per channel, top row first (malloc'd, freed with the image)
+struct DecodedImage {
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0, channels = 0;
+
+    DecodedImage () = default;
+    DecodedImage (const DecodedImage&) = delete;
+    DecodedImage& operator= (const DecodedImage&) = delete;
+    DecodedImage (DecodedImage&& other) noexcept { *this = static_cast<DecodedImage&&>(other); }
+    DecodedImage& operator= (DecodedImage&& other) noexcept;
+    ~DecodedImage () { release(); }
+
+    size_t size () const { return (size_t)width * height * channels; }
+    void release ();
+};
+
+// Decodes of at least this many pixels are split over the job system threads
+const long long IMAGE_PARALLEL_PIXELS = 2048 * 2048;
+
+// Size and channels without decoding
+bool imageInfo (const unsigned char* encodedData, size_t encodedSize, int& width, int& height, int& channels);
+
+// Decode an encoded image (desiredChannels 0: as stored), false with imageDecodeError() on failure
+bool decodeImage (const unsigned char* encodedData, size_t encodedSize, DecodedImage& image, int desiredChannels = 0,
+                  ImageBackend backend = IMAGE_BACKEND_AUTO);
+bool decodeImageFile (const std::string& imageFilePath, DecodedImage& image, int desiredChannels = 0, ImageBackend backend = IMAGE_BACKEND_AUTO);
+
+// Decode into caller memory (a mapped pixel unpack buffer, a staging vector ...): imageInfo() size, rows of rowPitch
+// bytes, top row first (desiredChannels 0: imageInfo() channels). parallel false: the calling thread only
+bool decodeImageInto (const unsigned char* encodedData, size_t encodedSize, unsigned char* destination, size_t rowPitch,
+                      int desiredChannels = 0, ImageBackend backend = IMAGE_BACKEND_AUTO, bool parallel = true);
+
+// Reason of the last failed decode on this thread
+const char* imageDecodeError ();
+
+// Stripes the last decode on this thread was split in (1: one thread)
+unsigned int imageDecodeStripes ();
+
+bool imageBackendAvailable (ImageBackend backend);
+
+// SIMD path compiled into stb_image: "SSE2", "NEON" or "none"
+const char* imageDecoderSimd ();
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <new>
+#include <utility>
+#include <algorithm>
+
+// Job System
+// One worker per core; every worker owns a Chase-Lev work-stealing deque: it pushes / pops jobs at the
+// bottom (LIFO, cache warm) while idle workers steal from the top (FIFO, large pieces first).
+// Threads that are not workers (the thread that created the system, loaders) submit through a shared
+// injection queue. Waiting on a counter executes other jobs instead of blocking.
+// Jobs must never call OpenGL: the GL context stays on the submission thread.
+
+const unsigned int JOB_DEQUE_CAPACITY = 4096;   // Per worker, power of 2
+const unsigned int JOB_POOL_SIZE = 16384;       // Jobs in flight at once, power of 2
+const unsigned int JOB_DATA_SIZE = 64;          // Inline storage for the job's callable (no heap allocation)
+const unsigned int JOB_MAX_CONTINUATIONS = 16;
+const unsigned int JOB_WORKERS_PER_CORE = 0xFFFFFFFF;   // Worker count: one per core minus the calling thread
+
+struct Job;
+
+// Job Counter: number of unfinished jobs, plus the jobs to start once it reaches 0 (dependencies)
+// Completions take the lock, so a waiter only sees done() once the last job stopped touching the counter
+// (counters usually live on the waiter's stack)
+struct JobCounter {
+    std::atomic<int> pending;
+    std::atomic<bool> locked;
+    Job* continuations[JOB_MAX_CONTINUATIONS];
+    int continuationCount;
+
+    JobCounter () : pending(0), locked(false), continuationCount(0) {}
+
+    bool done () const { return pending.load(std::memory_order_acquire) == 0 && !locked.load(std::memory_order_acquire); }
+
+    void lock ()
+    {
+        while (locked.exchange(true, std::memory_order_acquire))
+            while (locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+    }
+
+    void unlock () { locked.store(false, std::memory_order_release); }
+};
+
+// Job: callable stored inline, counter decremented when it finishes
+struct Job {
+    void (*invoke)(void* data);
+    void (*destroy)(void* data);
+    JobCounter* counter;
+    std::atomic<bool> busy;             // Pool slot taken: created and not finished yet (queued, waiting on a dependency or running)
+    alignas(16) unsigned char data[JOB_DATA_SIZE];
+};
+
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient Work-Stealing for Weak Memory Models")
+struct WorkStealingDeque {
+    std::atomic<long long> top;
+    std::atomic<long long> bottom;
+    std::atomic<Job*> buffer[JOB_DEQUE_CAPACITY];
+
+    WorkStealingDeque () : top(0), bottom(0)
+    {
+        for (std::atomic<Job*>& slot : buffer) slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Owner only: false when full (the caller runs the job itself)
+    bool push (Job* job)
+    {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+        if (b - t >= (long long)JOB_DEQUE_CAPACITY) return false;
+        buffer[b & (JOB_DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);   // Publishes the job to thieves (acquire load of bottom)
+        return true;
+    }
+
+    // Owner only
+    Job* pop ()
+    {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);   // Empty
+            return nullptr;
+        }
+
+        Job* job = buffer[b & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last job: race against the thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Any thread
+    Job* steal ()
+    {
+        long long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Job* job = buffer[t & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;   // Lost the race
+        return job;
+    }
+};
+
+// Job System
+struct JobSystem {
+
+    std::vector<std::thread> workers;
+    std::vector<WorkStealingDeque*> deques;   // [0] unused (injection queue instead), [1..n] workers
+    Job* jobPool;
+    std::atomic<unsigned int> nextJob;
+
+    // Injection queue for non worker threads: only holds jobs of busy pool slots, so it never grows past its
+    // JOB_POOL_SIZE reserve (no allocation after the constructor)
+    std::mutex injectionMutex;
+    std::vector<Job*> injection;
+
+    // Sleeping workers
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> sleeping;
+    std::atomic<bool> running;
+
+    // Constructor: workerCount background threads (JOB_WORKERS_PER_CORE: one per core minus the calling thread,
+    // 0: no workers, jobs run on the threads that wait for them)
+    JobSystem (unsigned int workerCount = JOB_WORKERS_PER_CORE) : nextJob(0), sleeping(0), running(true)
+    {
+        if (workerCount == JOB_WORKERS_PER_CORE) workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        jobPool = new Job[JOB_POOL_SIZE];
+        for (unsigned int j = 0; j < JOB_POOL_SIZE; j++) jobPool[j].busy.store(false, std::memory_order_relaxed);
+        injection.reserve(JOB_POOL_SIZE);
+
+        deques.push_back(nullptr);
+        for (unsigned int w = 0; w < workerCount; w++) deques.push_back(new WorkStealingDeque());
+        for (unsigned int w = 0; w < workerCount; w++) workers.emplace_back([this, w]() { workerLoop(w + 1); });
+    }
+
+    // Number of threads executing jobs (workers + the waiting thread)
+    unsigned int threadCount () const { return (unsigned int)workers.size() + 1; }
+
+    // Index of the calling thread: 1..n for workers, 0 for everything else
+    static unsigned int& threadIndex ()
+    {
+        static thread_local unsigned int index = 0;
+        return index;
+    }
+
+    // Create a job from any callable that fits in JOB_DATA_SIZE bytes
+    template <typename F>
+    Job* createJob (F&& function, JobCounter* counter)
+    {
+        typedef typename std::decay<F>::type Callable;
+        static_assert(sizeof(Callable) <= JOB_DATA_SIZE, "Job callable too large: capture by reference or pointer");
+        static_assert(alignof(Callable) <= 16, "Job callable over aligned");
+
+        Job* job = claimJob();
+        new (job->data) Callable(std::forward<F>(function));
+        job->invoke = [](void* data) { (*static_cast<Callable*>(data))(); };
+        job->destroy = [](void* data) { static_cast<Callable*>(data)->~Callable(); };
+        job->counter = counter;
+        return job;
+    }
+
+    // Free pool slot: the ring is probed from the next position; with every slot in flight the caller runs
+    // pending jobs until one finishes (a slot is never reused while its job can still run)
+    Job* claimJob ()
+    {
+        for (unsigned int probe = 1;; probe++) {
+            Job* job = &jobPool[nextJob.fetch_add(1, std::memory_order_relaxed) & (JOB_POOL_SIZE - 1)];
+            if (!job->busy.exchange(true, std::memory_order_acquire)) return job;
+            if (probe % JOB_POOL_SIZE == 0 && !help()) std::this_thread::yield();
+        }
+    }
+
+    // Run a job; counter (optional) is incremented now and decremented when the job finishes
+    template <typename F>
+    void run (F&& function, JobCounter* counter = nullptr)
+    {
+        if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+        submit(createJob(std::forward<F>(function), counter));
+    }
+
+    // Run a job once dependency reaches 0 (immediately when it already has)
+    template <typename F>
+    void runAfter (JobCounter& dependency, F&& function, JobCounter* counter = nullptr)
+    {
+        if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+        Job* job = createJob(std::forward<F>(function), counter);
+
+        dependency.lock();
+        bool ready = dependency.pending.load(std::memory_order_acquire) == 0 || dependency.continuationCount == (int)JOB_MAX_CONTINUATIONS;
+        if (!ready) dependency.continuations[dependency.continuationCount++] = job;
+        dependency.unlock();
+
+        if (ready) {
+            if (!dependency.done()) wait(dependency);   // Continuation list full: wait here instead
+            submit(job);
+        }
+    }
+
+    void submit (Job* job)
+    {
+        unsigned int index = threadIndex();
+        if (index == 0 || !deques[index]->push(job)) {
+            if (index != 0) { execute(job); return; }   // Own deque full
+            std::lock_guard<std::mutex> guard(injectionMutex);
+            injection.push_back(job);
+        }
+        if (sleeping.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> guard(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    void execute (Job* job)
+    {
+        job->invoke(job->data);
+        job->destroy(job->data);
+
+        JobCounter* counter = job->counter;
+        job->busy.store(false, std::memory_order_release);   // Slot free for the next createJob
+        if (!counter) return;
+
+        // Counter reached 0: start the jobs that depended on it (the unlock is the last access)
+        Job* continuations[JOB_MAX_CONTINUATIONS];
+        int continuationCount = 0;
+        counter->lock();
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuationCount = counter->continuationCount;
+            std::copy(counter->continuations, counter->continuations + continuationCount, continuations);
+            counter->continuationCount = 0;
+        }
+        counter->unlock();
+        for (int c = 0; c < continuationCount; c++) submit(continuations[c]);
+    }
+
+    // Own deque first, then the injection queue, then steal from the others (starting at a neighbour)
+    Job* findJob (unsigned int index)
+    {
+        if (index != 0) {
+            if (Job* job = deques[index]->pop()) return job;
+        }
+        {
+            std::lock_guard<std::mutex> guard(injectionMutex);
+            if (!injection.empty()) {
+                Job* job = injection.back();
+                injection.pop_back();
+                return job;
+            }
+        }
+        unsigned int count = (unsigned int)deques.size();
+        for (unsigned int i = 1; i < count; i++) {
+            unsigned int victim = 1 + (index + i - 1) % (count - 1);
+            if (victim == index) continue;
+            if (Job* job = deques[victim]->steal()) return job;
+        }
+        return nullptr;
+    }
+
+    // Execute one pending job if there is one
+    bool help ()
+    {
+        Job* job = findJob(threadIndex());
+        if (!job) return false;
+        execute(job);
+        return true;
+    }
+
+    // Wait for a counter, running jobs meanwhile
+    void wait (JobCounter& counter)
+    {
+        while (!counter.done())
+            if (!help()) std::this_thread::yield();
+    }
+
+    void workerLoop (unsigned int index)
+    {
+        threadIndex() = index;
+        int idle = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (help()) { idle = 0; continue; }
+
+            // Spin briefly, then sleep until a job is submitted
+            if (++idle < 64) { std::this_thread::yield(); continue; }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1);
+            wake.wait_for(lock, std::chrono::milliseconds(1));
+            sleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+
+    // Parallel For: function(begin, end) over [0, count) in ranges of grain items, returns when all are done
+    template <typename F>
+    void parallelFor (unsigned int count, unsigned int grain, const F& function)
+    {
+        if (count == 0) return;
+        grain = std::max(1u, grain);
+        if (count <= grain || workers.empty()) { function(0u, count); return; }
+
+        JobCounter counter;
+        const F* functionPointer = &function;
+        for (unsigned int begin = grain; begin < count; begin += grain) {
+            unsigned int end = std::min(count, begin + grain);
+            run([functionPointer, begin, end]() { (*functionPointer)(begin, end); }, &counter);
+        }
+        function(0u, std::min(count, grain));   // First range on the calling thread
+        wait(counter);
+    }
+
+    // Destructor
+    ~JobSystem ()
+    {
+        running.store(false);
+        {
+            std::lock_guard<std::mutex> guard(sleepMutex);
+            wake.notify_all();
+        }
+        for (std::thread& worker : workers) worker.join();
+        for (WorkStealingDeque* deque : deques) delete deque;
+        delete[] jobPool;
+    }
+};
+
+// Shared job system used by the engine modules (culling, BVH build, mesh import, texture decode)
+inline JobSystem& jobSystem ()
+{
+    static JobSystem system;
+    return system;
+}
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+#include <GLFW/glfw3.h>          // GLFW for window and context management
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+#include "ShaderCompiler.h"
+#include "ShaderPreprocessor.h"
+#include "Sampler.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+// Material System
+// A material declares features; every feature is a #define of one shader template (material_vertex.glsl /
+// material_fragment.glsl), so a feature bitmask names one program variant. Variants are compiled lazily on a
+// compile thread with its own hidden context sharing objects with the window's context (or ahead of time with
+// precompile), all queued variants at once through the ShaderCompiler (parallel driver compiles), and cached by
+// bitmask. Asking for a variant never waits for a compile: the fallback variant (no features, compiled up front)
+// is returned until the requested one is ready.
+
+enum MaterialFeature : uint32_t {
+    MATERIAL_TEXTURED     = 1 << 0,   // Base color texture (unit 0)
+    MATERIAL_VERTEX_COLOR = 1 << 1,   // Vertex color multiplies the base color
+    MATERIAL_NORMAL_MAP   = 1 << 2,   // Tangent space normal map (unit 1), needs Normal / Tangent attributes
+    MATERIAL_ALPHA_TEST   = 1 << 3,   // Discard below the alpha cutoff
+    MATERIAL_SKINNING     = 1 << 4,   // Bone matrices (SSBO binding 7), needs BoneIndices / BoneWeights attributes
+    MATERIAL_FEATURE_COUNT = 5
+};
+
+const uint32_t MATERIAL_PERMUTATIONS = 1u << MATERIAL_FEATURE_COUNT;
+const char* const MATERIAL_FEATURE_DEFINES[MATERIAL_FEATURE_COUNT] = {"TEXTURED", "VERTEX_COLOR", "NORMAL_MAP", "ALPHA_TEST", "SKINNING"};
+
+enum MaterialVariantState {
+    VARIANT_NONE,        // Never requested
+    VARIANT_QUEUED,      // Waiting for / on the compile thread
+    VARIANT_READY,
+    VARIANT_FAILED       // Compile or link error: the fallback stays in use
+};
+
+// Template source with the feature #defines inserted after the #version line
+inline std::string materialSource (const std::string& templateSource, uint32_t features)
+{
+    std::string defines;
+    for (uint32_t feature = 0; feature < MATERIAL_FEATURE_COUNT; feature++)
+        if (features & (1u << feature)) defines += std::string("#define ") + MATERIAL_FEATURE_DEFINES[feature] + "\n";
+
+    size_t version = templateSource.find("#version");
+    size_t line = (version == std::string::npos) ? 0 : templateSource.find('\n', version);
+    if (line == std::string::npos) return templateSource + "\n" + defines;
+    return templateSource.substr(0, line ? line + 1 : 0) + defines + templateSource.substr(line ? line + 1 : 0);
+}
+
+// Variant: one program of the template, published by the compile thread
+struct MaterialVariant {
+    std::atomic<unsigned int> program{0};
+    std::atomic<int> state{VARIANT_NONE};
+    std::vector<std::pair<std::string, int>> uniformLocations;   // Render thread only
+
+    // Uniform Location: looked up once per name (render thread)
+    int uniformLocation (const char* name)
+    {
+        for (const std::pair<std::string, int>& uniform : uniformLocations)
+            if (uniform.first == name) return uniform.second;
+        int location = glGetUniformLocation(program.load(std::memory_order_acquire), name);
+        uniformLocations.push_back({name, location});
+        return location;
+    }
+};
+
+// Material Library: variant cache of one shader template + the compile thread
+struct MaterialLibrary {
+
+    std::string vertexTemplate;
+    std::string fragmentTemplate;
+    MaterialVariant variants[MATERIAL_PERMUTATIONS];
+    uint32_t fallbackFeatures = 0;
+
+    // Builds in flight: compile thread (or the render thread without a compile context)
+    ShaderCompiler compiler;
+    unsigned int tickets[MATERIAL_PERMUTATIONS];
+
+    // Compile thread: hidden window whose context shares objects with the main one
+    GLFWwindow* compileWindow = nullptr;
+    std::thread compileThread;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::vector<uint32_t> queue;
+    std::atomic<bool> running{false};    // Written under queueMutex, read without it by variant() / request() (render thread)
+
+    // Constructor (main thread, before the render thread takes the context): templates read, fallback compiled
+    // now on the current context, compile context created sharing with window (null: variants compile on request)
+    MaterialLibrary (GLFWwindow* window, const std::string& vertexTemplatePath, const std::string& fragmentTemplatePath)
+    {
+        vertexTemplate = readTemplate(vertexTemplatePath);
+        fragmentTemplate = readTemplate(fragmentTemplatePath);
+        for (unsigned int& ticket : tickets) ticket = ~0u;
+        compiler.setup();
+        variants[fallbackFeatures].state = VARIANT_QUEUED;
+        submit(fallbackFeatures);
+        compiler.finish();
+        collect(false);
+        if (variants[fallbackFeatures].state != VARIANT_READY)
+            std::cout << "Material fallback variant failed to build: materials draw nothing until a variant compiles" << std::endl;
+
+        if (!window) return;
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        compileWindow = glfwCreateWindow(1, 1, "Material Compiler", nullptr, window);
+        glfwDefaultWindowHints();
+        if (!compileWindow) {
+            std::cout << "Failed to create the material compile context: variants compile on request" << std::endl;
+            return;
+        }
+        running = true;
+        compileThread = std::thread([this]() { compileLoop(); });
+    }
+
+    // Destructor: release() must already have run on the main thread while GLFW is alive (window destruction)
+    ~MaterialLibrary () { stop(); }
+
+    // Program for a feature set (render thread, never waits): the variant when compiled, the fallback until then
+    MaterialVariant& variant (uint32_t features)
+    {
+        features &= MATERIAL_PERMUTATIONS - 1;
+        MaterialVariant& requested = variants[features];
+        if (!running && compiler.pending()) collect(false);
+        int state = requested.state.load(std::memory_order_acquire);
+        if (state == VARIANT_READY) return requested;
+        if (state == VARIANT_NONE) request(features);
+        return variants[fallbackFeatures];
+    }
+
+    unsigned int program (uint32_t features) { return variant(features).program.load(std::memory_order_acquire); }
+
+    bool ready (uint32_t features) const { return variants[features & (MATERIAL_PERMUTATIONS - 1)].state.load(std::memory_order_acquire) == VARIANT_READY; }
+
+    // Queue every variant the scene's materials use (loading screen / startup), compiled in the background
+    void precompile (const std::vector<uint32_t>& featureSets)
+    {
+        for (uint32_t features : featureSets)
+            if (variants[features & (MATERIAL_PERMUTATIONS - 1)].state.load(std::memory_order_acquire) == VARIANT_NONE)
+                request(features & (MATERIAL_PERMUTATIONS - 1));
+    }
+
+    // Stop the compile thread and destroy its window (main thread), delete the programs (any thread with a current context)
+    void release ()
+    {
+        stop();
+        compiler.finish();
+        collect(false);
+        if (compileWindow) glfwDestroyWindow(compileWindow);
+        compileWindow = nullptr;
+        for (MaterialVariant& materialVariant : variants) {
+            glDeleteProgram(materialVariant.program.exchange(0));
+            materialVariant.state = VARIANT_NONE;
+            materialVariant.uniformLocations.clear();
+        }
+    }
+
+    // Internal
+    std::string readTemplate (const std::string& filePath)
+    {
+        ShaderSource source = shaderPreprocessor().preprocess(filePath);
+        if (!source.success) std::cout << "Failed to read the material template: " << filePath << std::endl;
+        return source.text;
+    }
+
+    // Submit a variant to the compiler (current context)
+    void submit (uint32_t features)
+    {
+        std::string name = "[";
+        for (uint32_t feature = 0; feature < MATERIAL_FEATURE_COUNT; feature++)
+            if (features & (1u << feature)) name += std::string(name.size() > 1 ? " " : "") + MATERIAL_FEATURE_DEFINES[feature];
+        name += "]";
+        tickets[features] = compiler.submit(materialSource(vertexTemplate, features), materialSource(fragmentTemplate, features), "material " + name);
+    }
+
+    // Publish the variants whose build finished; finishFirst on the compile thread: the programs are complete
+    // before another (sharing) context first uses them
+    void collect (bool finishFirst)
+    {
+        if (compiler.poll() == 0) return;
+        if (finishFirst) glFinish();
+        for (uint32_t features = 0; features < MATERIAL_PERMUTATIONS; features++) {
+            MaterialVariant& materialVariant = variants[features];
+            if (tickets[features] == ~0u || materialVariant.state.load(std::memory_order_relaxed) != VARIANT_QUEUED) continue;
+            ShaderCompileState state = compiler.state(tickets[features]);
+            if (state == SHADER_COMPILE_PENDING) continue;
+            materialVariant.program.store(compiler.program(tickets[features]), std::memory_order_release);
+            materialVariant.state.store(state == SHADER_COMPILE_READY ? VARIANT_READY : VARIANT_FAILED, std::memory_order_release);
+        }
+    }
+
+    void request (uint32_t features)
+    {
+        int expected = VARIANT_NONE;
+        if (!variants[features].state.compare_exchange_strong(expected, VARIANT_QUEUED, std::memory_order_acq_rel)) return;
+        if (!running) {
+            submit(features);    // No compile context: built on the caller's context, collected by the next variant()
+            return;
+        }
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(features);
+        queueChanged.notify_one();
+    }
+
+    void compileLoop ()
+    {
+        glfwMakeContextCurrent(compileWindow);
+        compiler.setup();
+        std::vector<uint32_t> submitted;
+        for (;;) {
+            // Everything queued is submitted at once, then polled every millisecond while builds are in flight
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                if (compiler.pending())
+                    queueChanged.wait_for(lock, std::chrono::milliseconds(1), [this]() { return !queue.empty() || !running; });
+                else
+                    queueChanged.wait(lock, [this]() { return !queue.empty() || !running; });
+                if (!running) break;
+
+                // Submitted under the lock: the templates can be replaced (ShaderHotReload)
+                submitted.swap(queue);
+                for (uint32_t features : submitted) submit(features);
+                submitted.clear();
+            }
+            collect(true);
+        }
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    void stop ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!running) return;
+            running = false;
+        }
+        queueChanged.notify_all();
+        compileThread.join();
+    }
+};
+
+// Material: feature set + parameters, bound with the variant its features select
+struct Material {
+    std::string name;
+    uint32_t features = MATERIAL_TEXTURED;
+    glm::vec4 color = glm::vec4(1.0f);      // Base color factor
+    float alphaCutoff = 0.5f;
+    unsigned int texture = 0;               // Unit 0
+    unsigned int normalMap = 0;             // Unit 1
+    unsigned int sampler = 0;               // Sampler of both units (samplerCache().get(...)), 0: the cache's default
+
+    // Bind the program (fallback while the variant compiles) and the material state, returns the variant for the draw uniforms
+    MaterialVariant& bind (MaterialLibrary& library) const
+    {
+        MaterialVariant& materialVariant = library.variant(features);
+        glUseProgram(materialVariant.program.load(std::memory_order_acquire));
+        glUniform4fv(materialVariant.uniformLocation("fsColor"), 1, glm::value_ptr(color));
+        glUniform1f(materialVariant.uniformLocation("fsAlphaCutoff"), alphaCutoff);
+        unsigned int materialSampler = sampler ? sampler : samplerCache().defaultSampler();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glBindSampler(0, materialSampler);
+        if (features & MATERIAL_NORMAL_MAP) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, normalMap);
+            glBindSampler(1, materialSampler);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        return materialVariant;
+    }
+};
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+#include "Shader.h"              // Vertex
+#include "ComputeShader.h"
+#include "DrawCommand.h"
+#include "Frustum.h"
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+// Meshlet (cluster): a small group of triangles sharing at most maxVertices vertices
+// The triangles index a local vertex list, so a meshlet can be culled or drawn on its own
+struct Meshlet {
+    unsigned int vertexOffset;    // First entry in MeshletMesh::meshletVertices
+    unsigned int triangleOffset;  // First entry in MeshletMesh::meshletTriangles
+    unsigned int vertexCount;
+    unsigned int triangleCount;
+};
+
+// Culling data (std430 layout: vec3 + float, vec3 + float)
+struct MeshletBounds {
+    glm::vec3 center;     // Bounding sphere
+    float radius;
+    glm::vec3 coneAxis;   // Average triangle normal
+    float coneCutoff;     // sin(cone half angle), 1 = cone disabled (triangles face too many directions)
+};
+
+static_assert(sizeof(MeshletBounds) == 32, "MeshletBounds must match the std430 layout of meshlet_cull.glsl");
+
+// Meshlet Mesh
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<unsigned int> meshletVertices;   // Local vertex -> global vertex index
+    std::vector<unsigned int> meshletTriangles;  // Packed local indices: a | b << 8 | c << 16
+};
+
+// Meshlet limits (64 vertices / 124 triangles fit the mesh shader limits of every vendor)
+const unsigned int MESHLET_MAX_VERTICES = 64;
+const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+// Bounding sphere and normal cone of one meshlet
+inline MeshletBounds meshletComputeBounds (const MeshletMesh& mesh, const Meshlet& meshlet, const std::vector<Vertex>& vertices)
+{
+    MeshletBounds bounds;
+
+    // Bounding sphere (Ritter): start from the two most distant points along x, grow to contain every vertex
+    const unsigned int* local = &mesh.meshletVertices[meshlet.vertexOffset];
+    glm::vec3 minX = vertices[local[0]].Position, maxX = minX;
+    for (unsigned int i = 1; i < meshlet.vertexCount; i++) {
+        const glm::vec3& p = vertices[local[i]].Position;
+        if (p.x < minX.x) minX = p;
+        if (p.x > maxX.x) maxX = p;
+    }
+    glm::vec3 center = (minX + maxX) * 0.5f;
+    float radius = glm::length(maxX - minX) * 0.5f;
+    for (unsigned int i = 0; i < meshlet.vertexCount; i++) {
+        const glm::vec3& p = vertices[local[i]].Position;
+        float distance = glm::length(p - center);
+        if (distance > radius) {
+            float newRadius = (radius + distance) * 0.5f;
+            center += (p - center) * ((newRadius - radius) / distance);
+            radius = newRadius;
+        }
+    }
+    bounds.center = center;
+    bounds.radius = radius;
+
+    // Normal cone: axis = average of the unit triangle normals, spread = smallest dot(axis, normal)
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.triangleCount);
+    glm::vec3 axis(0.0f);
+    for (unsigned int t = 0; t < meshlet.triangleCount; t++) {
+        unsigned int packed = mesh.meshletTriangles[meshlet.triangleOffset + t];
+        const glm::vec3& a = vertices[local[packed & 0xFF]].Position;
+        const glm::vec3& b = vertices[local[(packed >> 8) & 0xFF]].Position;
+        const glm::vec3& c = vertices[local[(packed >> 16) & 0xFF]].Position;
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float area = glm::length(normal);
+        if (area <= 1e-12f) continue;  // Degenerate triangles have no facing
+        normals.push_back(normal / area);
+        axis += normals.back();
+    }
+
+    bounds.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    bounds.coneCutoff = 1.0f;
+    float axisLength = glm::length(axis);
+    if (normals.empty() || axisLength <= 1e-6f) return bounds;
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals)
+        minDot = std::min(minDot, glm::dot(axis, normal));
+
+    // Normals spread over a hemisphere or more: the cluster always has a front facing triangle
+    bounds.coneAxis = axis;
+    if (minDot <= 0.0f) return bounds;
+    bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+
+    return bounds;
+}
+
+// Build meshlets from a flattened triangle list (loadModel output)
+// Greedy growth: the next triangle is the neighbour that adds the fewest new vertices, which keeps
+// meshlets compact (tight spheres) and flat (narrow cones); a new meshlet starts when a limit is hit
+inline MeshletMesh buildMeshlets (const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                  unsigned int maxVertices = MESHLET_MAX_VERTICES, unsigned int maxTriangles = MESHLET_MAX_TRIANGLES)
+{
+    MeshletMesh mesh;
+    unsigned int triangleCount = (unsigned int)(indices.size() / 3);
+    if (triangleCount == 0 || vertices.empty()) return mesh;
+    maxVertices = std::min(std::max(maxVertices, 3u), 256u);  // Local indices are 8 bit
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    // Vertex -> triangles adjacency (compressed rows)
+    std::vector<unsigned int> adjacencyOffset(vertices.size() + 1, 0);
+    for (unsigned int index : indices) adjacencyOffset[index + 1]++;
+    for (size_t v = 0; v < vertices.size(); v++) adjacencyOffset[v + 1] += adjacencyOffset[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (unsigned int i = 0; i < (unsigned int)indices.size(); i++) adjacency[fill[indices[i]]++] = i / 3;
+
+    std::vector<int> localIndex(vertices.size(), -1);  // Global vertex -> local index in the current meshlet
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> candidates;
+    unsigned int nextSeed = 0;
+
+    Meshlet current = {0, 0, 0, 0};
+
+    // Close the current meshlet and reset its local vertex table
+    auto flush = [&]() {
+        if (current.triangleCount == 0) return;
+        for (unsigned int i = 0; i < current.vertexCount; i++)
+            localIndex[mesh.meshletVertices[current.vertexOffset + i]] = -1;
+        mesh.meshlets.push_back(current);
+        current.vertexOffset = (unsigned int)mesh.meshletVertices.size();
+        current.triangleOffset = (unsigned int)mesh.meshletTriangles.size();
+        current.vertexCount = 0;
+        current.triangleCount = 0;
+        candidates.clear();
+    };
+
+    for (unsigned int done = 0; done < triangleCount; done++) {
+
+        // Pick the candidate that adds the fewest vertices
+        int best = -1;
+        unsigned int bestNew = 4;
+        for (size_t c = 0; c < candidates.size(); c++) {
+            unsigned int t = candidates[c];
+            if (emitted[t]) continue;
+            unsigned int newVertices = (localIndex[indices[t * 3 + 0]] < 0) + (localIndex[indices[t * 3 + 1]] < 0) + (localIndex[indices[t * 3 + 2]] < 0);
+            if (newVertices < bestNew) { bestNew = newVertices; best = (int)t; }
+        }
+
+        // No neighbour left: seed with the next triangle in index order
+        if (best < 0) {
+            while (emitted[nextSeed]) nextSeed++;
+            best = (int)nextSeed;
+            bestNew = (localIndex[indices[best * 3 + 0]] < 0) + (localIndex[indices[best * 3 + 1]] < 0) + (localIndex[indices[best * 3 + 2]] < 0);
+        }
+
+        // Limits
+        if (current.vertexCount + bestNew > maxVertices || current.triangleCount + 1 > maxTriangles) {
+            flush();
+            bestNew = 3;
+        }
+
+        // Emit the triangle
+        unsigned int packed = 0;
+        for (unsigned int k = 0; k < 3; k++) {
+            unsigned int vertex = indices[best * 3 + k];
+            if (localIndex[vertex] < 0) {
+                localIndex[vertex] = (int)current.vertexCount++;
+                mesh.meshletVertices.push_back(vertex);
+            }
+            packed |= (unsigned int)localIndex[vertex] << (8 * k);
+        }
+        mesh.meshletTriangles.push_back(packed);
+        current.triangleCount++;
+        emitted[best] = true;
+
+        // Neighbours of the new triangle become candidates
+        for (unsigned int k = 0; k < 3; k++) {
+            unsigned int vertex = indices[best * 3 + k];
+            for (unsigned int a = adjacencyOffset[vertex]; a < adjacencyOffset[vertex + 1]; a++)
+                if (!emitted[adjacency[a]]) candidates.push_back(adjacency[a]);
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                         [&](unsigned int t) { return emitted[t]; }), candidates.end());
+    }
+    flush();
+
+    // Culling data
+    mesh.bounds.reserve(mesh.meshlets.size());
+    for (const Meshlet& meshlet : mesh.meshlets)
+        mesh.bounds.push_back(meshletComputeBounds(mesh, meshlet, vertices));
+
+    return mesh;
+}
+
+// Visibility of one meshlet: frustum (sphere) and backface (cone) test
+// Every triangle is back facing when the direction from the camera to any point of the sphere lies
+// within (90 degrees - cone half angle) of the cone axis; the radius term keeps the test conservative
+inline bool meshletVisible (const MeshletBounds& bounds, const Frustum& frustum, const glm::vec3& cameraPosition)
+{
+    if (!frustum.sphereVisible(bounds.center, bounds.radius))
+        return false;
+
+    if (bounds.coneCutoff < 1.0f) {
+        glm::vec3 direction = bounds.center - cameraPosition;
+        if (glm::dot(direction, bounds.coneAxis) >= bounds.coneCutoff * glm::length(direction) + bounds.radius * (1.0f + bounds.coneCutoff))
+            return false;
+    }
+
+    return true;
+}
+
+// CPU reference culler: same result as meshlet_cull.glsl (up to the order of the meshlets)
+// Writes the global indices of the visible triangles and the indirect command that draws them
+inline unsigned int meshletCull (const MeshletMesh& mesh, const Frustum& frustum, const glm::vec3& cameraPosition,
+                                 std::vector<unsigned int>& outIndices, DrawElementsIndirectCommand& outCommand)
+{
+    outIndices.clear();
+    unsigned int visibleMeshlets = 0;
+
+    for (size_t m = 0; m < mesh.meshlets.size(); m++) {
+        if (!meshletVisible(mesh.bounds[m], frustum, cameraPosition)) continue;
+        visibleMeshlets++;
+
+        const Meshlet& meshlet = mesh.meshlets[m];
+        for (unsigned int t = 0; t < meshlet.triangleCount; t++) {
+            unsigned int packed = mesh.meshletTriangles[meshlet.triangleOffset + t];
+            outIndices.push_back(mesh.meshletVertices[meshlet.vertexOffset + (packed & 0xFF)]);
+            outIndices.push_back(mesh.meshletVertices[meshlet.vertexOffset + ((packed >> 8) & 0xFF)]);
+            outIndices.push_back(mesh.meshletVertices[meshlet.vertexOffset + ((packed >> 16) & 0xFF)]);
+        }
+    }
+
+    outCommand.count = (unsigned int)outIndices.size();
+    outCommand.instanceCount = 1;
+    outCommand.firstIndex = 0;
+    outCommand.baseVertex = 0;
+    outCommand.baseInstance = 0;
+
+    return visibleMeshlets;
+}
+
+// GPU meshlet culling: one work group per meshlet tests its bounds and appends the surviving
+// triangles to a compacted index buffer, the triangle count goes straight into an indirect command
+struct MeshletCullPass {
+
+    ComputeShader cullShader;
+    unsigned int boundsSSBO, meshletSSBO, meshletVertexSSBO, meshletTriangleSSBO;
+    unsigned int indexBuffer, indirectBuffer;
+    unsigned int meshletCount;
+
+    // Constructor
+    MeshletCullPass (const std::string& computeShaderPath = "./shaders/Compute_Shader/meshlet_cull.glsl")
+        : cullShader(computeShaderPath), meshletCount(0)
+    {
+        glGenBuffers(1, &boundsSSBO);
+        glGenBuffers(1, &meshletSSBO);
+        glGenBuffers(1, &meshletVertexSSBO);
+        glGenBuffers(1, &meshletTriangleSSBO);
+        glGenBuffers(1, &indexBuffer);
+        glGenBuffers(1, &indirectBuffer);
+    }
+
+    // Upload the meshlets; the output index buffer is sized for the worst case (everything visible)
+    void upload (const MeshletMesh& mesh)
+    {
+        meshletCount = (unsigned int)mesh.meshlets.size();
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, boundsSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mesh.bounds.size() * sizeof(MeshletBounds), mesh.bounds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, meshletSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mesh.meshlets.size() * sizeof(Meshlet), mesh.meshlets.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, meshletVertexSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mesh.meshletVertices.size() * sizeof(unsigned int), mesh.meshletVertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, meshletTriangleSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mesh.meshletTriangles.size() * sizeof(unsigned int), mesh.meshletTriangles.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mesh.meshletTriangles.size() * 3 * sizeof(unsigned int), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        DrawElementsIndirectCommand command = {0, 1, 0, 0, 0};
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), &command, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Cull against the camera: resets the command, dispatches, and makes the results visible to the draw
+    void dispatch (const glm::mat4& viewProjection, const glm::vec3& cameraPosition)
+    {
+        if (meshletCount == 0) return;
+
+        DrawElementsIndirectCommand command = {0, 1, 0, 0, 0};
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        Frustum frustum = Frustum::fromMatrix(viewProjection);
+        cullShader.bindUniformVec4Array("csFrustum", glm::value_ptr(frustum.planes[0]), 6);
+        cullShader.bindUniformVec3("csCameraPosition", glm::value_ptr(cameraPosition));
+        cullShader.bindUniformUint("csMeshletCount", meshletCount);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boundsSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, meshletSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, meshletVertexSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, meshletTriangleSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, indexBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, indirectBuffer);
+
+        // Work groups: x is limited to 65535, larger meshes spill into y
+        unsigned int groupsX = std::min(meshletCount, 65535u);
+        unsigned int groupsY = (meshletCount + groupsX - 1) / groupsX;
+        cullShader.shaderDispatch(groupsX, groupsY);
+
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+    }
+
+    // Draw the visible triangles with the mesh's VAO (attributes only, the element buffer is ours)
+    void draw (unsigned int VAO)
+    {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Destructor
+    ~MeshletCullPass ()
+    {
+        unsigned int buffers[] = {boundsSSBO, meshletSSBO, meshletVertexSSBO, meshletTriangleSSBO, indexBuffer, indirectBuffer};
+        glDeleteBuffers(6, buffers);
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <glm/glm.hpp>                // Include all GLM core / GLSL features
+#include <assimp/assimp_functions.h>  // Include specific assimp functions for 3D Models (Mesh)
+#include <assimp/IOSystem.hpp>        // Custom file system (asset packs)
+#include <assimp/MemoryIOWrapper.h>   // MemoryIOStream
+
+#include "Shader.h"                   // Vertex
+#include "AssetPack.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Asset Pack IO System: Assimp reads the model (and the files it references: .mtl, textures) from a pack
+// Stored entries are streamed straight from the mapping, compressed entries are decompressed into a stream owned buffer
+struct AssetPackIOSystem : public Assimp::IOSystem {
+
+    const AssetPack& pack;
+
+    // Constructor
+    AssetPackIOSystem (const AssetPack& assetPack) : pack(assetPack) {}
+
+    bool Exists (const char* pFile) const override
+    {
+        return pack.contains(pFile);
+    }
+
+    char getOsSeparator () const override
+    {
+        return '/';
+    }
+
+    Assimp::IOStream* Open (const char* pFile, const char* pMode = "rb") override
+    {
+        const AssetPackEntry* entry = pack.find(pFile);
+        if (!entry || pMode[0] == 'w') return nullptr;
+
+        std::span<const unsigned char> stored = pack.stored(*entry);
+        if (!(entry->flags & ASSET_PACK_LZ4)) return new Assimp::MemoryIOStream(stored.data(), stored.size());
+
+        uint8_t* buffer = new uint8_t[entry->originalSize];
+        if (!lz4Decompress(stored.data(), stored.size(), buffer, (size_t)entry->originalSize)) {
+            delete[] buffer;
+            return nullptr;
+        }
+        return new Assimp::MemoryIOStream(buffer, (size_t)entry->originalSize, true);
+    }
+
+    void Close (Assimp::IOStream* pFile) override
+    {
+        delete pFile;
+    }
+};
+
+// Load a 3D model with Assimp and flatten every mesh of the scene into a single vertex / index list
+// Node transforms are baked into the vertices (aiProcess_PreTransformVertices), polygons are triangulated
+// ioSystem (optional, owned by the caller) replaces the file system, e.g. an AssetPackIOSystem
+inline bool loadModel (const std::string& modelFilePath, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                       Assimp::IOSystem* ioSystem = nullptr)
+{
+    Assimp::Importer importer;
+    if (ioSystem) importer.SetIOHandler(ioSystem);
+    const aiScene* scene = importer.ReadFile(modelFilePath,
+        aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
+
+    if (!scene || !scene->mRootNode || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)) {
+        std::cout << "Failed to load the model: " << modelFilePath << " " << importer.GetErrorString() << std::endl;
+        if (ioSystem) importer.SetIOHandler(nullptr);   // Hand the IO system back (the importer deletes its handler)
+        return false;
+    }
+
+    vertices.clear();
+    indices.clear();
+
+    for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        unsigned int baseVertex = (unsigned int)vertices.size();
+
+        // Vertices {position, color, texture}
+        for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+            Vertex vertex;
+            vertex.Position = glm::vec3(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+            vertex.Color = mesh->HasVertexColors(0)
+                ? glm::vec4(mesh->mColors[0][v].r, mesh->mColors[0][v].g, mesh->mColors[0][v].b, mesh->mColors[0][v].a)
+                : glm::vec4(1.0f);
+            vertex.Tex = mesh->HasTextureCoords(0)
+                ? glm::vec2(mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y)
+                : glm::vec2(0.0f);
+            vertices.push_back(vertex);
+        }
+
+        // Indices (points and lines left by the triangulation are skipped)
+        for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices != 3) continue;
+            indices.push_back(baseVertex + face.mIndices[0]);
+            indices.push_back(baseVertex + face.mIndices[1]);
+            indices.push_back(baseVertex + face.mIndices[2]);
+        }
+    }
+
+    if (ioSystem) importer.SetIOHandler(nullptr);
+    return true;
+}
+
+// Load a 3D model from an asset pack
+inline bool loadModel (const AssetPack& pack, const std::string& modelName, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+    AssetPackIOSystem ioSystem(pack);
+    return loadModel(modelName, vertices, indices, &ioSystem);
+}
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+#include <glm/ext.hpp>           // Include all GLM extensions
+
+#include "ComputeShader.h"
+#include "DrawCommand.h"
+#include "Frustum.h"
+#include "Culling.h"
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+// Hierarchical-Z occlusion culling
+// Depth pyramid: level 0 = depth buffer, level n = max of the 2x2 (3x3 on odd edges) texels of level n - 1,
+// so a texel holds the furthest depth of the pixels below it. A box whose nearest depth is further than
+// the pyramid depth of every texel its screen rectangle touches is hidden. Depth is OpenGL window depth [0, 1].
+
+// Screen rectangle of a box: pixel bounds at level 0 and nearest depth
+struct OcclusionRect {
+    int x0, y0, x1, y1;
+    float nearestDepth;
+};
+
+// Project the 8 corners of a box; false when the box crosses the near plane (treated as visible)
+inline bool occlusionProjectBox (const glm::mat4& viewProjection, const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                 int width, int height, OcclusionRect& rect)
+{
+    glm::vec2 uvMin(1.0f), uvMax(0.0f);
+    float nearest = 1.0f;
+    for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 p((corner & 1) ? boxMax.x : boxMin.x, (corner & 2) ? boxMax.y : boxMin.y, (corner & 4) ? boxMax.z : boxMin.z);
+        glm::vec4 clip = viewProjection * glm::vec4(p, 1.0f);
+        if (clip.w <= 1e-5f) return false;
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 uv = glm::vec2(ndc) * 0.5f + 0.5f;
+        uvMin = glm::min(uvMin, uv);
+        uvMax = glm::max(uvMax, uv);
+        nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+    }
+    uvMin = glm::clamp(uvMin, glm::vec2(0.0f), glm::vec2(1.0f));
+    uvMax = glm::clamp(uvMax, glm::vec2(0.0f), glm::vec2(1.0f));
+
+    rect.x0 = std::min((int)(uvMin.x * width), width - 1);
+    rect.y0 = std::min((int)(uvMin.y * height), height - 1);
+    rect.x1 = std::min((int)(uvMax.x * width), width - 1);
+    rect.y1 = std::min((int)(uvMax.y * height), height - 1);
+    rect.nearestDepth = std::max(nearest, 0.0f);
+    return true;
+}
+
+// Pyramid level where the rectangle touches at most 2x2 texels
+inline int occlusionLevel (const OcclusionRect& rect, int levelCount)
+{
+    int extent = std::max(rect.x1 - rect.x0, rect.y1 - rect.y0) + 1;
+    int level = 0;
+    while ((1 << level) < extent) level++;
+    return std::min(level, levelCount - 1);
+}
+
+// Software Occlusion: CPU depth rasterizer + Hi-Z, used without a GPU and as the reference for the GPU pass
+struct SoftwareOcclusion {
+
+    int width, height;
+    std::vector<std::vector<float>> levels;   // levels[0] = depth buffer
+    std::vector<glm::ivec2> levelSizes;
+
+    // Constructor: a small buffer is enough, occluders are big by definition
+    SoftwareOcclusion (int bufferWidth = 256, int bufferHeight = 128) : width(bufferWidth), height(bufferHeight)
+    {
+        levelSizes.push_back(glm::ivec2(width, height));
+        while (levelSizes.back().x > 1 || levelSizes.back().y > 1)
+            levelSizes.push_back(glm::max(levelSizes.back() / 2, glm::ivec2(1)));
+        levels.resize(levelSizes.size());
+        for (size_t l = 0; l < levels.size(); l++)
+            levels[l].assign((size_t)levelSizes[l].x * levelSizes[l].y, 1.0f);
+    }
+
+    void clear ()
+    {
+        std::fill(levels[0].begin(), levels[0].end(), 1.0f);
+    }
+
+    // Rasterize one clip space triangle (depth test less, pixel centers); triangles crossing the near plane are
+    // skipped, which only removes occlusion and keeps the result conservative
+    void rasterizeTriangle (const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+    {
+        if (a.w <= 1e-5f || b.w <= 1e-5f || c.w <= 1e-5f) return;
+
+        glm::vec3 s[3];
+        const glm::vec4* clip[3] = {&a, &b, &c};
+        for (int i = 0; i < 3; i++) {
+            glm::vec3 ndc = glm::vec3(*clip[i]) / clip[i]->w;
+            s[i] = glm::vec3((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height, ndc.z * 0.5f + 0.5f);
+        }
+
+        float area = (s[1].x - s[0].x) * (s[2].y - s[0].y) - (s[1].y - s[0].y) * (s[2].x - s[0].x);
+        if (std::abs(area) < 1e-8f) return;
+        float inverseArea = 1.0f / area;
+
+        int minX = std::max(0, (int)std::floor(std::min({s[0].x, s[1].x, s[2].x})));
+        int minY = std::max(0, (int)std::floor(std::min({s[0].y, s[1].y, s[2].y})));
+        int maxX = std::min(width - 1, (int)std::ceil(std::max({s[0].x, s[1].x, s[2].x})));
+        int maxY = std::min(height - 1, (int)std::ceil(std::max({s[0].y, s[1].y, s[2].y})));
+
+        float* depth = levels[0].data();
+        for (int y = minY; y <= maxY; y++) {
+            float py = y + 0.5f;
+            for (int x = minX; x <= maxX; x++) {
+                float px = x + 0.5f;
+                // Barycentrics from the edge functions (sign of the area handles both windings)
+                float w0 = ((s[2].x - s[1].x) * (py - s[1].y) - (s[2].y - s[1].y) * (px - s[1].x)) * inverseArea;
+                float w1 = ((s[0].x - s[2].x) * (py - s[2].y) - (s[0].y - s[2].y) * (px - s[2].x)) * inverseArea;
+                float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                float z = w0 * s[0].z + w1 * s[1].z + w2 * s[2].z;
+                float& stored = depth[(size_t)y * width + x];
+                if (z >= 0.0f && z < stored) stored = z;
+            }
+        }
+    }
+
+    // Rasterize an occluder mesh
+    void rasterizeMesh (const glm::mat4& modelViewProjection, const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+    {
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            rasterizeTriangle(modelViewProjection * glm::vec4(positions[indices[i]], 1.0f),
+                              modelViewProjection * glm::vec4(positions[indices[i + 1]], 1.0f),
+                              modelViewProjection * glm::vec4(positions[indices[i + 2]], 1.0f));
+    }
+
+    // Rasterize a box (e.g. the conservative inner box of a wall or building)
+    void rasterizeBox (const glm::mat4& viewProjection, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        static const unsigned int faces[36] = {
+            0, 1, 3, 0, 3, 2,  4, 6, 7, 4, 7, 5,  0, 4, 5, 0, 5, 1,
+            2, 3, 7, 2, 7, 6,  0, 2, 6, 0, 6, 4,  1, 5, 7, 1, 7, 3 };
+        glm::vec4 corners[8];
+        for (int corner = 0; corner < 8; corner++)
+            corners[corner] = viewProjection * glm::vec4((corner & 1) ? boxMax.x : boxMin.x, (corner & 2) ? boxMax.y : boxMin.y, (corner & 4) ? boxMax.z : boxMin.z, 1.0f);
+        for (int f = 0; f < 36; f += 3)
+            rasterizeTriangle(corners[faces[f]], corners[faces[f + 1]], corners[faces[f + 2]]);
+    }
+
+    // Depth pyramid (same reduction as hiz_downsample.glsl)
+    void buildHiZ ()
+    {
+        for (size_t l = 1; l < levels.size(); l++) {
+            glm::ivec2 source = levelSizes[l - 1], destination = levelSizes[l];
+            const float* src = levels[l - 1].data();
+            float* dst = levels[l].data();
+            for (int y = 0; y < destination.y; y++) {
+                int y1 = std::min(2 * y + ((y == destination.y - 1 && (source.y & 1)) ? 2 : 1), source.y - 1);
+                for (int x = 0; x < destination.x; x++) {
+                    int x1 = std::min(2 * x + ((x == destination.x - 1 && (source.x & 1)) ? 2 : 1), source.x - 1);
+                    float furthest = 0.0f;
+                    for (int sy = 2 * y; sy <= y1; sy++)
+                        for (int sx = 2 * x; sx <= x1; sx++)
+                            furthest = std::max(furthest, src[(size_t)sy * source.x + sx]);
+                    dst[(size_t)y * destination.x + x] = furthest;
+                }
+            }
+        }
+    }
+
+    // Furthest depth over a pixel rectangle read at a pyramid level
+    float furthestDepth (const OcclusionRect& rect, int level) const
+    {
+        glm::ivec2 size = levelSizes[level];
+        int x0 = std::min(rect.x0 >> level, size.x - 1), x1 = std::min(rect.x1 >> level, size.x - 1);
+        int y0 = std::min(rect.y0 >> level, size.y - 1), y1 = std::min(rect.y1 >> level, size.y - 1);
+        float furthest = 0.0f;
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+                furthest = std::max(furthest, levels[level][(size_t)y * size.x + x]);
+        return furthest;
+    }
+
+    // Hi-Z test: at most 4 texel reads (call buildHiZ first)
+    bool boxVisible (const glm::mat4& viewProjection, const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        OcclusionRect rect;
+        if (!occlusionProjectBox(viewProjection, boxMin, boxMax, width, height, rect)) return true;
+        return rect.nearestDepth <= furthestDepth(rect, occlusionLevel(rect, (int)levels.size()));
+    }
+
+    // Reference test: every pixel of the rectangle at full resolution (exact for the projected rectangle)
+    bool boxVisibleReference (const glm::mat4& viewProjection, const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        OcclusionRect rect;
+        if (!occlusionProjectBox(viewProjection, boxMin, boxMax, width, height, rect)) return true;
+        return rect.nearestDepth <= furthestDepth(rect, 0);
+    }
+};
+
+// CPU occlusion cull of the objects that passed the frustum cull (Culling.h), keeps the index order
+inline void occlusionCullObjects (const CullingBounds& bounds, const std::vector<unsigned int>& frustumVisible, const SoftwareOcclusion& occlusion,
+                                  const glm::mat4& viewProjection, std::vector<unsigned int>& visible)
+{
+    visible.clear();
+    for (unsigned int object : frustumVisible) {
+        glm::vec3 center(bounds.centerX[object], bounds.centerY[object], bounds.centerZ[object]);
+        glm::vec3 extent(bounds.extentX[object], bounds.extentY[object], bounds.extentZ[object]);
+        if (occlusion.boxVisible(viewProjection, center - extent, center + extent))
+            visible.push_back(object);
+    }
+}
+
+// Occlusion object (std430, 64 bytes): world AABB + the command that draws it
+struct OcclusionObject {
+    glm::vec4 boxMin;                         // xyz
+    glm::vec4 boxMax;                         // xyz
+    DrawElementsIndirectCommand command;
+    unsigned int padding[3];
+};
+
+static_assert(sizeof(OcclusionObject) == 64, "OcclusionObject must match the std430 layout of occlusion_cull.glsl");
+
+// GPU two phase occlusion culling
+// Frame: cullEarly (objects visible last frame) -> draw -> buildDepthPyramid -> cullLate (everything else
+// against the pyramid, updates the visibility flags) -> draw. The flags live in an SSBO across frames.
+struct HiZOcclusionPass {
+
+    ComputeShader cullShader;
+    ComputeShader downsampleShader;
+    unsigned int objectSSBO, visibilitySSBO, commandBuffer, drawCountBuffer;
+    unsigned int depthPyramid;
+    int pyramidWidth, pyramidHeight, pyramidLevels;
+    unsigned int objectCount;
+
+    // Constructor
+    HiZOcclusionPass (const std::string& cullShaderPath = "./shaders/Compute_Shader/occlusion_cull.glsl",
+                      const std::string& downsampleShaderPath = "./shaders/Compute_Shader/hiz_downsample.glsl")
+        : cullShader(cullShaderPath), downsampleShader(downsampleShaderPath),
+          depthPyramid(0), pyramidWidth(0), pyramidHeight(0), pyramidLevels(0), objectCount(0)
+    {
+        glGenBuffers(1, &objectSSBO);
+        glGenBuffers(1, &visibilitySSBO);
+        glGenBuffers(1, &commandBuffer);
+        glGenBuffers(1, &drawCountBuffer);
+    }
+
+    // Upload the objects, every visibility flag starts at 0 (first frame draws everything in phase 2)
+    void upload (const std::vector<OcclusionObject>& objects)
+    {
+        objectCount = (unsigned int)objects.size();
+        std::vector<unsigned int> flags(objects.size(), 0);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(OcclusionObject), objects.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibilitySSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, flags.size() * sizeof(unsigned int), flags.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCountBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // Depth pyramid storage (R32F, full mip chain) matching the depth buffer size
+    void resize (int width, int height)
+    {
+        if (width == pyramidWidth && height == pyramidHeight) return;
+        if (depthPyramid) glDeleteTextures(1, &depthPyramid);
+
+        pyramidWidth = width;
+        pyramidHeight = height;
+        pyramidLevels = 1;
+        while ((std::max(width, height) >> pyramidLevels) > 0) pyramidLevels++;
+
+        glGenTextures(1, &depthPyramid);
+        glBindTexture(GL_TEXTURE_2D, depthPyramid);
+        glTexStorage2D(GL_TEXTURE_2D, pyramidLevels, GL_R32F, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Phase 1: objects in the frustum that were visible last frame
+    void cullEarly (const glm::mat4& viewProjection)
+    {
+        cull(viewProjection, 0);
+    }
+
+    // Phase 2: objects that pass the Hi-Z test and were not drawn in phase 1; rewrites every visibility flag
+    void cullLate (const glm::mat4& viewProjection)
+    {
+        cull(viewProjection, 1);
+    }
+
+    void cull (const glm::mat4& viewProjection, unsigned int phase)
+    {
+        if (objectCount == 0) return;
+
+        unsigned int zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCountBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        Frustum frustum = Frustum::fromMatrix(viewProjection);
+        cullShader.bindUniformMat4("csViewProjection", glm::value_ptr(viewProjection));
+        cullShader.bindUniformVec4Array("csFrustum", glm::value_ptr(frustum.planes[0]), 6);
+        cullShader.bindUniformUint("csObjectCount", objectCount);
+        cullShader.bindUniformUint("csPhase", phase);
+        cullShader.bindUniformInt("csPyramidLevels", pyramidLevels);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, depthPyramid);
+        glBindSampler(0, 0);    // The pyramid's own nearest filtering, not a material sampler left on the unit
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibilitySSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, drawCountBuffer);
+
+        cullShader.shaderDispatch((objectCount + 63) / 64);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // Build the pyramid from a depth texture (the scene's FBO depth attachment, same size as resize())
+    void buildDepthPyramid (unsigned int depthTexture)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindSampler(0, 0);    // A mipmapped material sampler would make the single level depth texture incomplete
+        downsampleShader.bindUniformInt("csSource", 0);
+        for (int level = 0; level < pyramidLevels; level++) {
+            // Level 0 copies the depth buffer, the others reduce the level above
+            glBindTexture(GL_TEXTURE_2D, level == 0 ? depthTexture : depthPyramid);
+            downsampleShader.bindUniformInt("csSourceLevel", level == 0 ? 0 : level - 1);
+            glBindImageTexture(0, depthPyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            int levelWidth = std::max(pyramidWidth >> level, 1), levelHeight = std::max(pyramidHeight >> level, 1);
+            downsampleShader.shaderDispatch((levelWidth + 7) / 8, (levelHeight + 7) / 8);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Draw the commands written by the last cull (GL 4.6 draw count from a buffer)
+    void draw (unsigned int VAO)
+    {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBindBuffer(GL_PARAMETER_BUFFER, drawCountBuffer);
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, objectCount, 0);
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // Destructor
+    ~HiZOcclusionPass ()
+    {
+        unsigned int buffers[] = {objectSSBO, visibilitySSBO, commandBuffer, drawCountBuffer};
+        glDeleteBuffers(4, buffers);
+        if (depthPyramid) glDeleteTextures(1, &depthPyramid);
+    }
+};
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+
+#include "ShaderPreprocessor.h"  // #include / #line / dependencies
+#include "ShaderDiagnostics.h"   // Full logs, source excerpts, failure propagation
+#include "Sampler.h"
+
+#include <iostream>
+#include <string>
+#include <cstring>
+
+// Render Target
+// The scene is drawn in linear light into an offscreen float target, not into the 8 bit default framebuffer:
+// color textures are sRGB (decoded to linear by the sampler, Texture.h), lighting and blending add linear values
+// and bright values above 1 survive until the tonemap pass maps them to the display and encodes them to sRGB.
+// RGBA16F: half floats, alpha, 8 bytes per pixel. R11G11B10F: no alpha and 6 / 5 bit mantissas, 4 bytes per pixel
+// (half the bandwidth of RGBA16F). RGBA8: LDR, values clamped at 1 and banding in the darks (comparison only).
+
+enum RenderTargetFormat {
+    RENDER_TARGET_RGBA16F,
+    RENDER_TARGET_R11G11B10F,
+    RENDER_TARGET_RGBA8,
+    RENDER_TARGET_FORMAT_COUNT
+};
+
+const char* const RENDER_TARGET_FORMAT_NAMES[RENDER_TARGET_FORMAT_COUNT] = {"rgba16f", "r11g11b10f", "rgba8"};
+const unsigned int RENDER_TARGET_INTERNAL_FORMATS[RENDER_TARGET_FORMAT_COUNT] = {GL_RGBA16F, GL_R11F_G11F_B10F, GL_RGBA8};
+const unsigned int RENDER_TARGET_PIXEL_BYTES[RENDER_TARGET_FORMAT_COUNT] = {8, 4, 4};
+
+// Format from its name (command lines), false when unknown
+inline bool renderTargetFormat (const char* name, RenderTargetFormat& format)
+{
+    for (int f = 0; f < RENDER_TARGET_FORMAT_COUNT; f++)
+        if (std::strcmp(name, RENDER_TARGET_FORMAT_NAMES[f]) == 0) {
+            format = (RenderTargetFormat)f;
+            return true;
+        }
+    return false;
+}
+
+struct RenderTarget {
+
+    RenderTargetFormat format = RENDER_TARGET_RGBA16F;
+    bool depth = true;                   // Depth renderbuffer attached
+    int width = 0, height = 0;
+    unsigned int framebuffer = 0;
+    unsigned int colorTexture = 0;
+    unsigned int depthRenderbuffer = 0;
+
+    // Storage for a size (GL thread): reallocated only when the size changes (window resize), not every frame
+    bool resize (int newWidth, int newHeight)
+    {
+        if (framebuffer && newWidth == width && newHeight == height) return true;
+        release();
+        if (newWidth <= 0 || newHeight <= 0) return false;
+        width = newWidth;
+        height = newHeight;
+
+        glGenTextures(1, &colorTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, RENDER_TARGET_INTERNAL_FORMATS[format], width, height);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        if (depth) {
+            glGenRenderbuffers(1, &depthRenderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+        }
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!complete) {
+            std::cout << "Incomplete render target (" << RENDER_TARGET_FORMAT_NAMES[format] << ", " << width << "x" << height << ")" << std::endl;
+            release();
+        }
+        return complete;
+    }
+
+    // Draw into the target (whole target viewport)
+    void bind () const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, width, height);
+    }
+
+    // Color bytes written per frame (one full screen pass)
+    size_t bytes () const { return (size_t)width * height * RENDER_TARGET_PIXEL_BYTES[format]; }
+
+    // Delete the framebuffer and its attachments (GL thread, before the context is destroyed)
+    void release ()
+    {
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (colorTexture) glDeleteTextures(1, &colorTexture);
+        if (depthRenderbuffer) glDeleteRenderbuffers(1, &depthRenderbuffer);
+        framebuffer = colorTexture = depthRenderbuffer = 0;
+        width = height = 0;
+    }
+};
+
+// Tonemap
+// Last pass of the frame: a full screen triangle reads the linear target, applies the exposure and the operator and
+// writes sRGB encoded values into the bound framebuffer. The shader encodes (GL_FRAMEBUFFER_SRGB stays off): the
+// output is the same whether the default framebuffer is sRGB capable or not, and an RGBA8 readback (Headless) holds
+// exactly what a display gets.
+
+enum TonemapOperator {
+    TONEMAP_CLAMP,                       // Values above 1 clipped: LDR scenes display unchanged
+    TONEMAP_REINHARD,                    // x / (1 + x)
+    TONEMAP_ACES,                        // ACES filmic curve (Narkowicz fit)
+    TONEMAP_OPERATOR_COUNT
+};
+
+const char* const TONEMAP_OPERATOR_NAMES[TONEMAP_OPERATOR_COUNT] = {"clamp", "reinhard", "aces"};
+
+inline bool tonemapOperator (const char* name, TonemapOperator& tonemap)
+{
+    for (int t = 0; t < TONEMAP_OPERATOR_COUNT; t++)
+        if (std::strcmp(name, TONEMAP_OPERATOR_NAMES[t]) == 0) {
+            tonemap = (TonemapOperator)t;
+            return true;
+        }
+    return false;
+}
+
+struct TonemapPass {
+
+    TonemapOperator tonemap = TONEMAP_CLAMP;
+    float exposure = 1.0f;
+    unsigned int program = 0;            // 0 when the shaders failed to build (nothing drawn)
+    unsigned int VAO = 0;                // Empty: the vertex shader places the triangle from gl_VertexID
+    unsigned int sampler = 0;
+    int exposureLocation = -1, tonemapLocation = -1;
+
+    // Program and state (GL thread)
+    bool create (const std::string& vertexShaderPath = "./shaders/Vertex_Shader/fullscreen_vertex.glsl",
+                 const std::string& fragmentShaderPath = "./shaders/Fragment_Shader/tonemap_fragment.glsl")
+    {
+        ShaderResult linked = shaderLink({{GL_VERTEX_SHADER, shaderPreprocessor().preprocess(vertexShaderPath).text},
+                                          {GL_FRAGMENT_SHADER, shaderPreprocessor().preprocess(fragmentShaderPath).text}}, fragmentShaderPath);
+        program = linked.id;
+        if (!linked.success) return false;
+        exposureLocation = glGetUniformLocation(program, "fsExposure");
+        tonemapLocation = glGetUniformLocation(program, "fsTonemap");
+        glGenVertexArrays(1, &VAO);
+        sampler = samplerCache().get(samplerBilinear());
+        return true;
+    }
+
+    // Tonemap the target into the bound framebuffer (its viewport set by the caller)
+    void draw (const RenderTarget& source) const
+    {
+        if (!program || !source.colorTexture) return;
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+        glDisable(GL_FRAMEBUFFER_SRGB);
+        glUseProgram(program);
+        glUniform1f(exposureLocation, exposure);
+        glUniform1i(tonemapLocation, (int)tonemap);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source.colorTexture);
+        glBindSampler(0, sampler);
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindSampler(0, 0);
+    }
+
+    void release ()
+    {
+        if (program) glDeleteProgram(program);
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        program = VAO = sampler = 0;             // The sampler belongs to the sampler cache
+    }
+};
+
+#endif
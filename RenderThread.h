@@ -0,0 +1,180 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+#include <GLFW/glfw3.h>          // GLFW for window and context management
+#include <glm/glm.hpp>           // Include all GLM core / GLSL features
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+
+// Render Thread
+// The update thread (main thread: events, input, simulation, culling) fills a FramePacket and publishes it;
+// the render thread owns the GL context, submits the packet and swaps. Packets are ring buffered (2 = double,
+// 3 = triple), so frame N + 1 is simulated while frame N is submitted. A published packet is never written
+// again until the render thread has released it.
+
+// Per frame uniforms
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition;   // xyz
+    float time;                 // Simulation time (seconds)
+    float interpolation;        // Fraction of a fixed step between the last two simulation states
+};
+
+// One visible draw
+struct FrameDraw {
+    unsigned int object;        // Object index (culling / per object data)
+    glm::mat4 model;
+};
+
+// Frame Packet: everything the render thread needs, nothing points back into simulation state
+struct FramePacket {
+    unsigned long long frameIndex;
+    int width, height;          // Framebuffer size
+    FrameUniforms uniforms;
+    std::vector<FrameDraw> draws;
+    std::chrono::steady_clock::time_point published;
+};
+
+// Frame Packet Queue
+struct FramePacketQueue {
+
+    std::vector<FramePacket> packets;
+    unsigned long long written, read;   // Packets published / released
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    // Latency: publish -> swap of the same packet
+    double latencyLastMs, latencyAverageMs, latencyMaxMs;
+    unsigned long long latencySamples;
+
+    // Constructor: bufferCount 2 (double) or 3 (triple buffered)
+    FramePacketQueue (unsigned int bufferCount = 2)
+        : packets(std::max(2u, bufferCount)), written(0), read(0), closed(false),
+          latencyLastMs(0.0), latencyAverageMs(0.0), latencyMaxMs(0.0), latencySamples(0) {}
+
+    // Update thread: slot for the next packet, waits while every slot is queued or being rendered
+    FramePacket* beginWrite ()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return closed || written - read < packets.size(); });
+        if (closed) return nullptr;
+        FramePacket* packet = &packets[written % packets.size()];
+        packet->frameIndex = written;
+        packet->draws.clear();   // Keeps the capacity: no allocation in steady state
+        return packet;
+    }
+
+    void endWrite ()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        packets[written % packets.size()].published = std::chrono::steady_clock::now();
+        written++;
+        changed.notify_all();
+    }
+
+    // Render thread: oldest unrendered packet, nullptr once closed
+    const FramePacket* beginRead ()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return closed || read < written; });
+        if (read == written) return nullptr;
+        return &packets[read % packets.size()];
+    }
+
+    // Release the packet after the swap and record its latency
+    void endRead ()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const FramePacket& packet = packets[read % packets.size()];
+        latencyLastMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packet.published).count();
+        latencySamples++;
+        latencyAverageMs += (latencyLastMs - latencyAverageMs) / (double)std::min<unsigned long long>(latencySamples, 120);
+        latencyMaxMs = std::max(latencyMaxMs, latencyLastMs);
+        read++;
+        changed.notify_all();
+    }
+
+    void close ()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        changed.notify_all();
+    }
+
+    // Latency (ms): last, moving average over ~120 frames, max; resetMax starts a new measurement window
+    void latency (double& last, double& average, double& maximum, bool resetMax = false)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = latencyLastMs;
+        average = latencyAverageMs;
+        maximum = latencyMaxMs;
+        if (resetMax) latencyMaxMs = 0.0;
+    }
+};
+
+// Render Thread
+struct RenderThread {
+
+    GLFWwindow* window;
+    FramePacketQueue& queue;
+    std::function<void(const FramePacket&)> render;
+    std::thread thread;
+    std::atomic<int> swapInterval;   // glfwSwapInterval of the render thread's context (see swapModeInterval), changes apply at the next frame
+
+    // Constructor: render is called on the render thread with the context current, before the swap
+    RenderThread (GLFWwindow* renderWindow, FramePacketQueue& packetQueue, std::function<void(const FramePacket&)> renderFunction)
+        : window(renderWindow), queue(packetQueue), render(renderFunction), swapInterval(1) {}
+
+    // Hand the context over to the render thread (GL objects created so far stay valid: same context)
+    void start ()
+    {
+        glfwMakeContextCurrent(nullptr);
+        thread = std::thread([this]() { renderLoop(); });
+    }
+
+    void renderLoop ()
+    {
+        glfwMakeContextCurrent(window);
+        int appliedInterval = swapInterval.load(std::memory_order_relaxed);
+        glfwSwapInterval(appliedInterval);
+        while (const FramePacket* packet = queue.beginRead()) {
+            // Swap mode switched by the update thread
+            int interval = swapInterval.load(std::memory_order_relaxed);
+            if (interval != appliedInterval) {
+                glfwSwapInterval(interval);
+                appliedInterval = interval;
+            }
+            render(*packet);
+            glfwSwapBuffers(window);
+            queue.endRead();
+        }
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    // Stop after the queued packets and give the context back to the calling thread (GL cleanup)
+    void stop ()
+    {
+        queue.close();
+        if (thread.joinable()) thread.join();
+        glfwMakeContextCurrent(window);
+    }
+
+    // Destructor
+    ~RenderThread ()
+    {
+        if (thread.joinable()) stop();
+    }
+};
+
+#endif
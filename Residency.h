@@ -0,0 +1,408 @@
+#ifndef RESIDENCY_H
+#define RESIDENCY_H
+
+#include <GL/glew.h>                  // GLEW for OpenGL functions
+#include <glm/glm.hpp>
+
+#include "AsyncIO.h"
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include "Texture.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <span>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Residency
+// Keeps the loaded resources inside a memory budget: every resource is registered once with the file (or pack
+// entry) it streams from, the update thread requests the ones it needs each frame with a priority (distance and
+// screen size), and update() on the GL thread uploads finished loads, starts the most important missing ones
+// (AsyncIO read + decode on the job system) and evicts the least recently used resources while a budget is exceeded.
+// An evicted resource keeps its record: the next request streams it in again.
+
+typedef unsigned int ResidencyID;
+const ResidencyID RESIDENCY_NONE = ~0u;
+
+enum ResidencyCategory {
+    RESIDENCY_TEXTURE,
+    RESIDENCY_MESH,
+    RESIDENCY_BUFFER,
+    RESIDENCY_DATA,           // CPU side data (collision, BVH, audio ...): kept in RAM, no GL object
+    RESIDENCY_CATEGORY_COUNT
+};
+
+enum ResidencyMemory {
+    RESIDENCY_VRAM,
+    RESIDENCY_RAM,
+    RESIDENCY_MEMORY_COUNT
+};
+
+enum ResidencyState {
+    RESIDENCY_EVICTED,        // Not loaded (registered, never requested or evicted)
+    RESIDENCY_LOADING,        // Read / decode in flight
+    RESIDENCY_RESIDENT,
+    RESIDENCY_FAILED          // Read or decode failed: not retried
+};
+
+const char* const RESIDENCY_CATEGORY_NAMES[RESIDENCY_CATEGORY_COUNT] = {"Textures", "Meshes", "Buffers", "Data"};
+
+// Decoded resource data: filled on a job thread, consumed by the upload on the GL thread
+struct ResidencyData {
+    std::vector<unsigned char> bytes;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+};
+
+// Loader: how a category of resources is decoded, created and destroyed
+// decode: job thread, encoded file bytes -> data
+// upload: GL thread, data -> GL object, sets the resident size in bytes (null: the data itself stays in RAM)
+// destroy: GL thread, deletes the GL object
+struct ResidencyLoader {
+    std::function<bool(std::span<const unsigned char> encoded, ResidencyData& data)> decode;
+    std::function<unsigned int(ResidencyData& data, size_t& size)> upload;
+    std::function<void(unsigned int handle)> destroy;
+};
+
+// Resource record
+struct ResidencyResource {
+    std::string name;                      // File path / asset pack name streamed from
+    ResidencyCategory category;
+    ResidencyMemory memory;
+    const ResidencyLoader* loader;
+    bool pinned;                           // Never evicted
+
+    // GL thread
+    ResidencyState state = RESIDENCY_EVICTED;
+    unsigned int handle = 0;               // GL object while resident
+    size_t size = 0;                       // Resident bytes (last known size once evicted)
+    ResidencyData data;                    // RAM resources: the decoded data
+    unsigned int loads = 0;                // Times streamed in (> 1: re-streamed after an eviction)
+
+    // Requests (update thread): last frame it was needed and the highest priority asked for that frame
+    std::atomic<unsigned long long> lastUsedFrame{0};
+    std::atomic<float> priority{0.0f};
+    std::atomic<bool> requested{false};    // Requested at least once (frame 0 is a valid frame)
+};
+
+// Priority from distance and projected size: [1, 2) visible, [0, 1) not visible (prefetch), larger on screen first
+// screenSize: bounding sphere radius over the half height of the view at that distance (1 = fills the screen)
+inline float residencyScreenSize (const glm::vec3& center, float radius, const glm::vec3& cameraPosition, float fovY)
+{
+    float distance = std::max(glm::length(center - cameraPosition) - radius, 0.01f);
+    return radius / (distance * std::tan(fovY * 0.5f));
+}
+
+inline float residencyPriority (const glm::vec3& center, float radius, const glm::vec3& cameraPosition, float fovY, bool visible)
+{
+    float screenSize = std::min(residencyScreenSize(center, radius, cameraPosition, fovY), 1.0f);
+    return (visible ? 1.0f : 0.0f) + screenSize * 0.999f;
+}
+
+// Read priority of a load: visible first, then large on screen, then the prefetches
+inline AsyncIOPriority residencyIOPriority (float priority)
+{
+    if (priority >= 1.0f) return IO_PRIORITY_VISIBLE;
+    if (priority >= 0.1f) return IO_PRIORITY_NORMAL;
+    return IO_PRIORITY_PREFETCH;
+}
+
+// Texture loader: image decode (ImageDecoder.h) on the job thread straight into the resource data (large images split
+// over the other job threads), GL texture (+ mipmaps, 4/3 of the base level) on the GL thread, sRGB for color images
+inline ResidencyLoader textureResidencyLoader (bool srgb = true)
+{
+    ResidencyLoader loader;
+    loader.decode = [](std::span<const unsigned char> encoded, ResidencyData& data) {
+        int width, height, channels;
+        if (!imageInfo(encoded.data(), encoded.size(), width, height, channels)) return false;
+        channels = textureChannels(channels);
+        data.bytes.resize((size_t)width * height * channels);
+        if (!decodeImageInto(encoded.data(), encoded.size(), data.bytes.data(), (size_t)width * channels, channels)) return false;
+        data.width = width;
+        data.height = height;
+        data.channels = channels;
+        return true;
+    };
+    loader.upload = [srgb](ResidencyData& data, size_t& size) {
+        unsigned int textureID = createTexture();
+        uploadTexture(data.bytes.data(), data.width, data.height, data.channels, srgb);
+        size_t texelBytes = (data.channels == 4) ? 4 : 3;
+        size = (size_t)data.width * data.height * texelBytes * 4 / 3;
+        return textureID;
+    };
+    loader.destroy = [](unsigned int handle) { glDeleteTextures(1, &handle); };
+    return loader;
+}
+
+struct Residency {
+    size_t budgets[RESIDENCY_MEMORY_COUNT];
+    unsigned int maxLoads = 8;             // Loads in flight
+    const AssetPack* pack = nullptr;       // Entries found in the pack are decoded from the mapping (no file read)
+
+    // Records: deque, so the addresses stay valid while more are added
+    std::deque<ResidencyResource> resources;
+
+    // Finished decodes, uploaded by the next update()
+    std::mutex completedMutex;
+    std::vector<std::pair<ResidencyID, ResidencyData>> completed;
+    std::vector<std::pair<ResidencyID, ResidencyData>> uploads;
+    std::atomic<unsigned int> loading{0};
+
+    // Statistics (GL thread)
+    unsigned long long evictions = 0;
+    unsigned long long restreams = 0;
+    bool overBudget[RESIDENCY_MEMORY_COUNT] = {};   // Budget still exceeded after evicting everything unused this frame
+    std::atomic<bool> reportRequested{false};
+
+    // Reused each update (no allocation once grown)
+    std::vector<ResidencyID> candidates;
+
+    // Constructor: budgets in bytes
+    Residency (size_t vramBudget = 512ull << 20, size_t ramBudget = 256ull << 20)
+    {
+        budgets[RESIDENCY_VRAM] = vramBudget;
+        budgets[RESIDENCY_RAM] = ramBudget;
+        asyncIO();   // Constructed first: outlives this object (loads in flight at exit)
+    }
+
+    // Destructor: the GL objects are deleted by clear() on the GL thread, only the loads in flight are waited for
+    ~Residency () { waitLoads(); }
+
+    // Register a resource (not loaded until requested); loaders without upload keep the data in RAM
+    // Registration is not synchronized with requests / loads: add the resources at load time, before the frame loop
+    ResidencyID add (const std::string& name, ResidencyCategory category, const ResidencyLoader* loader, bool pinned = false)
+    {
+        ResidencyResource& resource = resources.emplace_back();
+        resource.name = name;
+        resource.category = category;
+        resource.memory = loader->upload ? RESIDENCY_VRAM : RESIDENCY_RAM;
+        resource.loader = loader;
+        resource.pinned = pinned;
+        return (ResidencyID)resources.size() - 1;
+    }
+
+    // Request a resource for a frame (any thread): keeps the latest frame and the highest priority asked for it
+    // (a late request for an older frame changes nothing)
+    void request (ResidencyID id, unsigned long long frame, float priority)
+    {
+        ResidencyResource& resource = resources[id];
+        bool first = !resource.requested.exchange(true, std::memory_order_relaxed);
+        unsigned long long last = resource.lastUsedFrame.load(std::memory_order_relaxed);
+        while (last < frame && !resource.lastUsedFrame.compare_exchange_weak(last, frame, std::memory_order_relaxed)) {}
+        if (last < frame || first) {
+            resource.priority.store(priority, std::memory_order_relaxed);
+            return;
+        }
+        if (last > frame) return;
+        float current = resource.priority.load(std::memory_order_relaxed);
+        while (priority > current && !resource.priority.compare_exchange_weak(current, priority, std::memory_order_relaxed)) {}
+    }
+
+    // GL object of a resource (GL thread), 0 while it is not resident
+    unsigned int handle (ResidencyID id) const
+    {
+        const ResidencyResource& resource = resources[id];
+        return resource.state == RESIDENCY_RESIDENT ? resource.handle : 0;
+    }
+
+    // Data of a RAM resource (GL thread), null while it is not resident
+    const ResidencyData* data (ResidencyID id) const
+    {
+        const ResidencyResource& resource = resources[id];
+        return resource.state == RESIDENCY_RESIDENT ? &resource.data : nullptr;
+    }
+
+    bool resident (ResidencyID id) const { return resources[id].state == RESIDENCY_RESIDENT; }
+
+    // Resident bytes of a memory / category
+    size_t used (ResidencyMemory memory) const
+    {
+        size_t bytes = 0;
+        for (const ResidencyResource& resource : resources)
+            if (resource.state == RESIDENCY_RESIDENT && resource.memory == memory) bytes += resource.size;
+        return bytes;
+    }
+
+    // Frame (GL thread): upload finished loads, start the missing requests of this frame, evict down to the budgets
+    // The update thread runs ahead (frame packets): requests for this frame or a later one count as this frame's
+    void update (unsigned long long frame)
+    {
+        // Uploads
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            uploads.swap(completed);
+        }
+        for (std::pair<ResidencyID, ResidencyData>& upload : uploads) {
+            ResidencyResource& resource = resources[upload.first];
+            if (upload.second.bytes.empty()) {
+                resource.state = RESIDENCY_FAILED;
+                std::cout << "Residency: failed to load " << resource.name << std::endl;
+                continue;
+            }
+            if (resource.loader->upload) {
+                resource.handle = resource.loader->upload(upload.second, resource.size);
+            } else {
+                resource.data = std::move(upload.second);
+                resource.size = resource.data.bytes.size();
+            }
+            resource.state = RESIDENCY_RESIDENT;
+            if (resource.loads++ > 0) restreams++;
+        }
+        uploads.clear();
+
+        // Loads: requested this frame and not resident, highest priority first
+        candidates.clear();
+        for (ResidencyID id = 0; id < (ResidencyID)resources.size(); id++) {
+            ResidencyResource& resource = resources[id];
+            if (resource.state == RESIDENCY_EVICTED && requestedIn(resource, frame)) candidates.push_back(id);
+        }
+        std::sort(candidates.begin(), candidates.end(), [this](ResidencyID a, ResidencyID b) {
+            return resources[a].priority.load(std::memory_order_relaxed) > resources[b].priority.load(std::memory_order_relaxed);
+        });
+        for (ResidencyID id : candidates) {
+            if (loading.load(std::memory_order_relaxed) >= maxLoads) break;
+            load(id);
+        }
+
+        // Evictions: least recently used first (lowest priority on ties), never what this frame or a later one uses
+        for (int memory = 0; memory < RESIDENCY_MEMORY_COUNT; memory++) {
+            size_t bytes = used((ResidencyMemory)memory);
+            overBudget[memory] = false;
+            if (bytes <= budgets[memory]) continue;
+
+            candidates.clear();
+            for (ResidencyID id = 0; id < (ResidencyID)resources.size(); id++) {
+                ResidencyResource& resource = resources[id];
+                if (resource.memory == memory && resource.state == RESIDENCY_RESIDENT && !resource.pinned && !requestedIn(resource, frame))
+                    candidates.push_back(id);
+            }
+            std::sort(candidates.begin(), candidates.end(), [this](ResidencyID a, ResidencyID b) {
+                unsigned long long usedA = resources[a].lastUsedFrame.load(std::memory_order_relaxed);
+                unsigned long long usedB = resources[b].lastUsedFrame.load(std::memory_order_relaxed);
+                if (usedA != usedB) return usedA < usedB;
+                return resources[a].priority.load(std::memory_order_relaxed) < resources[b].priority.load(std::memory_order_relaxed);
+            });
+            for (ResidencyID id : candidates) {
+                if (bytes <= budgets[memory]) break;
+                bytes -= resources[id].size;
+                evict(id);
+            }
+            overBudget[memory] = bytes > budgets[memory];
+        }
+
+        if (reportRequested.exchange(false, std::memory_order_relaxed)) report();
+    }
+
+    // Evict a resource (GL thread): GL object / data released, the record stays for a later re-stream
+    void evict (ResidencyID id)
+    {
+        ResidencyResource& resource = resources[id];
+        if (resource.state != RESIDENCY_RESIDENT) return;
+        if (resource.handle && resource.loader->destroy) resource.loader->destroy(resource.handle);
+        resource.handle = 0;
+        resource.data = ResidencyData();
+        resource.state = RESIDENCY_EVICTED;
+        evictions++;
+    }
+
+    // Release everything (GL thread, before the context is destroyed)
+    void clear ()
+    {
+        waitLoads();
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.clear();
+        }
+        for (ResidencyID id = 0; id < (ResidencyID)resources.size(); id++) {
+            evict(id);
+            if (resources[id].state == RESIDENCY_LOADING) resources[id].state = RESIDENCY_EVICTED;
+        }
+    }
+
+    // Debug report: budget usage per memory, resident / total resources and bytes per category
+    void report () const
+    {
+        const char* memoryNames[RESIDENCY_MEMORY_COUNT] = {"VRAM", "RAM"};
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Residency: " << resources.size() << " resources, " << evictions << " evictions, " << restreams << " re-streams" << std::endl;
+        for (int memory = 0; memory < RESIDENCY_MEMORY_COUNT; memory++) {
+            size_t bytes = used((ResidencyMemory)memory);
+            std::cout << "  " << std::left << std::setw(10) << memoryNames[memory] << std::right
+                      << std::setw(9) << bytes / 1048576.0 << " / " << budgets[memory] / 1048576.0 << " MB ("
+                      << (budgets[memory] ? 100.0 * bytes / budgets[memory] : 0.0) << "%)" << (overBudget[memory] ? " over budget" : "") << std::endl;
+        }
+        for (int category = 0; category < RESIDENCY_CATEGORY_COUNT; category++) {
+            unsigned int count = 0, residentCount = 0, loadingCount = 0;
+            size_t bytes = 0;
+            for (const ResidencyResource& resource : resources) {
+                if (resource.category != category) continue;
+                count++;
+                if (resource.state == RESIDENCY_LOADING) loadingCount++;
+                if (resource.state == RESIDENCY_RESIDENT) {
+                    residentCount++;
+                    bytes += resource.size;
+                }
+            }
+            if (count == 0) continue;
+            std::cout << "  " << std::left << std::setw(10) << RESIDENCY_CATEGORY_NAMES[category] << std::right
+                      << std::setw(9) << bytes / 1048576.0 << " MB, " << residentCount << " / " << count << " resident, "
+                      << loadingCount << " loading" << std::endl;
+        }
+    }
+
+    // Internal
+    bool requestedIn (const ResidencyResource& resource, unsigned long long frame) const
+    {
+        return resource.requested.load(std::memory_order_relaxed) && resource.lastUsedFrame.load(std::memory_order_relaxed) >= frame;
+    }
+
+    // Start a load: pack entries are decoded from the mapping on a job, files are read by AsyncIO first
+    void load (ResidencyID id)
+    {
+        ResidencyResource& resource = resources[id];
+        resource.state = RESIDENCY_LOADING;
+        loading.fetch_add(1, std::memory_order_relaxed);
+
+        if (pack && pack->contains(resource.name)) {
+            jobSystem().run([this, id]() {
+                std::vector<unsigned char> buffer;
+                finish(id, pack->read(resources[id].name, buffer));
+            });
+            return;
+        }
+        float priority = resource.priority.load(std::memory_order_relaxed);
+        asyncIO().read(resource.name, residencyIOPriority(priority), [this, id](AsyncReadResult& result) {
+            finish(id, result.success ? std::span<const unsigned char>(result.data) : std::span<const unsigned char>());
+        });
+    }
+
+    // Job thread: decode and queue the upload (empty data = failed)
+    void finish (ResidencyID id, std::span<const unsigned char> encoded)
+    {
+        ResidencyData data;
+        if (encoded.empty() || !resources[id].loader->decode(encoded, data)) data.bytes.clear();
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.emplace_back(id, std::move(data));
+        }
+        loading.fetch_sub(1, std::memory_order_release);
+    }
+
+    void waitLoads ()
+    {
+        while (loading.load(std::memory_order_acquire) > 0)
+            if (!jobSystem().help()) std::this_thread::yield();
+    }
+};
+
+#endif
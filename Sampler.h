@@ -0,0 +1,139 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <GL/glew.h>                  // GLEW for OpenGL functions
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+// Sampler Objects
+// Filtering and wrapping live in GL sampler objects bound per texture unit (glBindSampler), not in every texture:
+// one sampler per distinct state, created on first use and shared by every material sampling with it (SamplerCache).
+// A bound sampler overrides the parameters of the texture, a unit without one (0) samples with the texture's own.
+// Mipmapped textures are sampled trilinear: minified texels come from the mip level matching their footprint, so
+// neighbouring pixels read neighbouring texels (texture cache hits) instead of scattered texels of the base level,
+// and anisotropic filtering keeps surfaces at grazing angles sharp.
+
+struct SamplerState {
+    int minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    int magFilter = GL_LINEAR;
+    int wrapS = GL_REPEAT;
+    int wrapT = GL_REPEAT;
+    int wrapR = GL_REPEAT;
+    float maxAnisotropy = 1.0f;       // 1: isotropic, clamped to the driver limit
+    float lodBias = 0.0f;
+    float minLod = -1000.0f;
+    float maxLod = 1000.0f;
+    int compareMode = GL_NONE;        // GL_COMPARE_REF_TO_TEXTURE: depth comparison (shadow maps)
+    int compareFunc = GL_LEQUAL;
+
+    bool operator== (const SamplerState&) const = default;
+};
+
+// Presets
+// Point: nearest texel, no mips (pixel exact lookups, UI)
+inline SamplerState samplerPoint (int wrap = GL_CLAMP_TO_EDGE)
+{
+    SamplerState state;
+    state.minFilter = GL_NEAREST;
+    state.magFilter = GL_NEAREST;
+    state.wrapS = state.wrapT = state.wrapR = wrap;
+    return state;
+}
+
+// Bilinear: no mips (render targets sampled at their own size, post-processing)
+inline SamplerState samplerBilinear (int wrap = GL_CLAMP_TO_EDGE)
+{
+    SamplerState state;
+    state.minFilter = GL_LINEAR;
+    state.wrapS = state.wrapT = state.wrapR = wrap;
+    return state;
+}
+
+// Trilinear: bilinear in the two nearest mip levels, blended
+inline SamplerState samplerTrilinear (int wrap = GL_REPEAT)
+{
+    SamplerState state;
+    state.wrapS = state.wrapT = state.wrapR = wrap;
+    return state;
+}
+
+// Anisotropic: trilinear + up to anisotropy samples along the footprint (2, 4, 8, 16)
+inline SamplerState samplerAnisotropic (float anisotropy = 8.0f, int wrap = GL_REPEAT)
+{
+    SamplerState state = samplerTrilinear(wrap);
+    state.maxAnisotropy = anisotropy;
+    return state;
+}
+
+// Anisotropic filtering: core in GL 4.6, ARB / EXT extension before
+inline bool samplerAnisotropySupported ()
+{
+    return GLEW_VERSION_4_6 || GLEW_ARB_texture_filter_anisotropic || GLEW_EXT_texture_filter_anisotropic;
+}
+
+struct SamplerCache {
+
+    std::vector<std::pair<SamplerState, unsigned int>> samplers;
+    float anisotropy = 8.0f;              // Default sampler level (quality setting), before the first defaultSampler()
+    float anisotropyLimit = 0.0f;         // Driver limit, queried with the first sampler (1: not supported)
+    unsigned int defaultID = 0;
+
+    // Sampler of a state (GL thread): created the first time the state is asked for, shared afterwards
+    unsigned int get (const SamplerState& requested)
+    {
+        if (anisotropyLimit == 0.0f) {
+            anisotropyLimit = 1.0f;
+            if (samplerAnisotropySupported()) glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &anisotropyLimit);
+        }
+        SamplerState state = requested;
+        state.maxAnisotropy = std::clamp(state.maxAnisotropy, 1.0f, anisotropyLimit);
+
+        for (const std::pair<SamplerState, unsigned int>& sampler : samplers)
+            if (sampler.first == state) return sampler.second;
+
+        unsigned int samplerID;
+        glGenSamplers(1, &samplerID);
+        glSamplerParameteri(samplerID, GL_TEXTURE_MIN_FILTER, state.minFilter);
+        glSamplerParameteri(samplerID, GL_TEXTURE_MAG_FILTER, state.magFilter);
+        glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_S, state.wrapS);
+        glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_T, state.wrapT);
+        glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_R, state.wrapR);
+        glSamplerParameterf(samplerID, GL_TEXTURE_LOD_BIAS, state.lodBias);
+        glSamplerParameterf(samplerID, GL_TEXTURE_MIN_LOD, state.minLod);
+        glSamplerParameterf(samplerID, GL_TEXTURE_MAX_LOD, state.maxLod);
+        glSamplerParameteri(samplerID, GL_TEXTURE_COMPARE_MODE, state.compareMode);
+        glSamplerParameteri(samplerID, GL_TEXTURE_COMPARE_FUNC, state.compareFunc);
+        if (anisotropyLimit > 1.0f) glSamplerParameterf(samplerID, GL_TEXTURE_MAX_ANISOTROPY, state.maxAnisotropy);
+        samplers.push_back({state, samplerID});
+        return samplerID;
+    }
+
+    // Sampler of the materials that don't pick one: anisotropic, repeating
+    unsigned int defaultSampler ()
+    {
+        if (!defaultID) defaultID = get(samplerAnisotropic(anisotropy));
+        return defaultID;
+    }
+
+    // Delete every sampler (GL thread, before the context is destroyed)
+    void release ()
+    {
+        for (const std::pair<SamplerState, unsigned int>& sampler : samplers) glDeleteSamplers(1, &sampler.second);
+        samplers.clear();
+        defaultID = 0;
+        anisotropyLimit = 0.0f;
+    }
+
+    size_t size () const { return samplers.size(); }
+};
+
+// Shared sampler cache (materials, bindless handles, texture arrays)
+inline SamplerCache& samplerCache ()
+{
+    static SamplerCache cache;
+    return cache;
+}
+
+#endif
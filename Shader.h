@@ -8,6 +8,9 @@
 #include <glm/ext.hpp>           // Include all GLM extensions
 #include <assimp/assimp_functions.h>  // Include specific assimp functions
 
+#include "ShaderPreprocessor.h"  // #include / #line / dependencies
+#include "ShaderDiagnostics.h"   // Full logs, source excerpts, failure propagation
+
 #include <iostream>
 #include <vector>
 #include <string>
@@ -28,8 +31,10 @@ struct Shader {
     std::vector<int> indices;
     std::string vertexShader;
     std::string fragmentShader;
-    unsigned int shaderProgramID;
+    std::string shaderName;              // Fragment shader path (logs)
+    unsigned int shaderProgramID;        // 0 when the program failed to build
     unsigned int VAO, VBO, EBO;
+    std::vector<std::pair<std::string, int>> uniformLocations;   // Cleared when the program is relinked
 
     // Constructor
     Shader (const std::string& vertexShaderPath, const std::string fragmentShaderPath) : shaderProgramID(0), VBO(0), VAO(0) 
@@ -37,6 +42,7 @@ struct Shader {
         // Read shaders
         vertexShader = shaderRead(vertexShaderPath);
         fragmentShader = shaderRead(fragmentShaderPath);
+        shaderName = fragmentShaderPath;
 
         // Intialize vertices with vertex data {position, color, texture} = Input for the Vertex Shader
         vertices = 
@@ -57,68 +63,19 @@ struct Shader {
         shaderBuffer();
     }
 
-    // Reader
+    // Reader: source with its #includes resolved (memoized by the shared preprocessor)
     std::string shaderRead (const std::string& filePath)
     {
-        std::ifstream shaderFile(filePath);  
-        std::stringstream shaderString;
-        shaderString << shaderFile.rdbuf(); 
-        return shaderString.str();           
+        return shaderPreprocessor().preprocess(filePath).text;
     }
 
-    // Compiler
-    unsigned int shaderCompile (unsigned int shaderType, const std::string& shaderSourceCode)
+    // Program: 0 when a stage does not compile or the program does not link (the log points at the source lines)
+    bool shaderProgram () 
     {
-        // Shader Creation
-        unsigned int shaderID = glCreateShader(shaderType);
-
-        // Read the shader source code
-        const char* shaderSourceCodeCstr = shaderSourceCode.c_str();
-
-        // Assigns the shader source code to the shader object identified by shaderID
-        glShaderSource(shaderID, 1, &shaderSourceCodeCstr, nullptr);
-
-        // Compile the shader source code into machine GPU code
-        glCompileShader(shaderID);
-
-        // Compilation error log
-        int success;
-        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
-        if (!success) 
-        {
-            char infoLog[512];
-            glGetShaderInfoLog(shaderID, 512, nullptr, infoLog);
-            std::cout << "Error compiling shader: " << infoLog << std::endl;
-        }
-
-        // The function returns the shader's unique identifier
-        return shaderID;
-    }
-
-    void shaderProgram () 
-    {
-        // Compile the vertex and fragment shader
-        unsigned int vertexShaderID = shaderCompile(GL_VERTEX_SHADER, vertexShader);
-        unsigned int fragmentShaderID = shaderCompile(GL_FRAGMENT_SHADER, fragmentShader);
-
-        // Link the unique identifiers of the vertex and fragment shaders to the shaderProgramID
-        shaderProgramID = glCreateProgram();
-        glAttachShader(shaderProgramID, vertexShaderID);
-        glAttachShader(shaderProgramID, fragmentShaderID);
-        glLinkProgram(shaderProgramID);
-
-        // Linking error log
-        int success;
-        glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetProgramInfoLog(shaderProgramID, 512, nullptr, infoLog);
-            std::cout << "Error linking shader program: " << infoLog << std::endl;
-        }
-
-        glDeleteShader(vertexShaderID);
-        glDeleteShader(fragmentShaderID);
-
+        uniformLocations.clear();
+        ShaderResult program = shaderLink({{GL_VERTEX_SHADER, vertexShader}, {GL_FRAGMENT_SHADER, fragmentShader}}, shaderName);
+        shaderProgramID = program.id;
+        return program.success;
     }
 
     void shaderBuffer () 
@@ -167,20 +124,36 @@ struct Shader {
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
     }
 
+    // Uniform Location: looked up once per name, then served from the cache (no std::string, no GL query per call)
+    int uniformLocation(const char* name)
+    {
+        for (const std::pair<std::string, int>& uniform : uniformLocations)
+            if (uniform.first == name) return uniform.second;
+        int location = glGetUniformLocation(shaderProgramID, name);
+        uniformLocations.push_back({name, location});
+        return location;
+    }
+
     // Bind Uniform 1D
-    void bindUniformBool(const std::string& name, bool value)
+    void bindUniformBool(const char* name, bool value)
     {         
-        glUniform1i(glGetUniformLocation(shaderProgramID, name.c_str()), (int)value); 
+        glUniform1i(uniformLocation(name), (int)value); 
     }
 
-    void bindUniformInt(const std::string& name, int value)
+    void bindUniformInt(const char* name, int value)
     { 
-        glUniform1i(glGetUniformLocation(shaderProgramID, name.c_str()), value); 
+        glUniform1i(uniformLocation(name), value); 
     }
 
-    void bindUniformFloat(const std::string& name, float value)
+    void bindUniformFloat(const char* name, float value)
     { 
-        glUniform1f(glGetUniformLocation(shaderProgramID, name.c_str()), value); 
+        glUniform1f(uniformLocation(name), value); 
+    }
+
+    // Bind Uniform Matrix
+    void bindUniformMat4(const char* name, const glm::mat4& value)
+    {
+        glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
     }
 
     // Destructor
@@ -0,0 +1,160 @@
+#ifndef SHADER_COMPILER_H
+#define SHADER_COMPILER_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+
+#include "ShaderDiagnostics.h"   // Full logs, source excerpts
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+// Shader Compiler
+// Asynchronous program builds with KHR_parallel_shader_compile (or the ARB version): every program is compiled
+// and linked up front without reading a status back (any status query waits for the driver), the driver compiles
+// them on its own threads (glMaxShaderCompilerThreadsKHR) and poll() asks GL_COMPLETION_STATUS_KHR, which never
+// blocks, once per frame. A program is usable as soon as it is done, so many programs take about as long as the
+// slowest one instead of the sum of all.
+// Without the extension the same calls work, poll() then waits for the programs it checks.
+
+enum ShaderCompileState {
+    SHADER_COMPILE_PENDING,
+    SHADER_COMPILE_READY,
+    SHADER_COMPILE_FAILED
+};
+
+// One program build
+struct ShaderCompileJob {
+    std::string name;
+    unsigned int program;
+    std::vector<unsigned int> shaders;
+    std::vector<std::string> sources;        // Until completion (log excerpts)
+    ShaderCompileState state;
+    std::string log;                         // Compile + link log with source excerpts
+    std::chrono::steady_clock::time_point submitted;
+    double compileMs;      // Submit -> completion seen by poll()
+};
+
+struct ShaderCompiler {
+
+    bool parallel = false;                  // KHR / ARB_parallel_shader_compile present
+    std::vector<ShaderCompileJob> jobs;     // Index = ticket
+    std::vector<unsigned int> pendingJobs;
+
+    // Setup on the context that compiles (the thread limit is context state): 0xFFFFFFFF = implementation chosen
+    void setup (unsigned int threads = 0xFFFFFFFF)
+    {
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(threads);
+            parallel = true;
+        } else if (GLEW_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(threads);
+            parallel = true;
+        }
+    }
+
+    // Submit a program: {stage, source} pairs (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_COMPUTE_SHADER ...), returns the ticket
+    unsigned int submit (const std::vector<std::pair<unsigned int, std::string>>& stages, const std::string& name)
+    {
+        ShaderCompileJob job;
+        job.name = name;
+        job.program = glCreateProgram();
+        job.state = SHADER_COMPILE_PENDING;
+        job.submitted = std::chrono::steady_clock::now();
+        job.compileMs = 0.0;
+
+        for (const std::pair<unsigned int, std::string>& stage : stages) {
+            unsigned int shaderID = glCreateShader(stage.first);
+            const char* sourceCstr = stage.second.c_str();
+            glShaderSource(shaderID, 1, &sourceCstr, nullptr);
+            glCompileShader(shaderID);
+            glAttachShader(job.program, shaderID);
+            job.shaders.push_back(shaderID);
+            job.sources.push_back(stage.second);
+        }
+        // Linked right away: the link is queued behind the compiles
+        glLinkProgram(job.program);
+
+        jobs.push_back(std::move(job));
+        pendingJobs.push_back((unsigned int)jobs.size() - 1);
+        return (unsigned int)jobs.size() - 1;
+    }
+
+    unsigned int submit (const std::string& vertexSource, const std::string& fragmentSource, const std::string& name)
+    {
+        return submit({{GL_VERTEX_SHADER, vertexSource}, {GL_FRAGMENT_SHADER, fragmentSource}}, name);
+    }
+
+    // Check the pending programs (once per frame): finished ones become ready or failed, returns how many finished
+    unsigned int poll ()
+    {
+        unsigned int finished = 0;
+        for (size_t p = 0; p < pendingJobs.size();) {
+            ShaderCompileJob& job = jobs[pendingJobs[p]];
+            if (parallel) {
+                int complete = GL_FALSE;
+                glGetProgramiv(job.program, GL_COMPLETION_STATUS_KHR, &complete);
+                if (!complete) {
+                    p++;
+                    continue;
+                }
+            }
+            complete(job);
+            pendingJobs[p] = pendingJobs.back();
+            pendingJobs.pop_back();
+            finished++;
+        }
+        return finished;
+    }
+
+    // Wait for every pending program (loading screen / shutdown)
+    void finish ()
+    {
+        while (!pendingJobs.empty())
+            if (poll() == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    bool pending () const { return !pendingJobs.empty(); }
+    ShaderCompileState state (unsigned int ticket) const { return jobs[ticket].state; }
+    bool ready (unsigned int ticket) const { return jobs[ticket].state == SHADER_COMPILE_READY; }
+
+    // Program of a ready ticket (0 while pending or after a failure)
+    unsigned int program (unsigned int ticket) const { return ready(ticket) ? jobs[ticket].program : 0; }
+
+    // Compile and link log of a finished ticket (warnings too)
+    const std::string& log (unsigned int ticket) const { return jobs[ticket].log; }
+
+    // Internal: status and logs are read only once the driver is done (no wait)
+    void complete (ShaderCompileJob& job)
+    {
+        job.compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job.submitted).count();
+
+        bool compiled = true;
+        for (size_t s = 0; s < job.shaders.size(); s++) {
+            glDetachShader(job.program, job.shaders[s]);
+            ShaderResult shader = shaderCompileStatus(job.shaders[s], job.sources[s], job.name);
+            job.log += shader.log;
+            if (shader.success) glDeleteShader(shader.id);
+            else compiled = false;
+        }
+        job.shaders.clear();
+        job.sources.clear();
+
+        // A stage failed: the link error would only repeat it
+        if (!compiled) {
+            glDeleteProgram(job.program);
+            job.program = 0;
+            job.state = SHADER_COMPILE_FAILED;
+            return;
+        }
+        ShaderResult linked = shaderLinkStatus(job.program, job.name);
+        job.log += linked.log;
+        job.program = linked.id;
+        job.state = linked.success ? SHADER_COMPILE_READY : SHADER_COMPILE_FAILED;
+    }
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef SHADER_DIAGNOSTICS_H
+#define SHADER_DIAGNOSTICS_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+
+#include "ShaderPreprocessor.h"  // #line source numbers -> files
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cctype>
+
+// Shader Diagnostics
+// Compile and link results with the whole info log (GL_INFO_LOG_LENGTH, no fixed buffer): every log line that
+// points at a source position is followed by that line of the original file (the #line numbering of the
+// ShaderPreprocessor maps it back through #includes), and a failed shader or program is deleted and reported
+// as 0 instead of an ID that looks usable.
+// Validation (debug builds, or shaderValidation() = true) runs glValidateProgram against the current state
+// before a draw: samplers of different types on one unit, incomplete bindings ... drivers only report there.
+
+// Compile / link result
+struct ShaderResult {
+    unsigned int id = 0;     // Shader / program object, 0 on failure (deleted)
+    bool success = false;
+    std::string log;         // Info log with source excerpts (warnings of a successful build too)
+};
+
+// Validation mode (glValidateProgram before draws)
+inline bool& shaderValidation ()
+{
+#ifdef NDEBUG
+    static bool validation = false;
+#else
+    static bool validation = true;
+#endif
+    return validation;
+}
+
+// Full info logs
+inline std::string shaderInfoLog (unsigned int shaderID)
+{
+    int length = 0;
+    glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1) return std::string();
+    std::string log(length, '\0');
+    glGetShaderInfoLog(shaderID, length, nullptr, log.data());
+    log.resize(length - 1);
+    return log;
+}
+
+inline std::string programInfoLog (unsigned int programID)
+{
+    int length = 0;
+    glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1) return std::string();
+    std::string log(length, '\0');
+    glGetProgramInfoLog(programID, length, nullptr, log.data());
+    log.resize(length - 1);
+    return log;
+}
+
+// Source position of a log line: "0(12) : error C0000" (NVIDIA), "0:12(5): error" (Mesa),
+// "ERROR: 0:12: ..." (AMD, Intel, glslang)
+inline bool shaderLogPosition (const std::string& line, int& source, int& lineNumber)
+{
+    size_t p = line.find_first_not_of(" \t");
+    if (p == std::string::npos) return false;
+    for (const char* prefix : {"ERROR: ", "WARNING: ", "error: ", "warning: "})
+        if (line.compare(p, std::char_traits<char>::length(prefix), prefix) == 0) {
+            p += std::char_traits<char>::length(prefix);
+            break;
+        }
+    if (p >= line.size() || !std::isdigit((unsigned char)line[p])) return false;
+    size_t end;
+    source = std::stoi(line.substr(p), &end);
+    p += end;
+    if (p + 1 >= line.size() || (line[p] != ':' && line[p] != '(') || !std::isdigit((unsigned char)line[p + 1])) return false;
+    lineNumber = std::stoi(line.substr(p + 1));
+    return true;
+}
+
+// Log with the source line under every positioned message: from the file when the source carries #line
+// directives (ShaderPreprocessor output), from the compiled text otherwise
+inline std::string shaderLogExcerpt (const std::string& log, const std::string& sourceText)
+{
+    bool mapped = sourceText.find("#line") != std::string::npos;
+    std::istringstream lines(log);
+    std::string line, excerpt, result;
+    while (std::getline(lines, line)) {
+        result += line + "\n";
+        int source, lineNumber;
+        if (!shaderLogPosition(line, source, lineNumber)) continue;
+
+        std::string file = mapped ? shaderPreprocessor().sourceName(source) : std::string("source");
+        bool found = false;
+        if (mapped) {
+            found = shaderPreprocessor().sourceLine(source, lineNumber, excerpt);
+        } else {
+            std::istringstream sourceLines(sourceText);
+            for (int l = 1; l <= lineNumber && std::getline(sourceLines, excerpt); l++) found = (l == lineNumber);
+        }
+        if (found) result += "    " + file + ":" + std::to_string(lineNumber) + " | " + excerpt + "\n";
+    }
+    return result;
+}
+
+// Status of a compiled shader (deleted on failure)
+inline ShaderResult shaderCompileStatus (unsigned int shaderID, const std::string& sourceText, const std::string& name)
+{
+    ShaderResult result;
+    int success = 0;
+    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
+    result.log = shaderLogExcerpt(shaderInfoLog(shaderID), sourceText);
+    result.success = success != 0;
+    if (result.success) {
+        result.id = shaderID;
+    } else {
+        std::cout << "Error compiling shader " << name << ":\n" << result.log << std::endl;
+        glDeleteShader(shaderID);
+    }
+    return result;
+}
+
+// Status of a linked program (deleted on failure)
+inline ShaderResult shaderLinkStatus (unsigned int programID, const std::string& name)
+{
+    ShaderResult result;
+    int success = 0;
+    glGetProgramiv(programID, GL_LINK_STATUS, &success);
+    result.log = programInfoLog(programID);
+    result.success = success != 0;
+    if (result.success) {
+        result.id = programID;
+    } else {
+        std::cout << "Error linking shader program " << name << ":\n" << result.log << std::endl;
+        glDeleteProgram(programID);
+    }
+    return result;
+}
+
+// Compile one stage
+inline ShaderResult shaderCompile (unsigned int shaderType, const std::string& sourceText, const std::string& name)
+{
+    unsigned int shaderID = glCreateShader(shaderType);
+    const char* sourceCstr = sourceText.c_str();
+    glShaderSource(shaderID, 1, &sourceCstr, nullptr);
+    glCompileShader(shaderID);
+    return shaderCompileStatus(shaderID, sourceText, name);
+}
+
+// Compile and link a program from {stage, source} pairs: no program when any stage fails
+inline ShaderResult shaderLink (const std::vector<std::pair<unsigned int, std::string>>& stages, const std::string& name)
+{
+    ShaderResult program;
+    std::vector<unsigned int> shaders;
+    for (const std::pair<unsigned int, std::string>& stage : stages) {
+        ShaderResult shader = shaderCompile(stage.first, stage.second, name);
+        program.log += shader.log;
+        if (!shader.success) {
+            for (unsigned int shaderID : shaders) glDeleteShader(shaderID);
+            return program;
+        }
+        shaders.push_back(shader.id);
+    }
+
+    unsigned int programID = glCreateProgram();
+    for (unsigned int shaderID : shaders) glAttachShader(programID, shaderID);
+    glLinkProgram(programID);
+    for (unsigned int shaderID : shaders) {
+        glDetachShader(programID, shaderID);
+        glDeleteShader(shaderID);
+    }
+    ShaderResult linked = shaderLinkStatus(programID, name);
+    linked.log = program.log + linked.log;
+    return linked;
+}
+
+// Validate a program against the current state (bound textures, samplers, buffers): true when valid or validation is off
+inline bool shaderValidate (unsigned int programID, const std::string& name)
+{
+    if (!shaderValidation() || programID == 0) return true;
+    glValidateProgram(programID);
+    int valid = 0;
+    glGetProgramiv(programID, GL_VALIDATE_STATUS, &valid);
+    if (!valid) std::cout << "Shader program " << name << " is not valid for the current state:\n" << programInfoLog(programID) << std::endl;
+    return valid != 0;
+}
+
+#endif
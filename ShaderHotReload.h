@@ -0,0 +1,310 @@
+#ifndef SHADER_HOT_RELOAD_H
+#define SHADER_HOT_RELOAD_H
+
+#include <GL/glew.h>             // GLEW for OpenGL functions
+
+#include "Shader.h"
+#include "ComputeShader.h"
+#include "Material.h"
+#include "ShaderCompiler.h"
+#include "ShaderPreprocessor.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+// Shader Hot Reload
+// Watches the shader sources of registered programs and everything they #include (inotify on the source
+// directories on Linux, last write time polling elsewhere). A changed source is rebuilt through the ShaderCompiler (driver threads, no blocking
+// status reads) and update(), called by the render thread at the start of a frame, swaps the new program in
+// only once it has linked: a compile or link error prints the log and keeps the old program running.
+// The uniform location caches are resolved again by name on the new program, so bindUniform*(name) keeps working.
+// Only the programs whose dependency list (ShaderPreprocessor) contains a changed file are rebuilt.
+
+const std::chrono::milliseconds SHADER_WATCH_POLL_INTERVAL(250);   // Polling fallback
+
+// Paths compared in one form: "./shaders/a/../b.glsl" -> "shaders/b.glsl"
+inline std::string shaderWatchPath (const std::string& path)
+{
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+// Uniform location cache of a relinked program: same names, locations of the new program
+inline void relinkUniformLocations (std::vector<std::pair<std::string, int>>& uniformLocations, unsigned int program)
+{
+    for (std::pair<std::string, int>& uniform : uniformLocations)
+        uniform.second = glGetUniformLocation(program, uniform.first.c_str());
+}
+
+// Shader Watcher: changed files among the watched ones
+struct ShaderWatcher {
+
+    std::vector<std::string> files;                                 // Watched files (shaderWatchPath form)
+    std::vector<std::filesystem::path> filePaths;
+    std::vector<std::filesystem::file_time_type> writeTimes;
+    std::chrono::steady_clock::time_point nextScan;
+
+#if defined(__linux__)
+    int inotify = -1;
+    std::vector<std::pair<int, std::string>> directories;           // Watch descriptor, directory
+    alignas(inotify_event) char events[4096];
+#endif
+
+    // Constructor
+    ShaderWatcher ()
+    {
+#if defined(__linux__)
+        inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify < 0) std::cout << "inotify unavailable: shader sources are polled" << std::endl;
+#endif
+        nextScan = std::chrono::steady_clock::now();
+    }
+
+    // Destructor
+    ~ShaderWatcher ()
+    {
+#if defined(__linux__)
+        if (inotify >= 0) close(inotify);
+#endif
+    }
+
+    // Watch a file (its directory with inotify: editors often save by renaming a new file over the old one)
+    void add (const std::string& filePath)
+    {
+        std::string file = shaderWatchPath(filePath);
+        if (std::find(files.begin(), files.end(), file) != files.end()) return;
+        files.push_back(file);
+        filePaths.push_back(file);
+        std::error_code error;
+        writeTimes.push_back(std::filesystem::last_write_time(filePaths.back(), error));
+
+#if defined(__linux__)
+        if (inotify < 0) return;
+        std::string directory = std::filesystem::path(file).parent_path().generic_string();
+        if (directory.empty()) directory = ".";
+        for (const std::pair<int, std::string>& watched : directories)
+            if (watched.second == directory) return;
+        int watch = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch >= 0) directories.push_back({watch, directory});
+#endif
+    }
+
+    // Append the watched files changed since the last call (non blocking)
+    void poll (std::vector<std::string>& changed)
+    {
+#if defined(__linux__)
+        if (inotify >= 0) {
+            for (;;) {
+                ssize_t length = read(inotify, events, sizeof(events));
+                if (length <= 0) break;
+                for (char* event = events; event < events + length;) {
+                    const inotify_event* notification = reinterpret_cast<const inotify_event*>(event);
+                    event += sizeof(inotify_event) + notification->len;
+                    if (notification->len == 0) continue;
+                    for (const std::pair<int, std::string>& watched : directories) {
+                        if (watched.first != notification->wd) continue;
+                        std::string file = (watched.second == ".") ? std::string(notification->name) : watched.second + "/" + notification->name;
+                        if (std::find(files.begin(), files.end(), file) != files.end() && std::find(changed.begin(), changed.end(), file) == changed.end())
+                            changed.push_back(file);
+                    }
+                }
+            }
+            return;
+        }
+#endif
+        // Polling: last write time of every file, a few times per second
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now < nextScan) return;
+        nextScan = now + SHADER_WATCH_POLL_INTERVAL;
+        for (size_t f = 0; f < files.size(); f++) {
+            std::error_code error;
+            std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filePaths[f], error);
+            if (error || writeTime == writeTimes[f]) continue;
+            writeTimes[f] = writeTime;
+            changed.push_back(files[f]);
+        }
+    }
+};
+
+// Shader Hot Reload: watched programs, rebuilds in flight, swaps at the frame boundary
+struct ShaderHotReload {
+
+    // Program sources, the files they include and how to rebuild them
+    struct Target {
+        std::vector<std::string> roots;
+        std::vector<std::string> files;
+        std::function<void()> rebuild;
+    };
+
+    // Rebuild in flight and how to swap it in. One live rebuild per program: a newer save supersedes the pending one,
+    // whose program is deleted when it finishes (parallel compiles may finish out of order)
+    struct Swap {
+        unsigned int ticket;
+        const void* program;                 // The program slot swapped (Shader, ComputeShader, material variant)
+        std::string name;
+        std::function<void(unsigned int program)> swap;
+        bool superseded;
+    };
+
+    ShaderWatcher watcher;
+    ShaderCompiler compiler;
+    std::vector<Target> targets;
+    std::vector<Swap> swaps;
+    std::vector<std::string> changed;
+    std::vector<Target*> modified;
+    unsigned int reloads = 0;
+    unsigned int failures = 0;
+
+    // Constructor: on the context that runs update() (or one sharing objects with it)
+    ShaderHotReload () { compiler.setup(); }
+
+    // Reader: fresh source once the changed files are invalidated in the preprocessor
+    static std::string shaderRead (const std::string& filePath)
+    {
+        return shaderPreprocessor().preprocess(filePath).text;
+    }
+
+    void watch (const std::vector<std::string>& roots, std::function<void()> rebuild)
+    {
+        Target target;
+        for (const std::string& root : roots) target.roots.push_back(shaderWatchPath(root));
+        target.rebuild = std::move(rebuild);
+        targets.push_back(std::move(target));
+        refresh(targets.back());
+    }
+
+    // Watched files of a target: its roots and their includes (they change when an edit adds an #include)
+    void refresh (Target& target)
+    {
+        target.files.clear();
+        for (const std::string& root : target.roots) {
+            ShaderSource source = shaderPreprocessor().preprocess(root);
+            if (source.dependencies.empty()) source.dependencies.push_back(root);
+            for (const std::string& file : source.dependencies) {
+                std::string watched = shaderWatchPath(file);
+                if (std::find(target.files.begin(), target.files.end(), watched) != target.files.end()) continue;
+                target.files.push_back(watched);
+                watcher.add(watched);
+            }
+        }
+    }
+
+    // Submit a rebuild of a program slot, swapped in by update() once linked (pending rebuilds of the slot superseded)
+    void rebuild (const void* program, const std::vector<std::pair<unsigned int, std::string>>& stages, const std::string& name,
+                  std::function<void(unsigned int program)> swap)
+    {
+        for (Swap& pending : swaps)
+            if (pending.program == program) pending.superseded = true;
+        swaps.push_back({compiler.submit(stages, name), program, name, std::move(swap), false});
+    }
+
+    // Vertex + fragment shader program
+    void watch (Shader& shader, const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
+    {
+        watch({vertexShaderPath, fragmentShaderPath}, [this, &shader, vertexShaderPath, fragmentShaderPath]() {
+            std::string vertexSource = shaderRead(vertexShaderPath), fragmentSource = shaderRead(fragmentShaderPath);
+            rebuild(&shader, {{GL_VERTEX_SHADER, vertexSource}, {GL_FRAGMENT_SHADER, fragmentSource}}, fragmentShaderPath,
+                    [&shader, vertexSource, fragmentSource](unsigned int program) {
+                glDeleteProgram(shader.shaderProgramID);
+                shader.shaderProgramID = program;
+                shader.vertexShader = vertexSource;
+                shader.fragmentShader = fragmentSource;
+                relinkUniformLocations(shader.uniformLocations, program);
+            });
+        });
+    }
+
+    // Compute shader program
+    void watch (ComputeShader& shader, const std::string& computeShaderPath)
+    {
+        watch({computeShaderPath}, [this, &shader, computeShaderPath]() {
+            std::string computeSource = shaderRead(computeShaderPath);
+            rebuild(&shader, {{GL_COMPUTE_SHADER, computeSource}}, computeShaderPath, [&shader, computeSource](unsigned int program) {
+                glDeleteProgram(shader.shaderProgramID);
+                shader.shaderProgramID = program;
+                shader.computeShader = computeSource;
+                relinkUniformLocations(shader.uniformLocations, program);
+            });
+        });
+    }
+
+    // Material templates: every compiled variant is rebuilt, failed ones are retried on their next request
+    void watch (MaterialLibrary& library, const std::string& vertexTemplatePath, const std::string& fragmentTemplatePath)
+    {
+        watch({vertexTemplatePath, fragmentTemplatePath}, [this, &library, vertexTemplatePath, fragmentTemplatePath]() {
+            std::string vertexTemplate = shaderRead(vertexTemplatePath), fragmentTemplate = shaderRead(fragmentTemplatePath);
+            {
+                std::lock_guard<std::mutex> lock(library.queueMutex);
+                library.vertexTemplate = vertexTemplate;
+                library.fragmentTemplate = fragmentTemplate;
+            }
+            for (uint32_t features = 0; features < MATERIAL_PERMUTATIONS; features++) {
+                MaterialVariant& materialVariant = library.variants[features];
+                int expected = VARIANT_FAILED;
+                if (materialVariant.state.compare_exchange_strong(expected, VARIANT_NONE)) continue;
+                if (expected != VARIANT_READY) continue;
+                rebuild(&materialVariant, {{GL_VERTEX_SHADER, materialSource(vertexTemplate, features)}, {GL_FRAGMENT_SHADER, materialSource(fragmentTemplate, features)}},
+                        fragmentTemplatePath + " variant " + std::to_string(features), [&materialVariant](unsigned int program) {
+                    glDeleteProgram(materialVariant.program.exchange(program, std::memory_order_acq_rel));
+                    relinkUniformLocations(materialVariant.uniformLocations, program);
+                });
+            }
+        });
+    }
+
+    // Frame boundary (render thread): rebuild the programs of changed files, swap in the ones that linked
+    void update ()
+    {
+        changed.clear();
+        watcher.poll(changed);
+        if (!changed.empty()) {
+            // Affected targets first (the dependency lists still describe the old files), then fresh sources
+            modified.clear();
+            for (Target& target : targets)
+                for (const std::string& file : target.files)
+                    if (std::find(changed.begin(), changed.end(), file) != changed.end()) {
+                        modified.push_back(&target);
+                        break;
+                    }
+            for (const std::string& file : changed) shaderPreprocessor().invalidate(file);
+            for (Target* target : modified) {
+                target->rebuild();
+                refresh(*target);
+            }
+        }
+        if (swaps.empty()) return;
+
+        compiler.poll();
+        for (size_t s = 0; s < swaps.size();) {
+            ShaderCompileState state = compiler.state(swaps[s].ticket);
+            if (state == SHADER_COMPILE_PENDING) {
+                s++;
+                continue;
+            }
+            if (swaps[s].superseded) {
+                if (state == SHADER_COMPILE_READY) glDeleteProgram(compiler.program(swaps[s].ticket));   // Older than the pending rebuild
+            } else if (state == SHADER_COMPILE_READY) {
+                swaps[s].swap(compiler.program(swaps[s].ticket));
+                reloads++;
+                std::cout << "Reloaded " << swaps[s].name << std::endl;
+            } else {
+                failures++;
+                std::cout << "Reload failed, previous program kept: " << swaps[s].name << std::endl;
+            }
+            swaps.erase(swaps.begin() + s);
+        }
+    }
+};
+
+#endif
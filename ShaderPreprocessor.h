@@ -0,0 +1,223 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <cstdint>
+
+// Shader Preprocessor
+// Runs before the GLSL compiler: resolves #include "file" (relative to the including file, then the include
+// directories), skips files already included under #pragma once (#ifndef guards work as usual), injects #defines
+// after #version and emits #line directives so compile errors point at the original file and line: GLSL names
+// sources by number, sourceName(number) gives the file back.
+// Every result records the files it was built from (dependencies: the files hot reload watches for a program) and
+// is memoized with its hash until one of those files is invalidated.
+
+// Preprocessed source
+struct ShaderSource {
+    std::string text;
+    uint64_t hash = 0;                        // FNV-1a 64 of the text (program / binary cache key)
+    std::vector<std::string> dependencies;    // The root file first, then every included file
+    bool success = false;
+};
+
+// FNV-1a 64
+inline uint64_t shaderSourceHash (const std::string& text)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+struct ShaderPreprocessor {
+
+    std::vector<std::string> includeDirectories = {"./shaders"};
+
+    std::mutex mutex;
+    std::vector<std::string> sourceNames;                        // #line source number -> file
+    std::unordered_map<std::string, std::string> files;          // File contents (until invalidated)
+    std::unordered_map<std::string, ShaderSource> results;       // Memoized: root file + defines -> source
+
+    // Preprocess a root file with extra #defines ("NAME" or "NAME VALUE")
+    ShaderSource preprocess (const std::string& filePath, const std::vector<std::string>& defines = {})
+    {
+        std::string root = normalize(filePath);
+        std::string key = root;
+        for (const std::string& define : defines) key += "\n" + define;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto memoized = results.find(key);
+        if (memoized != results.end()) return memoized->second;
+
+        ShaderSource source;
+        std::vector<std::string> stack, once;
+        source.success = expand(root, defines, true, source, stack, once);
+        source.hash = shaderSourceHash(source.text);
+        if (source.success) results[key] = source;
+        return source;
+    }
+
+    // A file changed: its contents and every memoized result built from it are dropped
+    void invalidate (const std::string& filePath)
+    {
+        std::string file = normalize(filePath);
+        std::lock_guard<std::mutex> lock(mutex);
+        files.erase(file);
+        for (auto result = results.begin(); result != results.end();) {
+            const std::vector<std::string>& dependencies = result->second.dependencies;
+            if (std::find(dependencies.begin(), dependencies.end(), file) != dependencies.end())
+                result = results.erase(result);
+            else
+                ++result;
+        }
+    }
+
+    // File of a #line source number (compile logs)
+    std::string sourceName (int number)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (number >= 0 && number < (int)sourceNames.size()) ? sourceNames[number] : std::string("?");
+    }
+
+    // Line of a #line source number, as in the file (compile log excerpts), false when unknown
+    bool sourceLine (int number, int lineNumber, std::string& line)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (number < 0 || number >= (int)sourceNames.size() || lineNumber < 1) return false;
+        const std::string* text = read(sourceNames[number]);
+        if (!text) return false;
+        size_t start = 0;
+        for (int l = 1; l < lineNumber; l++) {
+            start = text->find('\n', start);
+            if (start == std::string::npos) return false;
+            start++;
+        }
+        size_t end = text->find('\n', start);
+        line = text->substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+
+    // Internal
+    static std::string normalize (const std::string& filePath)
+    {
+        return std::filesystem::path(filePath).lexically_normal().generic_string();
+    }
+
+    int sourceNumber (const std::string& file)
+    {
+        auto found = std::find(sourceNames.begin(), sourceNames.end(), file);
+        if (found != sourceNames.end()) return (int)(found - sourceNames.begin());
+        sourceNames.push_back(file);
+        return (int)sourceNames.size() - 1;
+    }
+
+    const std::string* read (const std::string& file)
+    {
+        auto cached = files.find(file);
+        if (cached != files.end()) return &cached->second;
+
+        std::ifstream shaderFile(file);
+        if (!shaderFile) return nullptr;
+        std::stringstream shaderString;
+        shaderString << shaderFile.rdbuf();
+        return &(files[file] = shaderString.str());
+    }
+
+    // Included file: next to the includer first, then the include directories
+    std::string resolve (const std::string& includer, const std::string& name)
+    {
+        std::filesystem::path local = std::filesystem::path(includer).parent_path() / name;
+        if (std::filesystem::exists(local)) return normalize(local.generic_string());
+        for (const std::string& directory : includeDirectories) {
+            std::filesystem::path candidate = std::filesystem::path(directory) / name;
+            if (std::filesystem::exists(candidate)) return normalize(candidate.generic_string());
+        }
+        return normalize(local.generic_string());
+    }
+
+    bool expand (const std::string& file, const std::vector<std::string>& defines, bool root, ShaderSource& source,
+                 std::vector<std::string>& stack, std::vector<std::string>& once)
+    {
+        const std::string* text = read(file);
+        if (!text) {
+            std::cout << "Failed to read the shader: " << file << (stack.empty() ? "" : " (included by " + stack.back() + ")") << std::endl;
+            return false;
+        }
+        if (std::find(source.dependencies.begin(), source.dependencies.end(), file) == source.dependencies.end())
+            source.dependencies.push_back(file);
+        stack.push_back(file);
+
+        int number = sourceNumber(file);
+        std::string defineLines;
+        for (const std::string& define : defines) defineLines += "#define " + define + "\n";
+        bool versioned = false;
+        if (!root) source.text += "#line 1 " + std::to_string(number) + "\n";
+
+        std::istringstream lines(*text);
+        std::string line;
+        bool success = true;
+        for (int lineNumber = 1; std::getline(lines, line); lineNumber++) {
+            size_t start = line.find_first_not_of(" \t");
+            std::string directive = (start == std::string::npos || line[start] != '#') ? std::string() : line.substr(start);
+
+            // #version stays first, the defines and the numbering of this file follow it
+            if (root && !versioned && directive.compare(0, 8, "#version") == 0) {
+                source.text += line + "\n" + defineLines + "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(number) + "\n";
+                versioned = true;
+                continue;
+            }
+
+            if (directive.compare(0, 12, "#pragma once") == 0) {
+                if (std::find(once.begin(), once.end(), file) == once.end()) once.push_back(file);
+                source.text += "\n";
+                continue;
+            }
+
+            if (directive.compare(0, 8, "#include") == 0) {
+                size_t open = directive.find_first_of("\"<");
+                size_t close = (open == std::string::npos) ? open : directive.find_first_of("\">", open + 1);
+                if (close == std::string::npos) {
+                    std::cout << file << "(" << lineNumber << "): malformed #include" << std::endl;
+                    success = false;
+                    continue;
+                }
+                std::string included = resolve(file, directive.substr(open + 1, close - open - 1));
+                if (std::find(stack.begin(), stack.end(), included) != stack.end()) {
+                    std::cout << file << "(" << lineNumber << "): include cycle through " << included << std::endl;
+                    success = false;
+                    continue;
+                }
+                if (std::find(once.begin(), once.end(), included) == once.end())
+                    success = expand(included, defines, false, source, stack, once) && success;
+                source.text += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(number) + "\n";
+                continue;
+            }
+
+            source.text += line + "\n";
+        }
+        if (root && !versioned) source.text = defineLines + "#line 1 " + std::to_string(number) + "\n" + source.text;
+
+        stack.pop_back();
+        return success;
+    }
+};
+
+// Shared preprocessor (Shader, ComputeShader, materials, hot reload)
+inline ShaderPreprocessor& shaderPreprocessor ()
+{
+    static ShaderPreprocessor preprocessor;
+    return preprocessor;
+}
+
+#endif
@@ -2,44 +2,132 @@
 #define TEXTURE_H
 
 #include <GL/glew.h>                  // GLEW for OpenGL functions
-#define STB_IMAGE_IMPLEMENTATION      // Compile stb_image
-#include <stb_image/stb_image.h>      // Include stb_image for textures
+#include "ImageDecoder.h"             // stb_image / libjpeg-turbo (compiled once in ImageDecoder.cpp)
+#include "TexturePacker.h"
+
+#include "AssetPack.h"
 
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <string>
+#include <vector>
+#include <span>
+
+// Texture upload from decoded image data (the bound GL_TEXTURE_2D; a bound pixel unpack buffer: imageData is an offset)
+// srgb: color images are stored sRGB encoded, the sampler decodes them to linear (filtering and mipmaps in linear
+// light, RenderTarget.h); false for data that is already linear (normal maps, masks, lookup tables)
+inline void uploadTexture (const unsigned char* imageData, int width, int height, int nChannels, bool srgb = true)
+{
+    unsigned int format = (nChannels == 4) ? GL_RGBA : GL_RGB;
+    unsigned int internalFormat = (nChannels == 4) ? (srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8) : (srgb ? GL_SRGB8 : GL_RGB8);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);    // RGB rows are not 4 byte aligned
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, imageData); 
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+// Channels a texture is decoded to: RGB, or RGBA when the image has alpha (grey images are expanded)
+inline int textureChannels (int imageChannels)
+{
+    return (imageChannels == 2 || imageChannels == 4) ? 4 : 3;
+}
+
+// Decode an encoded image straight into a mapped pixel unpack buffer (large images in stripes on the job system),
+// then upload it from the buffer to the bound GL_TEXTURE_2D: no decoded copy in client memory
+inline bool uploadEncodedTexture (const unsigned char* encodedData, size_t encodedSize, bool srgb = true)
+{
+    int width, height, channels;
+    if (!imageInfo(encodedData, encodedSize, width, height, channels)) return false;
+    channels = textureChannels(channels);
+    size_t rowPitch = (size_t)width * channels;
 
-unsigned int loadTexture (const std::string& imageFilePath) 
+    unsigned int staging;
+    glGenBuffers(1, &staging);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, rowPitch * height, nullptr, GL_STREAM_DRAW);
+    unsigned char* mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, rowPitch * height, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    bool decoded = mapped && decodeImageInto(encodedData, encodedSize, mapped, rowPitch, channels);
+    if (mapped && glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE) decoded = false;   // Buffer contents lost (e.g. mode switch)
+    if (decoded) uploadTexture(nullptr, width, height, channels, srgb);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &staging);
+    return decoded;
+}
+
+inline unsigned int createTexture ()
 {
     unsigned int textureID;
-    int width, height, nChannels;
 
     // Generate and Bind texture ID
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_2D, textureID);
 
-    // Texture options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); // S-axis Horizontal
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT); // T-axis Vertical
-    // Minification: Texture is displayed smaller than its original size; involves retriever algorithms to determine texel colors
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); 
-    // Magnification: Texture is displayed larger than its original size; involves sampling algorithms to determine texel colors
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // GL_LINEAR produces a smoother pattern where the individual pixels are less visible.
-
-    // Load the image using stb_image.h
-    unsigned char* imageData = stbi_load(imageFilePath.c_str(), &width, &height, &nChannels, 0);
-
-    // Process image
-    if (imageData != NULL) {
-        unsigned int format = (nChannels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, imageData); 
-        glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-        std::cout << "Failed to load the image: " << imageFilePath << std::endl;
+    // Texture options: none per texture, the sampler object bound with it decides (Sampler.h, Material::sampler):
+    // wrapping, minification (trilinear over the mipmaps uploadTexture generates) and magnification
+
+    return textureID;
+}
+
+inline unsigned int loadTexture (const std::string& imageFilePath, bool srgb = true)
+{
+    unsigned int textureID = createTexture();
+
+    // Load the image (ImageDecoder.h, decoded into the staging buffer)
+    std::ifstream file(imageFilePath, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to load the image: " << imageFilePath << " (can't open the file)" << std::endl;
+        return textureID;
+    }
+    std::vector<unsigned char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!uploadEncodedTexture(encoded.data(), encoded.size(), srgb)) {
+        std::cout << "Failed to load the image: " << imageFilePath << " (" << imageDecodeError() << ")" << std::endl;
+    }
+
+    return textureID;
+}
+
+// Load a texture from an encoded image in memory (jpg / png ... bytes, e.g. an asset pack view)
+inline unsigned int loadTexture (const unsigned char* encodedData, size_t encodedSize, const std::string& imageName, bool srgb = true)
+{
+    unsigned int textureID = createTexture();
+
+    if (!uploadEncodedTexture(encodedData, encodedSize, srgb)) {
+        std::cout << "Failed to load the image: " << imageName << " (" << imageDecodeError() << ")" << std::endl;
     }
 
-    stbi_image_free(imageData);
+    return textureID;
+}
+
+// Load a texture from an asset pack (no file access: decoded straight from the mapping)
+inline unsigned int loadTexture (const AssetPack& pack, const std::string& imageName, bool srgb = true)
+{
+    std::vector<unsigned char> buffer;
+    std::span<const unsigned char> encoded = pack.read(imageName, buffer);
+    return loadTexture(encoded.data(), encoded.size(), imageName, srgb);
+}
+
+// Texture array from a packed atlas: one layer per atlas page, mip levels limited to the ones the gutters protect
+// (srgb: RGB / RGBA atlases stored sRGB, 1 / 2 channel atlases hold data and stay linear)
+inline unsigned int loadTextureArray (const TextureAtlas& atlas, bool srgb = true)
+{
+    const unsigned int formats[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+    const unsigned int internalFormats[4] = {GL_R8, GL_RG8, (unsigned int)(srgb ? GL_SRGB8 : GL_RGB8), (unsigned int)(srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8)};
+    unsigned int format = formats[atlas.channels - 1];
+    unsigned int textureID;
+
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, atlas.mipLevels(), internalFormats[atlas.channels - 1], atlas.layerSize, atlas.layerSize, (int)atlas.layers.size());
+
+    // Rows of 1 / 3 channel layers are not 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t layer = 0; layer < atlas.layers.size(); layer++)
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (int)layer, atlas.layerSize, atlas.layerSize, 1, format, GL_UNSIGNED_BYTE, atlas.layers[layer].data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
 
+    // Sampled with a clamped trilinear sampler (Sampler.h): the atlas UVs never wrap into a neighbour
     return textureID;
 }
 
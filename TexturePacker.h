@@ -0,0 +1,350 @@
+#ifndef TEXTURE_PACKER_H
+#define TEXTURE_PACKER_H
+
+#include <glm/glm.hpp>                // Include all GLM core / GLSL features
+
+#include "ImageDecoder.h"             // Image decode (ImageDecoder.cpp)
+#include "AssetPack.h"                // assetPackName / assetPackHash
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+// Texture Packer
+// Small textures of the same format (channel count) are packed into the layers of one GL_TEXTURE_2D_ARRAY, each
+// layer an atlas filled by a skyline packer: a whole material group is then drawn with a single texture binding,
+// the mesh UVs remapped into the texture's rectangle and the layer passed with the draw.
+// Every rectangle has a gutter (edge texels repeated) and is aligned to the gutter size, so the first
+// log2(gutter) + 1 mip levels never blend neighbouring textures; the array keeps only those levels.
+// Packing runs offline (tools/AtlasBuilder) or on first load; the result is cached in an .atlas file keyed on the
+// source names, sizes and modification times.
+
+const uint32_t TEXTURE_ATLAS_MAGIC = 0x534C5441;   // "ATLS"
+const uint32_t TEXTURE_ATLAS_VERSION = 1;
+const int TEXTURE_ATLAS_LAYER_SIZE = 2048;           // Layer width / height (grows to fit larger images)
+const int TEXTURE_ATLAS_GUTTER = 4;                  // Gutter texels per side (power of two): 3 mip levels
+const int TEXTURE_ATLAS_MAX_LAYERS = 2048;           // Cache files: layers per atlas (GL_MAX_ARRAY_TEXTURE_LAYERS of common drivers)
+const int TEXTURE_ATLAS_MAX_ENTRIES = 1 << 20;       // Cache files: images per atlas
+
+// Skyline Packer (bottom-left): the packed area is a list of horizontal segments, a rectangle goes where its top is lowest
+struct SkylinePacker {
+    struct Segment {
+        int x, y, width;
+    };
+
+    int width = 0;
+    int height = 0;
+    std::vector<Segment> skyline;
+
+    SkylinePacker (int packerWidth = 0, int packerHeight = 0) { reset(packerWidth, packerHeight); }
+
+    void reset (int packerWidth, int packerHeight)
+    {
+        width = packerWidth;
+        height = packerHeight;
+        skyline.assign(1, {0, 0, packerWidth});
+    }
+
+    // Y of a rectangle whose left edge is at segment index (highest segment below it), -1 when it does not fit
+    int fit (size_t index, int rectWidth, int rectHeight) const
+    {
+        if (skyline[index].x + rectWidth > width) return -1;
+        int y = 0;
+        for (int remaining = rectWidth; remaining > 0; index++) {
+            y = std::max(y, skyline[index].y);
+            if (y + rectHeight > height) return -1;
+            remaining -= skyline[index].width;
+        }
+        return y;
+    }
+
+    bool insert (int rectWidth, int rectHeight, int& x, int& y)
+    {
+        size_t best = skyline.size();
+        int bestTop = INT_MAX, bestWidth = INT_MAX;
+        for (size_t s = 0; s < skyline.size(); s++) {
+            int fitY = fit(s, rectWidth, rectHeight);
+            if (fitY < 0) continue;
+            if (fitY + rectHeight < bestTop || (fitY + rectHeight == bestTop && skyline[s].width < bestWidth)) {
+                best = s;
+                bestTop = fitY + rectHeight;
+                bestWidth = skyline[s].width;
+            }
+        }
+        if (best == skyline.size()) return false;
+
+        x = skyline[best].x;
+        y = bestTop - rectHeight;
+        skyline.insert(skyline.begin() + best, {x, bestTop, rectWidth});
+
+        // Segments under the new one are cut (or removed)
+        for (size_t s = best + 1; s < skyline.size();) {
+            int covered = skyline[s - 1].x + skyline[s - 1].width - skyline[s].x;
+            if (covered <= 0) break;
+            skyline[s].x += covered;
+            skyline[s].width -= covered;
+            if (skyline[s].width > 0) break;
+            skyline.erase(skyline.begin() + s);
+        }
+
+        // Neighbours at the same height merge
+        for (size_t s = 0; s + 1 < skyline.size();) {
+            if (skyline[s].y == skyline[s + 1].y) {
+                skyline[s].width += skyline[s + 1].width;
+                skyline.erase(skyline.begin() + s + 1);
+            } else {
+                s++;
+            }
+        }
+        return true;
+    }
+};
+
+// Packed texture: layer and rectangle (texels, without the gutter), UV rectangle (offset xy, scale zw)
+struct TextureAtlasEntry {
+    std::string name;
+    unsigned int layer;
+    int x, y, width, height;
+    glm::vec4 uvRect;
+
+    // Texture UV [0, 1] -> atlas UV (no repeat: the gutter only covers filtering)
+    glm::vec2 remap (const glm::vec2& uv) const { return glm::vec2(uvRect.x, uvRect.y) + uv * glm::vec2(uvRect.z, uvRect.w); }
+};
+
+// Atlas: one texture array, every layer layerSize x layerSize texels of one channel count
+struct TextureAtlas {
+    int channels = 4;
+    int layerSize = 0;
+    int gutter = TEXTURE_ATLAS_GUTTER;
+    std::vector<TextureAtlasEntry> entries;
+    std::vector<std::vector<unsigned char>> layers;
+
+    // Mip levels that stay inside the gutters (1 + log2(gutter))
+    int mipLevels () const
+    {
+        int levels = 1;
+        for (int g = gutter; g > 1; g >>= 1) levels++;
+        return levels;
+    }
+
+    const TextureAtlasEntry* find (const std::string& textureName) const
+    {
+        std::string name = assetPackName(textureName);
+        for (const TextureAtlasEntry& entry : entries)
+            if (entry.name == name) return &entry;
+        return nullptr;
+    }
+};
+
+// Remap the texture coordinates of mesh vertices (any vertex type with a glm::vec2 Tex) into a packed texture
+template <typename V>
+inline void remapTexCoords (std::vector<V>& vertices, const TextureAtlasEntry& entry)
+{
+    for (V& vertex : vertices) vertex.Tex = entry.remap(vertex.Tex);
+}
+
+// Texture Packer: decoded images in, one atlas per channel count out
+struct TexturePacker {
+    struct Image {
+        std::string name;
+        std::vector<unsigned char> pixels;
+        int width, height, channels;
+    };
+
+    int layerSize = TEXTURE_ATLAS_LAYER_SIZE;
+    int gutter = TEXTURE_ATLAS_GUTTER;
+    std::vector<Image> images;
+
+    void add (const std::string& name, const unsigned char* pixels, int width, int height, int channels)
+    {
+        images.push_back({assetPackName(name), std::vector<unsigned char>(pixels, pixels + (size_t)width * height * channels), width, height, channels});
+    }
+
+    bool addFile (const std::string& imageFilePath)
+    {
+        DecodedImage image;
+        if (!decodeImageFile(imageFilePath, image)) {
+            std::cout << "Failed to load the image: " << imageFilePath << " (" << imageDecodeError() << ")" << std::endl;
+            return false;
+        }
+        add(imageFilePath, image.pixels, image.width, image.height, image.channels);
+        return true;
+    }
+
+    std::vector<TextureAtlas> pack () const
+    {
+        // Gutter: power of two, rectangles aligned to it
+        int align = 1;
+        while (align < gutter) align <<= 1;
+        auto padded = [align](int size) { return (size + 2 * align + align - 1) / align * align; };
+
+        std::vector<TextureAtlas> atlases;
+        for (int channels = 1; channels <= 4; channels++) {
+            // Tallest first (skyline packs best), then widest
+            std::vector<const Image*> group;
+            for (const Image& image : images)
+                if (image.channels == channels) group.push_back(&image);
+            if (group.empty()) continue;
+            std::sort(group.begin(), group.end(), [](const Image* a, const Image* b) {
+                return a->height != b->height ? a->height > b->height : a->width > b->width;
+            });
+
+            TextureAtlas atlas;
+            atlas.channels = channels;
+            atlas.gutter = align;
+            atlas.layerSize = layerSize;
+            for (const Image* image : group)
+                while (std::max(padded(image->width), padded(image->height)) > atlas.layerSize) atlas.layerSize <<= 1;
+
+            std::vector<SkylinePacker> packers;
+            for (const Image* image : group) {
+                int rectWidth = padded(image->width), rectHeight = padded(image->height);
+                int x = 0, y = 0;
+                size_t layer = 0;
+                while (layer < packers.size() && !packers[layer].insert(rectWidth, rectHeight, x, y)) layer++;
+                if (layer == packers.size()) {
+                    packers.emplace_back(atlas.layerSize, atlas.layerSize);
+                    atlas.layers.emplace_back((size_t)atlas.layerSize * atlas.layerSize * channels, 0);
+                    packers.back().insert(rectWidth, rectHeight, x, y);
+                }
+                blit(*image, atlas.layers[layer], atlas.layerSize, x, y, rectWidth, rectHeight, align);
+
+                float size = (float)atlas.layerSize;
+                atlas.entries.push_back({image->name, (unsigned int)layer, x + align, y + align, image->width, image->height,
+                                         glm::vec4((x + align) / size, (y + align) / size, image->width / size, image->height / size)});
+            }
+            atlases.push_back(std::move(atlas));
+        }
+        return atlases;
+    }
+
+    // Copy an image into its rectangle, the gutter (and alignment padding) filled with the nearest edge texel
+    static void blit (const Image& image, std::vector<unsigned char>& layer, int layerSize, int x, int y, int rectWidth, int rectHeight, int border)
+    {
+        size_t texel = (size_t)image.channels;
+        for (int row = 0; row < rectHeight; row++) {
+            int sourceRow = std::clamp(row - border, 0, image.height - 1);
+            unsigned char* destination = layer.data() + ((size_t)(y + row) * layerSize + x) * texel;
+            const unsigned char* source = image.pixels.data() + (size_t)sourceRow * image.width * texel;
+            for (int column = 0; column < rectWidth; column++) {
+                int sourceColumn = std::clamp(column - border, 0, image.width - 1);
+                std::memcpy(destination + column * texel, source + sourceColumn * texel, texel);
+            }
+        }
+    }
+};
+
+// Cache key: packer settings + every source name, size and modification time
+inline uint64_t textureAtlasKey (const std::vector<std::string>& imageFilePaths, int layerSize, int gutter)
+{
+    std::string key = std::to_string(layerSize) + "/" + std::to_string(gutter);
+    for (const std::string& path : imageFilePaths) {
+        std::error_code error;
+        key += "|" + assetPackName(path) + ":" + std::to_string(std::filesystem::file_size(path, error));
+        key += ":" + std::to_string(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    }
+    return assetPackHash(key);
+}
+
+// Cache file: header, then per atlas its description, entries and layer texels
+inline bool saveTextureAtlases (const std::string& cacheFilePath, const std::vector<TextureAtlas>& atlases, uint64_t key)
+{
+    std::ofstream file(cacheFilePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "Failed to write the texture atlas: " << cacheFilePath << std::endl;
+        return false;
+    }
+    auto write = [&file](const void* data, size_t size) { file.write(reinterpret_cast<const char*>(data), (std::streamsize)size); };
+    uint32_t header[3] = {TEXTURE_ATLAS_MAGIC, TEXTURE_ATLAS_VERSION, (uint32_t)atlases.size()};
+    write(header, sizeof(header));
+    write(&key, sizeof(key));
+    for (const TextureAtlas& atlas : atlases) {
+        int32_t description[5] = {atlas.channels, atlas.layerSize, atlas.gutter, (int32_t)atlas.layers.size(), (int32_t)atlas.entries.size()};
+        write(description, sizeof(description));
+        for (const TextureAtlasEntry& entry : atlas.entries) {
+            int32_t rect[6] = {(int32_t)entry.name.size(), (int32_t)entry.layer, entry.x, entry.y, entry.width, entry.height};
+            write(rect, sizeof(rect));
+            write(entry.name.data(), entry.name.size());
+        }
+        for (const std::vector<unsigned char>& layer : atlas.layers) write(layer.data(), layer.size());
+    }
+    return (bool)file;
+}
+
+// Load a cache file, false when missing, invalid or built from other sources (key mismatch). Counts and rectangles
+// are checked before anything is allocated or used: a corrupt or truncated file never yields out of range layers
+inline bool loadTextureAtlases (const std::string& cacheFilePath, std::vector<TextureAtlas>& atlases, uint64_t key)
+{
+    std::ifstream file(cacheFilePath, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0);
+    auto read = [&file](void* data, size_t size) { return (bool)file.read(reinterpret_cast<char*>(data), (std::streamsize)size); };
+
+    uint32_t header[3];
+    uint64_t fileKey;
+    if (!read(header, sizeof(header)) || !read(&fileKey, sizeof(fileKey))) return false;
+    if (header[0] != TEXTURE_ATLAS_MAGIC || header[1] != TEXTURE_ATLAS_VERSION || fileKey != key) return false;
+    if (header[2] > 4) return false;                     // One atlas per channel count
+
+    atlases.assign(header[2], TextureAtlas());
+    for (TextureAtlas& atlas : atlases) {
+        int32_t description[5];
+        if (!read(description, sizeof(description))) return false;
+        atlas.channels = description[0];
+        atlas.layerSize = description[1];
+        atlas.gutter = description[2];
+        if (atlas.channels < 1 || atlas.channels > 4 || atlas.layerSize <= 0 || atlas.layerSize > 16384) return false;
+        if (description[3] < 0 || description[3] > TEXTURE_ATLAS_MAX_LAYERS || description[4] < 0 || description[4] > TEXTURE_ATLAS_MAX_ENTRIES) return false;
+        uint64_t layerBytes = (uint64_t)atlas.layerSize * atlas.layerSize * atlas.channels;
+        if (layerBytes * description[3] > fileSize) return false;    // Truncated / stale file: layers can't be in it
+
+        float size = (float)atlas.layerSize;
+        atlas.entries.resize(description[4]);
+        for (TextureAtlasEntry& entry : atlas.entries) {
+            int32_t rect[6];
+            if (!read(rect, sizeof(rect)) || rect[0] < 0 || rect[0] > 4096) return false;
+            entry.name.resize(rect[0]);
+            if (!read(entry.name.data(), entry.name.size())) return false;
+            entry.layer = (unsigned int)rect[1];
+            entry.x = rect[2];
+            entry.y = rect[3];
+            entry.width = rect[4];
+            entry.height = rect[5];
+            if (rect[1] < 0 || rect[1] >= description[3] || entry.x < 0 || entry.y < 0 || entry.width <= 0 || entry.height <= 0 ||
+                entry.x + entry.width > atlas.layerSize || entry.y + entry.height > atlas.layerSize) return false;
+            entry.uvRect = glm::vec4(entry.x / size, entry.y / size, entry.width / size, entry.height / size);
+        }
+        atlas.layers.resize(description[3]);
+        for (std::vector<unsigned char>& layer : atlas.layers) {
+            layer.resize((size_t)atlas.layerSize * atlas.layerSize * atlas.channels);
+            if (!read(layer.data(), layer.size())) return false;
+        }
+    }
+    return true;
+}
+
+// Atlases for a set of images: the cache when it is up to date, packed (and cached) otherwise
+inline std::vector<TextureAtlas> packTextures (const std::string& cacheFilePath, const std::vector<std::string>& imageFilePaths,
+                                               int layerSize = TEXTURE_ATLAS_LAYER_SIZE, int gutter = TEXTURE_ATLAS_GUTTER)
+{
+    std::vector<TextureAtlas> atlases;
+    uint64_t key = textureAtlasKey(imageFilePaths, layerSize, gutter);
+    if (loadTextureAtlases(cacheFilePath, atlases, key)) return atlases;
+
+    TexturePacker packer;
+    packer.layerSize = layerSize;
+    packer.gutter = gutter;
+    for (const std::string& path : imageFilePaths) packer.addFile(path);
+    atlases = packer.pack();
+    saveTextureAtlases(cacheFilePath, atlases, key);
+    return atlases;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// Async IO Benchmark: reads many large files with blocking std::ifstream, the thread pool backend and io_uring
+// Reports throughput, reads in flight (queue depth) and latency per priority
+// Usage: AsyncIOBenchmark [directory] [file count] [file size MB]   (the files are created, then deleted)
+#include "../AsyncIO.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <filesystem>
+
+#if defined(__linux__)
+    #include <fcntl.h>   // posix_fadvise
+#endif
+
+double elapsedMs (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Drop the files from the page cache (Linux) so every run reads from the device
+void evictFiles (const std::vector<std::string>& files)
+{
+#if defined(__linux__)
+    for (const std::string& file : files) {
+        int handle = ::open(file.c_str(), O_RDONLY);
+        if (handle < 0) continue;
+        fdatasync(handle);
+        posix_fadvise(handle, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(handle);
+    }
+#else
+    (void)files;
+#endif
+}
+
+void report (const std::string& name, double ms, unsigned long long bytes, double depth, unsigned int depthMax)
+{
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << ms << " ms" << std::setw(10) << (double)bytes / (1024.0 * 1024.0) / (ms / 1000.0) << " MB/s"
+              << "   depth " << std::setprecision(1) << depth << " (max " << depthMax << ")" << std::endl;
+}
+
+void benchmarkBackend (AsyncIOBackend backend, const std::vector<std::string>& files)
+{
+    AsyncIO io(backend);
+    if (backend == IO_BACKEND_URING && io.backend != IO_BACKEND_URING) {
+        std::cout << std::left << std::setw(16) << "io_uring" << "unavailable (kernel / seccomp)" << std::endl;
+        return;
+    }
+
+    // Half the files as prefetch first, then the other half as visible: visible reads should overtake
+    std::mutex latencyMutex;
+    double latency[IO_PRIORITY_COUNT] = {};
+    unsigned int count[IO_PRIORITY_COUNT] = {};
+
+    evictFiles(files);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < files.size(); f++) {
+        AsyncIOPriority priority = (f < files.size() / 2) ? IO_PRIORITY_PREFETCH : IO_PRIORITY_VISIBLE;
+        io.read(files[f], priority, [&, priority](AsyncReadResult& result) {
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latency[priority] += result.latencyMs;
+            count[priority]++;
+        });
+    }
+    io.drain();
+    double ms = elapsedMs(start);
+
+    report(io.backendName(), ms, io.bytesRead.load(), io.averageQueueDepth(), io.depthMax.load());
+    std::cout << "                  latency: visible " << std::setprecision(1) << latency[IO_PRIORITY_VISIBLE] / std::max(1u, count[IO_PRIORITY_VISIBLE])
+              << " ms, prefetch " << latency[IO_PRIORITY_PREFETCH] / std::max(1u, count[IO_PRIORITY_PREFETCH]) << " ms";
+    if (io.filesFailed.load()) std::cout << "  (" << io.filesFailed.load() << " failed)";
+    std::cout << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+    std::string directory = (argc > 1) ? argv[1] : "./_asyncio_benchmark";
+    unsigned int fileCount = (argc > 2) ? (unsigned int)std::stoul(argv[2]) : 32;
+    size_t fileSize = ((argc > 3) ? std::stoul(argv[3]) : 8) * 1024 * 1024;
+
+    // Files
+    std::filesystem::create_directories(directory);
+    std::vector<std::string> files;
+    std::vector<unsigned char> data(fileSize);
+    std::mt19937 random(7);
+    for (unsigned char& byte : data) byte = (unsigned char)random();
+    for (unsigned int f = 0; f < fileCount; f++) {
+        files.push_back(directory + "/file" + std::to_string(f) + ".bin");
+        std::ofstream file(files.back(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+    }
+    std::cout << "Files: " << fileCount << " x " << fileSize / (1024 * 1024) << " MB" << std::endl;
+
+    // Blocking reads, one file after the other
+    evictFiles(files);
+    auto start = std::chrono::steady_clock::now();
+    unsigned long long bytes = 0;
+    for (const std::string& path : files) {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        bytes += contents.size();
+    }
+    report("ifstream", elapsedMs(start), bytes, 1.0, 1);
+
+    benchmarkBackend(IO_BACKEND_THREADS, files);
+    benchmarkBackend(IO_BACKEND_URING, files);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
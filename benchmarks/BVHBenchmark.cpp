@@ -0,0 +1,107 @@
+// BVH Benchmark: build (1 thread / all threads), ray casts, nearest point queries and refit on the Archive models
+// Run from the repository root, or pass model paths as arguments
+#include "../Model.h"
+#include "../BVH.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+
+double elapsedMs (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkModel (const std::string& modelFilePath, int rayCount)
+{
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    if (!loadModel(modelFilePath, vertices, indices)) return;
+
+    std::vector<glm::vec3> positions(vertices.size());
+    glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+    for (size_t v = 0; v < vertices.size(); v++) {
+        positions[v] = vertices[v].Position;
+        boundsMin = glm::min(boundsMin, positions[v]);
+        boundsMax = glm::max(boundsMax, positions[v]);
+    }
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    float radius = glm::length(boundsMax - boundsMin) * 0.5f + 1e-3f;
+
+    std::cout << modelFilePath << ": " << indices.size() / 3 << " triangles" << std::endl;
+
+    // Build
+    BVH bvh;
+    for (unsigned int threads : {1u, jobSystem().threadCount()}) {
+        double best = 1e30;
+        for (int r = 0; r < 5; r++) {
+            auto start = std::chrono::steady_clock::now();
+            bvh.buildTriangles(positions, indices, threads);
+            best = std::min(best, elapsedMs(start));
+        }
+        std::cout << "  build " << std::setw(2) << threads << " thread(s)  " << std::fixed << std::setprecision(3) << best << " ms  ("
+                  << bvh.nodes.size() << " nodes)" << std::endl;
+    }
+
+    // Rays from a sphere around the model towards random points inside its bounds
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<BVHRay> rays(rayCount);
+    for (BVHRay& ray : rays) {
+        glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(1e-4f));
+        glm::vec3 target = center + (boundsMax - boundsMin) * 0.5f * glm::vec3(unit(random), unit(random), unit(random));
+        ray.origin = center + direction * radius * 2.0f;
+        ray.direction = glm::normalize(target - ray.origin);
+        ray.tMax = 1e30f;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned int hits = 0;
+    for (const BVHRay& ray : rays) {
+        BVHHit hit;
+        hits += bvh.raycast(ray, hit);
+    }
+    double rayMs = elapsedMs(start);
+    std::cout << "  raycast     " << rayCount / rayMs / 1000.0 << " Mrays/s  (" << 100.0 * hits / rayCount << "% hit)" << std::endl;
+
+    // Mouse picking: ray through the center of a 1920x1080 viewport looking at the model
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, radius * 10.0f)
+                             * glm::lookAt(center + glm::vec3(0.0f, 0.0f, radius * 2.5f), center, glm::vec3(0.0f, 1.0f, 0.0f));
+    BVHHit pick;
+    if (bvh.raycast(pickingRay(viewProjection, glm::vec2(960.0f, 540.0f), glm::vec2(1920.0f, 1080.0f)), pick))
+        std::cout << "  pick        triangle " << pick.primitive << " at t = " << pick.t << std::endl;
+
+    // Nearest point queries from random points around the model
+    start = std::chrono::steady_clock::now();
+    int queries = rayCount / 4;
+    for (int q = 0; q < queries; q++) {
+        glm::vec3 point = center + glm::vec3(unit(random), unit(random), unit(random)) * radius;
+        glm::vec3 closest;
+        unsigned int primitive;
+        bvh.nearestPoint(point, 1e30f, closest, primitive);
+    }
+    std::cout << "  nearest     " << queries / elapsedMs(start) / 1000.0 << " Mqueries/s" << std::endl;
+
+    // Refit after a deformation
+    for (glm::vec3& position : bvh.positions) position += glm::vec3(0.0f, 0.01f * position.x, 0.0f);
+    start = std::chrono::steady_clock::now();
+    bvh.refit();
+    std::cout << "  refit       " << elapsedMs(start) << " ms" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+    std::vector<std::string> models;
+    for (int i = 1; i < argc; i++) models.push_back(argv[i]);
+    if (models.empty())
+        models = {"./Archive/3DModels/cube/cube.obj", "./Archive/3DModels/cylinder/cylinder.obj", "./Archive/3DModels/pyramid/pyramid.obj",
+                  "./Archive/3DModels/quad/quad.obj", "./Archive/3DModels/sphere/sphere.obj", "./Archive/3DModels/human/Base.stl"};
+
+    for (const std::string& model : models)
+        benchmarkModel(model, 200000);
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+@echo off
+:: Set project_dir to the root of the repository
+:: %~dp0 : permanent directory containing the batch script.
+set project_dir=%~dp0..
+
+:: Compile the benchmarks (optimized, native SIMD)
+echo Compiling Benchmarks
+g++ -std=c++20 -O2 -march=native CullingBenchmark.cpp -o CullingBenchmark ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 -march=native JobSystemBenchmark.cpp -o JobSystemBenchmark
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 -march=native BVHBenchmark.cpp -o BVHBenchmark ^
+-I"%project_dir%/include" ^
+-L"%project_dir%/lib" ^
+-lassimp
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 -march=native AsyncIOBenchmark.cpp -o AsyncIOBenchmark
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 -march=native DecodeBenchmark.cpp DecodeScalar.cpp ../ImageDecoder.cpp -o DecodeBenchmark ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 -march=native LargeDecodeBenchmark.cpp ../ImageDecoder.cpp -o LargeDecodeBenchmark ^
+-DIMAGE_DECODER_LIBJPEG ^
+-I"%project_dir%/include" ^
+-L"%project_dir%/lib" ^
+-ljpeg -lpng -lz
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+pause
@@ -0,0 +1,70 @@
+// Culling Benchmark: frustum culling of 1M random objects (scalar, SIMD, SIMD + threads)
+#include "../Camera.h"
+#include "../Culling.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+
+// Best and average time of a function over a number of runs (milliseconds)
+void benchmark (const std::string& name, unsigned int objects, int runs, const std::function<unsigned int()>& function)
+{
+    double best = 1e30, total = 0.0;
+    unsigned int visible = 0;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        visible = function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << best << " ms best" << std::setw(10) << total / runs << " ms avg"
+              << std::setw(10) << objects / best / 1000.0 << " Mobj/s" << "  visible " << visible << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+    unsigned int objectCount = (argc > 1) ? (unsigned int)std::stoul(argv[1]) : 1000000;
+    int runs = (argc > 2) ? std::stoi(argv[2]) : 20;
+
+    // Random boxes in a 2 km cube around a camera looking down -Z
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 10.0f);
+    CullingBounds bounds;
+    bounds.reserve(objectCount);
+    for (unsigned int i = 0; i < objectCount; i++) {
+        glm::vec3 center(position(random), position(random), position(random));
+        glm::vec3 extent(size(random), size(random), size(random));
+        bounds.add(center - extent, center + extent);
+    }
+
+    Camera camera(glm::vec3(0.0f));
+    camera.aspect = 16.0f / 9.0f;
+    Frustum frustum = camera.frustum();
+
+    std::cout << "Objects: " << objectCount << "  SIMD width: " << CULLING_SIMD_WIDTH
+              << "  Threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    std::vector<unsigned int> visible(objectCount);
+    for (CullingVolume volume : {CULL_SPHERE, CULL_AABB}) {
+        std::string suffix = (volume == CULL_SPHERE) ? " (sphere)" : " (aabb)";
+        benchmark("scalar" + suffix, objectCount, runs, [&]() {
+            return cullScalar(bounds, frustum, volume, 0, objectCount, visible.data());
+        });
+        benchmark("simd" + suffix, objectCount, runs, [&]() {
+            return cullSimd(bounds, frustum, volume, 0, objectCount, visible.data());
+        });
+        benchmark("simd + threads" + suffix, objectCount, runs, [&]() {
+            cullObjects(bounds, frustum, visible, volume);
+            return (unsigned int)visible.size();
+        });
+        visible.resize(objectCount);
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Decode Benchmark: image decoding from memory per backend (stb_image scalar / SIMD, libjpeg-turbo), a corpus decoded
+// on one thread and one image per job on the job system, and atlas packing of the decoded images
+// Usage: DecodeBenchmark [runs] [--copies n] [image or directory]...  (default: the archive images, from the repository root)
+#include "../ImageDecoder.h"
+#include "../TexturePacker.h"
+#include "../JobSystem.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <iterator>
+
+// stb_image compiled without SIMD (DecodeScalar.cpp)
+unsigned char* decodeScalar (const unsigned char* encodedData, size_t encodedSize, int& width, int& height, int& channels);
+void decodeScalarFree (unsigned char* pixels);
+
+// Best and average time of a function over a number of runs (milliseconds), throughput in megapixels per second
+void benchmark (const std::string& name, double megapixels, int runs, const std::function<void()>& function)
+{
+    double best = 1e30, total = 0.0;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << best << " ms best" << std::setw(10) << total / runs << " ms avg"
+              << std::setw(10) << megapixels / best * 1000.0 << " MPix/s" << std::endl;
+}
+
+// Encoded file in memory: the decoder is measured, not the disk
+struct EncodedImage {
+    std::string name;
+    std::vector<unsigned char> bytes;
+    int width, height, channels;
+};
+
+int main (int argc, char** argv)
+{
+    int runs = (argc > 1) ? std::stoi(argv[1]) : 20;
+    unsigned int copies = 16;
+    std::vector<std::string> imageFilePaths;
+    for (int a = 2; a < argc; a++) {
+        std::string argument = argv[a];
+        if (argument == "--copies" && a + 1 < argc) { copies = (unsigned int)std::stoul(argv[++a]); continue; }
+        if (std::filesystem::is_directory(argument)) {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(argument)) {
+                std::string extension = entry.path().extension().string();
+                if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp"))
+                    imageFilePaths.push_back(entry.path().generic_string());
+            }
+        } else {
+            imageFilePaths.push_back(argument);
+        }
+    }
+    if (imageFilePaths.empty()) imageFilePaths = {"./Archive/Images/Img.jpg", "./Archive/Images/Img.png"};
+
+    std::vector<EncodedImage> images;
+    for (const std::string& imageFilePath : imageFilePaths) {
+        std::ifstream file(imageFilePath, std::ios::binary);
+        EncodedImage image = {imageFilePath, std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()), 0, 0, 0};
+        if (image.bytes.empty() || !imageInfo(image.bytes.data(), image.bytes.size(), image.width, image.height, image.channels)) {
+            std::cout << "Failed to read the image: " << imageFilePath << std::endl;
+            continue;
+        }
+        images.push_back(std::move(image));
+    }
+    if (images.empty()) return 1;
+
+    bool libjpeg = imageBackendAvailable(IMAGE_BACKEND_LIBJPEG);
+    std::cout << "stb_image SIMD: " << imageDecoderSimd() << "  libjpeg-turbo: " << (libjpeg ? "yes" : "no")
+              << "  job threads: " << jobSystem().threadCount() << std::endl;
+
+    // Per image: scalar vs SIMD stb_image, libjpeg-turbo for JPEG
+    for (const EncodedImage& image : images) {
+        double megapixels = image.width * image.height / 1e6;
+        benchmark("stb scalar " + image.name, megapixels, runs, [&]() {
+            int width, height, channels;
+            decodeScalarFree(decodeScalar(image.bytes.data(), image.bytes.size(), width, height, channels));
+        });
+        benchmark(std::string("stb ") + imageDecoderSimd() + " " + image.name, megapixels, runs, [&]() {
+            DecodedImage decoded;
+            decodeImage(image.bytes.data(), image.bytes.size(), decoded, 0, IMAGE_BACKEND_STB);
+        });
+        DecodedImage probe;
+        if (libjpeg && decodeImage(image.bytes.data(), image.bytes.size(), probe, 0, IMAGE_BACKEND_LIBJPEG))
+            benchmark("libjpeg-turbo " + image.name, megapixels, runs, [&]() {
+                DecodedImage decoded;
+                decodeImage(image.bytes.data(), image.bytes.size(), decoded, 0, IMAGE_BACKEND_LIBJPEG);
+            });
+    }
+
+    // Corpus: every image copies times, one thread vs one image per job (how Residency streams)
+    unsigned int corpusSize = (unsigned int)images.size() * copies;
+    double corpusMegapixels = 0.0;
+    for (const EncodedImage& image : images) corpusMegapixels += copies * image.width * image.height / 1e6;
+    std::vector<DecodedImage> decoded(corpusSize);
+    int corpusRuns = std::max(1, runs / 4);
+
+    const ImageBackend backends[2] = {IMAGE_BACKEND_STB, IMAGE_BACKEND_AUTO};
+    for (ImageBackend backend : backends) {
+        if (backend == IMAGE_BACKEND_AUTO && !libjpeg) continue;
+        std::string backendName = (backend == IMAGE_BACKEND_STB) ? "stb" : "auto";
+        benchmark("corpus " + std::to_string(corpusSize) + " " + backendName + " 1 thread", corpusMegapixels, corpusRuns, [&]() {
+            for (unsigned int i = 0; i < corpusSize; i++) {
+                const EncodedImage& image = images[i % images.size()];
+                decodeImage(image.bytes.data(), image.bytes.size(), decoded[i], 0, backend);
+            }
+        });
+        benchmark("corpus " + std::to_string(corpusSize) + " " + backendName + " per image jobs", corpusMegapixels, corpusRuns, [&]() {
+            jobSystem().parallelFor(corpusSize, 1, [&](unsigned int begin, unsigned int end) {
+                for (unsigned int i = begin; i < end; i++) {
+                    const EncodedImage& image = images[i % images.size()];
+                    decodeImage(image.bytes.data(), image.bytes.size(), decoded[i], 0, backend);
+                }
+            });
+        });
+    }
+
+    // Atlas packing of the decoded corpus
+    TexturePacker packer;
+    for (unsigned int i = 0; i < corpusSize; i++)
+        packer.add(images[i % images.size()].name + "#" + std::to_string(i), decoded[i].pixels, decoded[i].width, decoded[i].height, decoded[i].channels);
+    benchmark("pack " + std::to_string(corpusSize) + " images", corpusMegapixels, corpusRuns, [&]() { packer.pack(); });
+
+    return 0;
+}
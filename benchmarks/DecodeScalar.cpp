@@ -0,0 +1,20 @@
+// stb_image without SIMD, private to this file (STB_IMAGE_STATIC): the scalar baseline of DecodeBenchmark
+#if defined(__GNUC__)
+    #pragma GCC diagnostic ignored "-Wunused-function"    // Static copy: most of the API is unused here
+#endif
+#define STB_IMAGE_STATIC
+#define STBI_NO_SIMD
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image/stb_image.h>
+
+#include <cstddef>
+
+unsigned char* decodeScalar (const unsigned char* encodedData, size_t encodedSize, int& width, int& height, int& channels)
+{
+    return stbi_load_from_memory(encodedData, (int)encodedSize, &width, &height, &channels, 0);
+}
+
+void decodeScalarFree (unsigned char* pixels)
+{
+    stbi_image_free(pixels);
+}
@@ -0,0 +1,75 @@
+// Job System Benchmark: scaling of parallelFor on an embarrassingly parallel workload (1..N threads); the 1 thread
+// row is a job system without workers (everything on the calling thread), the baseline of the speedups
+// Also checks work stealing on uneven jobs and dependency counters
+#include "../JobSystem.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+// Work item: a few hundred flops per element, no shared writes
+inline float workItem (unsigned int i)
+{
+    float x = (float)i * 0.001f;
+    for (int k = 0; k < 16; k++) x = std::sin(x) * 0.5f + std::cos(x * 0.7f);
+    return x;
+}
+
+double elapsedMs (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main (int argc, char** argv)
+{
+    unsigned int items = (argc > 1) ? (unsigned int)std::stoul(argv[1]) : (1u << 20);
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<float> output(items);
+
+    std::cout << "Items: " << items << "  Cores: " << maxThreads << std::endl;
+    std::cout << "threads      time (ms)   speedup   efficiency" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2) {
+        JobSystem jobs(threads - 1);
+
+        double best = 1e30;
+        for (int run = 0; run < 5; run++) {
+            auto start = std::chrono::steady_clock::now();
+            jobs.parallelFor(items, 4096, [&](unsigned int begin, unsigned int end) {
+                for (unsigned int i = begin; i < end; i++) output[i] = workItem(i);
+            });
+            best = std::min(best, elapsedMs(start));
+        }
+        if (threads == 1) baseline = best;
+
+        double speedup = baseline / best;
+        std::cout << std::setw(7) << threads << std::fixed << std::setprecision(3) << std::setw(15) << best
+                  << std::setw(10) << speedup << "x" << std::setw(11) << std::setprecision(1) << 100.0 * speedup / threads << "%" << std::endl;
+
+        // Uneven jobs: cost grows with the index, stealing keeps every worker busy
+        auto start = std::chrono::steady_clock::now();
+        JobCounter counter;
+        for (unsigned int j = 0; j < 256; j++)
+            jobs.run([&output, j]() { for (unsigned int i = 0; i < j * 16; i++) output[j] += workItem(i); }, &counter);
+        jobs.wait(counter);
+        double uneven = elapsedMs(start);
+
+        // Dependencies: stage B starts only after every stage A job finished
+        JobCounter stageA, stageB;
+        std::atomic<unsigned int> finishedA(0);
+        bool ordered = true;
+        for (unsigned int j = 0; j < 64; j++)
+            jobs.run([&finishedA]() { workItem(1); finishedA++; }, &stageA);
+        jobs.runAfter(stageA, [&finishedA, &ordered]() { ordered = finishedA.load() == 64; }, &stageB);
+        jobs.wait(stageB);
+
+        std::cout << "        uneven jobs " << std::setprecision(3) << uneven << " ms, dependencies " << (ordered ? "ok" : "FAILED") << std::endl;
+
+        if (threads == maxThreads) break;
+    }
+
+    return 0;
+}
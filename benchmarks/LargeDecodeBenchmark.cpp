@@ -0,0 +1,173 @@
+// Large Decode Benchmark: one very large image decoded by stbi_load vs ImageDecoder on one thread vs split in stripes over
+// the job system, into staging memory (what a mapped pixel unpack buffer gets). The images are the archive images
+// upscaled (bilinear) to a width of 8K and encoded again: JPEG without / with a restart marker every MCU row, PNG with the
+// encoder's adaptive filters / with a None filtered row every 64 rows (stripe starts for the parallel unfilter)
+// Usage: LargeDecodeBenchmark [runs] [--width n] [image]...  (default: the archive images, from the repository root)
+#include "../ImageDecoder.h"
+#include "../JobSystem.h"
+
+#include <stb_image/stb_image.h>      // Declarations only: the implementation is in ImageDecoder.cpp
+#include <cstdio>                     // jpeglib.h needs FILE
+#include <jpeglib.h>
+#include <png.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <cstring>
+#include <cstdlib>
+
+// Best and average time of a function over a number of runs (milliseconds), throughput in megapixels per second
+void benchmark (const std::string& name, double megapixels, int runs, const std::function<void()>& function)
+{
+    double best = 1e30, total = 0.0;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << best << " ms best" << std::setw(10) << total / runs << " ms avg"
+              << std::setw(10) << megapixels / best * 1000.0 << " MPix/s" << std::endl;
+}
+
+// Bilinear upscale of an RGB image
+std::vector<unsigned char> upscale (const unsigned char* pixels, int width, int height, int newWidth, int newHeight)
+{
+    std::vector<unsigned char> scaled((size_t)newWidth * newHeight * 3);
+    jobSystem().parallelFor((unsigned int)newHeight, 64, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int y = begin; y < end; y++) {
+            float sy = std::max(0.0f, (y + 0.5f) * height / newHeight - 0.5f);
+            int y0 = std::min((int)sy, height - 1), y1 = std::min(y0 + 1, height - 1);
+            float fy = sy - y0;
+            for (int x = 0; x < newWidth; x++) {
+                float sx = std::max(0.0f, (x + 0.5f) * width / newWidth - 0.5f);
+                int x0 = std::min((int)sx, width - 1), x1 = std::min(x0 + 1, width - 1);
+                float fx = sx - x0;
+                for (int c = 0; c < 3; c++) {
+                    float top = pixels[((size_t)y0 * width + x0) * 3 + c] * (1 - fx) + pixels[((size_t)y0 * width + x1) * 3 + c] * fx;
+                    float bottom = pixels[((size_t)y1 * width + x0) * 3 + c] * (1 - fx) + pixels[((size_t)y1 * width + x1) * 3 + c] * fx;
+                    scaled[((size_t)y * newWidth + x) * 3 + c] = (unsigned char)(top * (1 - fy) + bottom * fy + 0.5f);
+                }
+            }
+        }
+    });
+    return scaled;
+}
+
+// JPEG (libjpeg), quality 90, 4:2:0; restartRows: a restart marker every n MCU rows (0: none)
+std::vector<unsigned char> encodeJPEG (const unsigned char* pixels, int width, int height, int restartRows)
+{
+    jpeg_compress_struct encoder;
+    jpeg_error_mgr error;
+    encoder.err = jpeg_std_error(&error);
+    jpeg_create_compress(&encoder);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&encoder, &buffer, &size);
+    encoder.image_width = width;
+    encoder.image_height = height;
+    encoder.input_components = 3;
+    encoder.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&encoder);
+    jpeg_set_quality(&encoder, 90, TRUE);
+    encoder.restart_in_rows = restartRows;
+    jpeg_start_compress(&encoder, TRUE);
+    while (encoder.next_scanline < encoder.image_height) {
+        JSAMPROW row = (JSAMPROW)pixels + (size_t)encoder.next_scanline * width * 3;
+        jpeg_write_scanlines(&encoder, &row, 1);
+    }
+    jpeg_finish_compress(&encoder);
+    jpeg_destroy_compress(&encoder);
+    std::vector<unsigned char> encoded(buffer, buffer + size);
+    std::free(buffer);
+    return encoded;
+}
+
+// PNG (libpng), adaptive filters; noneEvery: every n rows filtered with None (0: the encoder picks every row). The first
+// row is written with every filter allowed: libpng only allocates the Up / Average / Paeth buffers when they are allowed
+// at the first row
+std::vector<unsigned char> encodePNG (const unsigned char* pixels, int width, int height, int noneEvery)
+{
+    std::vector<unsigned char> encoded;
+    png_structp encoder = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(encoder);
+    png_set_write_fn(encoder, &encoded, [](png_structp png, png_bytep data, png_size_t length) {
+        std::vector<unsigned char>* output = (std::vector<unsigned char>*)png_get_io_ptr(png);
+        output->insert(output->end(), data, data + length);
+    }, nullptr);
+    png_set_IHDR(encoder, info, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_set_filter(encoder, PNG_FILTER_TYPE_BASE, PNG_ALL_FILTERS);
+    png_write_info(encoder, info);
+    for (int y = 0; y < height; y++) {
+        if (noneEvery && y > 0) png_set_filter(encoder, PNG_FILTER_TYPE_BASE, (y % noneEvery == 0) ? PNG_FILTER_NONE : PNG_ALL_FILTERS);
+        png_write_row(encoder, (png_bytep)pixels + (size_t)y * width * 3);
+    }
+    png_write_end(encoder, info);
+    png_destroy_write_struct(&encoder, &info);
+    return encoded;
+}
+
+int main (int argc, char** argv)
+{
+    int runs = (argc > 1) ? std::stoi(argv[1]) : 3;
+    int targetWidth = 8192;
+    std::vector<std::string> imageFilePaths;
+    for (int a = 2; a < argc; a++) {
+        std::string argument = argv[a];
+        if (argument == "--width" && a + 1 < argc) { targetWidth = std::stoi(argv[++a]); continue; }
+        imageFilePaths.push_back(argument);
+    }
+    if (imageFilePaths.empty()) imageFilePaths = {"./Archive/Images/Img.jpg", "./Archive/Images/Img.png"};
+
+    std::cout << "job threads: " << jobSystem().threadCount() << "  libjpeg-turbo: " << (imageBackendAvailable(IMAGE_BACKEND_LIBJPEG) ? "yes" : "no") << std::endl;
+    for (const std::string& imageFilePath : imageFilePaths) {
+        DecodedImage source;
+        if (!decodeImageFile(imageFilePath, source, 3)) {
+            std::cout << "Failed to load the image: " << imageFilePath << " (" << imageDecodeError() << ")" << std::endl;
+            continue;
+        }
+        int width = targetWidth;
+        int height = (int)((long long)source.height * targetWidth / source.width);
+        std::vector<unsigned char> scaled = upscale(source.pixels, source.width, source.height, width, height);
+        double megapixels = (double)width * height / 1e6;
+
+        struct Encoding { std::string name; std::vector<unsigned char> bytes; };
+        std::vector<Encoding> encodings;
+        encodings.push_back({"jpeg", encodeJPEG(scaled.data(), width, height, 0)});
+        encodings.push_back({"jpeg restart", encodeJPEG(scaled.data(), width, height, 1)});
+        encodings.push_back({"png", encodePNG(scaled.data(), width, height, 0)});
+        encodings.push_back({"png none rows", encodePNG(scaled.data(), width, height, 64)});
+        scaled = std::vector<unsigned char>();
+
+        // Staging memory: one RGB image, rows tightly packed (GL_UNPACK_ALIGNMENT 1)
+        size_t rowPitch = (size_t)width * 3;
+        std::vector<unsigned char> serial(rowPitch * height), parallel(rowPitch * height);
+        std::cout << imageFilePath << " upscaled to " << width << "x" << height << std::endl;
+        for (const Encoding& encoding : encodings) {
+            const unsigned char* data = encoding.bytes.data();
+            size_t size = encoding.bytes.size();
+            std::cout << "  " << encoding.name << " (" << size / 1024 << " KB)" << std::endl;
+
+            benchmark("    stbi_load", megapixels, runs, [&]() {
+                int w, h, c;
+                stbi_image_free(stbi_load_from_memory(data, (int)size, &w, &h, &c, 3));
+            });
+            benchmark("    decoder, 1 thread", megapixels, runs, [&]() {
+                decodeImageInto(data, size, serial.data(), rowPitch, 3, IMAGE_BACKEND_AUTO, false);
+            });
+            unsigned int stripes = 1;
+            benchmark("    decoder, stripes on the job system", megapixels, runs, [&]() {
+                decodeImageInto(data, size, parallel.data(), rowPitch, 3, IMAGE_BACKEND_AUTO, true);
+                stripes = imageDecodeStripes();
+            });
+            std::cout << "    " << stripes << " stripes, " << (serial == parallel ? "same pixels as 1 thread" : "MISMATCH with 1 thread") << std::endl;
+        }
+    }
+    return 0;
+}
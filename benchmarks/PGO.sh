@@ -0,0 +1,81 @@
+#!/bin/sh
+# Profile guided optimization: baseline build, instrumented build, training run of the benchmark workload,
+# profile merge, optimized rebuild, then the speedup of every benchmark over the baseline (best wall time)
+# Usage (from anywhere): benchmarks/PGO.sh [build directory, relative to the repository root, default build-pgo] [timed runs, default 3]
+# Extra CMake options: PGO_CMAKE_OPTIONS="-DRENDERER_MARCH=native" benchmarks/PGO.sh
+set -e
+cd "$(dirname "$0")/.."
+build=${1:-build-pgo}
+runs=${2:-3}
+case "$build" in /*) ;; *) build="$PWD/$build" ;; esac
+profiles="$build/pgo/profiles"
+jobs=$(nproc 2>/dev/null || echo 4)
+
+# Workload (run from the repository root): name and arguments, scenes the CPU hot paths see
+workload() {
+    echo "CullingBenchmark 1000000 10"               # Large synthetic scene: 1M objects
+    echo "JobSystemBenchmark"
+    echo "DecodeBenchmark 10"                        # Archive/Images/Img.jpg, Img.png + atlas packing
+    echo "BVHBenchmark"                              # Archive/3DModels (Assimp import, BVH build / queries)
+}
+
+configure() {
+    directory=$1; shift
+    cmake -S . -B "$directory" -DCMAKE_BUILD_TYPE=Release $PGO_CMAKE_OPTIONS "$@" > /dev/null
+    cmake --build "$directory" -j"$jobs" > /dev/null
+}
+
+# Best wall time of a benchmark in milliseconds (empty when it was not built)
+measure() {
+    directory=$1; shift
+    name=$1; shift
+    [ -x "$directory/benchmarks/$name" ] || return 0
+    best=""
+    run=0
+    while [ "$run" -lt "$runs" ]; do
+        start=$(date +%s%N)
+        "$directory/benchmarks/$name" "$@" > /dev/null
+        end=$(date +%s%N)
+        ms=$(( (end - start) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+        run=$((run + 1))
+    done
+    echo "$best"
+}
+
+echo "Baseline build ($build/base)"
+configure "$build/base" -DRENDERER_PGO=OFF
+
+echo "Instrumented build ($build/pgo)"
+rm -rf "$profiles"
+mkdir -p "$profiles"
+configure "$build/pgo" -DRENDERER_PGO=GENERATE -DRENDERER_PGO_DIR="$profiles"
+
+echo "Training run"
+workload | while read -r name arguments; do
+    if [ -x "$build/pgo/benchmarks/$name" ]; then
+        echo "  $name $arguments"
+        "$build/pgo/benchmarks/$name" $arguments > /dev/null
+    fi
+done
+
+# GCC adds every run into the same .gcda files; Clang writes one .profraw per process to merge
+if ls "$profiles"/*.profraw > /dev/null 2>&1; then
+    echo "Merging profiles"
+    llvm-profdata merge -output="$profiles/default.profdata" "$profiles"/*.profraw
+fi
+
+echo "Optimized build ($build/pgo)"
+configure "$build/pgo" -DRENDERER_PGO=USE -DRENDERER_PGO_DIR="$profiles"
+
+echo "Speedup (best of $runs runs, wall time)"
+printf "%-22s %10s %10s %9s\n" "benchmark" "base ms" "pgo ms" "speedup"
+workload | while read -r name arguments; do
+    base=$(measure "$build/base" "$name" $arguments)
+    pgo=$(measure "$build/pgo" "$name" $arguments)
+    if [ -z "$base" ] || [ -z "$pgo" ]; then
+        printf "%-22s %10s\n" "$name" "not built"
+        continue
+    fi
+    printf "%-22s %10s %10s %8sx\n" "$name" "$base" "$pgo" "$(awk "BEGIN { printf \"%.2f\", $base / ($pgo > 0 ? $pgo : 1) }")"
+done
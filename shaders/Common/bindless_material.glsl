@@ -0,0 +1,12 @@
+// Material table (Bindless.h): resident texture handle (bindless) or layer (texture array fallback) + UV rectangle
+// Included by the fragment shaders (ShaderPreprocessor.h)
+#pragma once
+
+struct BindlessMaterial {
+    uvec2 handle;
+    uint layer;
+    uint flags;
+    vec4 uvRect;
+};
+
+layout(std430, binding = 6) readonly buffer MaterialBuffer { BindlessMaterial materials[]; };
@@ -0,0 +1,37 @@
+#version 460 core
+
+// Depth pyramid level: max of the 2x2 source texels (3 wide on odd edges so no source texel is dropped)
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D csSource;                   // Depth texture (level 0) or the pyramid itself
+layout(r32f, binding = 0) uniform writeonly image2D csDestination; // Pyramid level being written
+
+uniform int csSourceLevel;
+
+void main()
+{
+    ivec2 destination = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destinationSize = imageSize(csDestination);
+    if (any(greaterThanEqual(destination, destinationSize))) return;
+
+    ivec2 sourceSize = textureSize(csSource, csSourceLevel);
+
+    // Level 0: copy the depth buffer
+    if (sourceSize == destinationSize) {
+        imageStore(csDestination, destination, vec4(texelFetch(csSource, destination, csSourceLevel).r));
+        return;
+    }
+
+    ivec2 first = destination * 2;
+    ivec2 last = first + 1;
+    if (destination.x == destinationSize.x - 1 && (sourceSize.x & 1) != 0) last.x++;
+    if (destination.y == destinationSize.y - 1 && (sourceSize.y & 1) != 0) last.y++;
+    last = min(last, sourceSize - 1);
+
+    float furthest = 0.0;
+    for (int y = first.y; y <= last.y; y++)
+        for (int x = first.x; x <= last.x; x++)
+            furthest = max(furthest, texelFetch(csSource, ivec2(x, y), csSourceLevel).r);
+
+    imageStore(csDestination, destination, vec4(furthest));
+}
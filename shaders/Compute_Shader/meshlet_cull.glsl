@@ -0,0 +1,75 @@
+#version 460 core
+
+// One work group per meshlet: invocation 0 tests the bounds, every invocation then copies one triangle
+layout(local_size_x = 128) in;
+
+struct MeshletBounds {
+    vec3 center;        // Bounding sphere
+    float radius;
+    vec3 coneAxis;      // Normal cone
+    float coneCutoff;   // sin(half angle), 1 = disabled
+};
+
+layout(std430, binding = 0) readonly buffer BoundsBuffer { MeshletBounds bounds[]; };
+layout(std430, binding = 1) readonly buffer MeshletBuffer { uvec4 meshlets[]; };               // vertexOffset, triangleOffset, vertexCount, triangleCount
+layout(std430, binding = 2) readonly buffer MeshletVertexBuffer { uint meshletVertices[]; };   // Local -> global vertex
+layout(std430, binding = 3) readonly buffer MeshletTriangleBuffer { uint meshletTriangles[]; }; // a | b << 8 | c << 16
+layout(std430, binding = 4) writeonly buffer IndexBuffer { uint indices[]; };                  // Compacted output
+layout(std430, binding = 5) buffer IndirectBuffer {                                            // DrawElementsIndirectCommand
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+} command;
+
+uniform vec4 csFrustum[6];        // Planes, normals pointing inside
+uniform vec3 csCameraPosition;
+uniform uint csMeshletCount;
+
+shared bool meshletVisible;
+shared uint writeOffset;
+
+bool visible(MeshletBounds b)
+{
+    // Frustum
+    for (int i = 0; i < 6; i++)
+        if (dot(csFrustum[i].xyz, b.center) + csFrustum[i].w < -b.radius)
+            return false;
+
+    // Backface cone
+    if (b.coneCutoff < 1.0) {
+        vec3 direction = b.center - csCameraPosition;
+        if (dot(direction, b.coneAxis) >= b.coneCutoff * length(direction) + b.radius * (1.0 + b.coneCutoff))
+            return false;
+    }
+
+    return true;
+}
+
+void main()
+{
+    uint meshletIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    if (meshletIndex >= csMeshletCount) return;   // Uniform across the work group
+
+    uvec4 meshlet = meshlets[meshletIndex];
+
+    // Test once, reserve space for every triangle of the meshlet
+    if (gl_LocalInvocationIndex == 0) {
+        meshletVisible = visible(bounds[meshletIndex]);
+        if (meshletVisible)
+            writeOffset = atomicAdd(command.count, meshlet.w * 3u);
+    }
+    barrier();
+
+    if (!meshletVisible) return;
+
+    // Copy triangles with global vertex indices
+    for (uint t = gl_LocalInvocationIndex; t < meshlet.w; t += gl_WorkGroupSize.x) {
+        uint packed = meshletTriangles[meshlet.y + t];
+        uint base = writeOffset + t * 3u;
+        indices[base + 0u] = meshletVertices[meshlet.x + (packed & 0xFFu)];
+        indices[base + 1u] = meshletVertices[meshlet.x + ((packed >> 8) & 0xFFu)];
+        indices[base + 2u] = meshletVertices[meshlet.x + ((packed >> 16) & 0xFFu)];
+    }
+}
@@ -0,0 +1,105 @@
+#version 460 core
+
+// Two phase occlusion culling, one invocation per object
+// Phase 0: append objects in the frustum that were visible last frame
+// Phase 1: test every object in the frustum against the depth pyramid, append the newly visible ones, store the flags
+layout(local_size_x = 64) in;
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+struct OcclusionObject {
+    vec4 boxMin;
+    vec4 boxMax;
+    DrawCommand command;
+    uint padding[3];
+};
+
+layout(std430, binding = 0) readonly buffer ObjectBuffer { OcclusionObject objects[]; };
+layout(std430, binding = 1) buffer VisibilityBuffer { uint visibility[]; };       // Persistent across frames
+layout(std430, binding = 2) writeonly buffer CommandBuffer { DrawCommand commands[]; };
+layout(std430, binding = 3) buffer DrawCountBuffer { uint drawCount; };
+
+layout(binding = 0) uniform sampler2D csDepthPyramid;   // Furthest depth per texel, full mip chain
+
+uniform mat4 csViewProjection;
+uniform vec4 csFrustum[6];
+uniform uint csObjectCount;
+uniform uint csPhase;
+uniform int csPyramidLevels;
+
+bool frustumVisible(vec3 boxMin, vec3 boxMax)
+{
+    for (int i = 0; i < 6; i++) {
+        vec3 positive = mix(boxMin, boxMax, greaterThanEqual(csFrustum[i].xyz, vec3(0.0)));
+        if (dot(csFrustum[i].xyz, positive) + csFrustum[i].w < 0.0)
+            return false;
+    }
+    return true;
+}
+
+bool occlusionVisible(vec3 boxMin, vec3 boxMax)
+{
+    // Screen rectangle and nearest depth of the 8 corners
+    vec2 uvMin = vec2(1.0), uvMax = vec2(0.0);
+    float nearest = 1.0;
+    for (int corner = 0; corner < 8; corner++) {
+        vec3 p = vec3((corner & 1) != 0 ? boxMax.x : boxMin.x, (corner & 2) != 0 ? boxMax.y : boxMin.y, (corner & 4) != 0 ? boxMax.z : boxMin.z);
+        vec4 clip = csViewProjection * vec4(p, 1.0);
+        if (clip.w <= 1e-5) return true;   // Crosses the near plane
+        vec3 ndc = clip.xyz / clip.w;
+        uvMin = min(uvMin, ndc.xy * 0.5 + 0.5);
+        uvMax = max(uvMax, ndc.xy * 0.5 + 0.5);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+
+    // Pixel rectangle at level 0, level where it touches at most 2x2 texels
+    ivec2 size = textureSize(csDepthPyramid, 0);
+    ivec2 p0 = min(ivec2(clamp(uvMin, 0.0, 1.0) * vec2(size)), size - 1);
+    ivec2 p1 = min(ivec2(clamp(uvMax, 0.0, 1.0) * vec2(size)), size - 1);
+    int extent = max(p1.x - p0.x, p1.y - p0.y) + 1;
+    int level = min(int(ceil(log2(float(extent)))), csPyramidLevels - 1);
+
+    ivec2 levelSize = textureSize(csDepthPyramid, level);
+    ivec2 t0 = min(p0 >> level, levelSize - 1);
+    ivec2 t1 = min(p1 >> level, levelSize - 1);
+
+    float furthest = 0.0;
+    for (int y = t0.y; y <= t1.y; y++)
+        for (int x = t0.x; x <= t1.x; x++)
+            furthest = max(furthest, texelFetch(csDepthPyramid, ivec2(x, y), level).r);
+
+    return max(nearest, 0.0) <= furthest;
+}
+
+void append(uint objectIndex)
+{
+    uint slot = atomicAdd(drawCount, 1u);
+    commands[slot] = objects[objectIndex].command;
+    commands[slot].baseInstance = objectIndex;   // Per object data through gl_BaseInstance
+}
+
+void main()
+{
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex >= csObjectCount) return;
+
+    vec3 boxMin = objects[objectIndex].boxMin.xyz;
+    vec3 boxMax = objects[objectIndex].boxMax.xyz;
+    bool inFrustum = frustumVisible(boxMin, boxMax);
+
+    if (csPhase == 0u) {
+        if (inFrustum && visibility[objectIndex] != 0u)
+            append(objectIndex);
+    } else {
+        bool visibleNow = inFrustum && occlusionVisible(boxMin, boxMax);
+        if (visibleNow && visibility[objectIndex] == 0u)
+            append(objectIndex);
+        visibility[objectIndex] = visibleNow ? 1u : 0u;
+    }
+}
@@ -0,0 +1,15 @@
+#version 460 core
+
+layout(location = 0) in vec3 Position;  // Input from vertex shader
+layout(location = 1) in vec4 Color;     
+layout(location = 2) in vec2 Tex;       // Atlas UV (remapped by remapTexCoords)
+
+layout(location = 0) out vec4 fsTextureColor;  // Output to the framebuffer
+
+layout(binding = 0) uniform sampler2DArray fsTexArray;   // Packed textures (TexturePacker.h), one binding per material group
+uniform float fsLayer;                                    // Atlas layer of the draw (TextureAtlasEntry::layer)
+
+void main() 
+{
+    fsTextureColor = texture(fsTexArray, vec3(Tex, fsLayer));
+}
@@ -0,0 +1,17 @@
+#version 460 core
+#extension GL_ARB_bindless_texture : require
+
+layout(location = 0) in vec3 Position;  // Input from vertex shader
+layout(location = 1) in vec4 Color;     
+layout(location = 2) in vec2 Tex;       
+layout(location = 3) flat in uint Material;    // Material ID of the draw (gl_BaseInstance)
+
+layout(location = 0) out vec4 fsTextureColor;  // Output to the framebuffer
+
+#include "Common/bindless_material.glsl"
+
+void main() 
+{
+    BindlessMaterial material = materials[Material];
+    fsTextureColor = texture(sampler2D(material.handle), material.uvRect.xy + Tex * material.uvRect.zw);
+}
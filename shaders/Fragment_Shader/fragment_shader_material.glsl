@@ -0,0 +1,18 @@
+#version 460 core
+
+layout(location = 0) in vec3 Position;  // Input from vertex shader
+layout(location = 1) in vec4 Color;     
+layout(location = 2) in vec2 Tex;       
+layout(location = 3) flat in uint Material;    // Material ID of the draw (gl_BaseInstance)
+
+layout(location = 0) out vec4 fsTextureColor;  // Output to the framebuffer
+
+// Fallback without ARB_bindless_texture: layer + UV rectangle in one texture array
+#include "Common/bindless_material.glsl"
+layout(binding = 0) uniform sampler2DArray fsTexArray;   // Packed textures (TexturePacker.h)
+
+void main() 
+{
+    BindlessMaterial material = materials[Material];
+    fsTextureColor = texture(fsTexArray, vec3(material.uvRect.xy + Tex * material.uvRect.zw, float(material.layer)));
+}
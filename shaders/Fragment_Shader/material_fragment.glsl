@@ -0,0 +1,37 @@
+#version 460 core
+// Material template (Material.h): the features are #defines inserted after #version
+// TEXTURED, VERTEX_COLOR, NORMAL_MAP, ALPHA_TEST, SKINNING
+
+layout(location = 1) in vec4 Color;     // Input from vertex shader (white without VERTEX_COLOR)
+layout(location = 2) in vec2 Tex;       
+#ifdef NORMAL_MAP
+layout(location = 4) in mat3 TangentToWorld;
+#endif
+
+layout(location = 0) out vec4 fsTextureColor;  // Output to the framebuffer
+
+uniform vec4 fsColor;                   // Base color factor
+uniform float fsAlphaCutoff;
+#ifdef TEXTURED
+layout(binding = 0) uniform sampler2D fsTex;
+#endif
+#ifdef NORMAL_MAP
+layout(binding = 1) uniform sampler2D fsNormalMap;
+const vec3 lightDirection = normalize(vec3(0.3, -1.0, -0.5));
+#endif
+
+void main() 
+{
+    vec4 color = fsColor * Color;
+#ifdef TEXTURED
+    color *= texture(fsTex, Tex);
+#endif
+#ifdef ALPHA_TEST
+    if (color.a < fsAlphaCutoff) discard;
+#endif
+#ifdef NORMAL_MAP
+    vec3 normal = normalize(TangentToWorld * (texture(fsNormalMap, Tex).xyz * 2.0 - 1.0));
+    color.rgb *= max(dot(normal, -lightDirection), 0.0) * 0.8 + 0.2;
+#endif
+    fsTextureColor = color;
+}
@@ -0,0 +1,32 @@
+#version 460 core
+// Tonemap (RenderTarget.h): linear scene color -> exposure -> operator -> sRGB encoded output
+
+layout(location = 2) in vec2 Tex;
+
+layout(location = 0) out vec4 fsDisplayColor;  // Output to the framebuffer (sRGB values, no GL_FRAMEBUFFER_SRGB)
+
+layout(binding = 0) uniform sampler2D fsScene; // Linear HDR target
+uniform float fsExposure;
+uniform int fsTonemap;                         // 0 clamp, 1 Reinhard, 2 ACES
+
+// ACES filmic curve, Narkowicz fit
+vec3 tonemapACES(vec3 x)
+{
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+// Linear -> sRGB transfer function (piecewise, not the 2.2 gamma approximation)
+vec3 encodeSRGB(vec3 linear)
+{
+    vec3 low = linear * 12.92;
+    vec3 high = 1.055 * pow(linear, vec3(1.0 / 2.4)) - 0.055;
+    return mix(low, high, step(vec3(0.0031308), linear));
+}
+
+void main() 
+{
+    vec3 color = max(texture(fsScene, Tex).rgb * fsExposure, 0.0);
+    if (fsTonemap == 1)      color = color / (1.0 + color);
+    else if (fsTonemap == 2) color = tonemapACES(color);
+    fsDisplayColor = vec4(encodeSRGB(clamp(color, 0.0, 1.0)), 1.0);
+}
@@ -0,0 +1,10 @@
+#version 460 core
+// Full screen triangle (RenderTarget.h): no vertex buffer, vertices 0, 1, 2 from gl_VertexID cover the viewport
+
+layout(location = 2) out vec2 vsTex;
+
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);   // (0, 0) (2, 0) (0, 2)
+    vsTex = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,48 @@
+#version 460 core
+// Material template (Material.h): the features are #defines inserted after #version
+// TEXTURED, VERTEX_COLOR, NORMAL_MAP, ALPHA_TEST, SKINNING
+
+layout(location = 0) in vec3 Position;
+layout(location = 1) in vec4 Color;        
+layout(location = 2) in vec2 Tex; 
+#ifdef NORMAL_MAP
+layout(location = 3) in vec3 Normal;
+layout(location = 4) in vec4 Tangent;            // xyz tangent, w bitangent sign
+#endif
+#ifdef SKINNING
+layout(location = 5) in uvec4 BoneIndices;
+layout(location = 6) in vec4 BoneWeights;
+layout(std430, binding = 7) readonly buffer BoneBuffer { mat4 bones[]; };
+#endif
+
+layout(location = 1) out vec4 vsColor;
+layout(location = 2) out vec2 vsTex;
+#ifdef NORMAL_MAP
+layout(location = 4) out mat3 vsTangentToWorld;  // Locations 4 - 6
+#endif
+
+uniform mat4 vsModel;            // Object -> world
+uniform mat4 vsViewProjection;   // World -> clip (Camera)
+
+void main() {
+    mat4 model = vsModel;
+#ifdef SKINNING
+    model = vsModel * (bones[BoneIndices.x] * BoneWeights.x + bones[BoneIndices.y] * BoneWeights.y +
+                       bones[BoneIndices.z] * BoneWeights.z + bones[BoneIndices.w] * BoneWeights.w);
+#endif
+    gl_Position = vsViewProjection * model * vec4(Position, 1.0);
+
+#ifdef VERTEX_COLOR
+    vsColor = Color;
+#else
+    vsColor = vec4(1.0);
+#endif
+    vsTex = Tex;
+
+#ifdef NORMAL_MAP
+    mat3 normalMatrix = transpose(inverse(mat3(model)));
+    vec3 normal = normalize(normalMatrix * Normal);
+    vec3 tangent = normalize(normalMatrix * Tangent.xyz);
+    vsTangentToWorld = mat3(tangent, cross(normal, tangent) * Tangent.w, normal);
+#endif
+}
@@ -6,9 +6,14 @@ layout(location = 2) in vec2 Tex;
 
 layout(location = 1) out vec4 vsColor;
 layout(location = 2) out vec2 vsTex;
+layout(location = 3) flat out uint vsMaterial;   // Material ID (Bindless.h): baseInstance of the draw
+
+uniform mat4 vsModel;            // Object -> world
+uniform mat4 vsViewProjection;   // World -> clip (Camera)
 
 void main() {
-    gl_Position = vec4(Position, 1.0);
+    gl_Position = vsViewProjection * vsModel * vec4(Position, 1.0);
     vsColor = Color;
     vsTex = Tex;
+    vsMaterial = uint(gl_BaseInstance);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Asset Pack Test: LZ4 round trips (empty, tiny, incompressible, repetitive, long matches and literal runs), corrupt
+// blocks rejected without writing out of bounds, a pack written, mapped and read back entry by entry, and damaged packs
+// (truncated, names block not 0 terminated) rejected at open
+#include "Test.h"
+#include "../AssetPack.h"
+
+#include <vector>
+#include <string>
+#include <random>
+#include <fstream>
+#include <cstring>
+
+std::vector<unsigned char> roundTrip (const std::vector<unsigned char>& data, bool& decoded)
+{
+    std::vector<unsigned char> compressed;
+    lz4Compress(data.data(), data.size(), compressed);
+    std::vector<unsigned char> decompressed(data.size());
+    decoded = lz4Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+    return decompressed;
+}
+
+int main ()
+{
+    std::mt19937 random(3);
+    std::vector<std::vector<unsigned char>> inputs;
+    inputs.push_back({});
+    for (size_t size : {1, 4, 5, 12, 13, 16, 17})
+        inputs.push_back(std::vector<unsigned char>(size, 'a'));
+    for (size_t size : {100, 65536, 300000}) {
+        std::vector<unsigned char> noise(size), zeros(size, 0), text;
+        for (unsigned char& byte : noise) byte = (unsigned char)random();
+        while (text.size() < size) {
+            std::string word = "vertex " + std::to_string(random() % 97) + " normal tex ";
+            text.insert(text.end(), word.begin(), word.end());
+        }
+        text.resize(size);
+        inputs.push_back(noise);
+        inputs.push_back(zeros);
+        inputs.push_back(text);
+    }
+    // Literal runs and matches longer than 15 + 255 (multi-byte lengths), matches far back (64K window)
+    std::vector<unsigned char> mixed;
+    for (int block = 0; block < 40; block++) {
+        size_t literals = random() % 700, repeat = random() % 1500;
+        for (size_t i = 0; i < literals; i++) mixed.push_back((unsigned char)random());
+        size_t from = mixed.size() > 70000 ? mixed.size() - 65000 : 0;
+        for (size_t i = 0; i < repeat && from + i < mixed.size(); i++) mixed.push_back(mixed[from + i]);
+    }
+    inputs.push_back(mixed);
+
+    for (const std::vector<unsigned char>& input : inputs) {
+        bool decoded = false;
+        std::vector<unsigned char> output = roundTrip(input, decoded);
+        CHECK(decoded);
+        CHECK(output == input);
+    }
+
+    // Corrupt blocks: truncated, offsets before the start, too long for the destination
+    std::vector<unsigned char> compressed;
+    lz4Compress(inputs.back().data(), inputs.back().size(), compressed);
+    std::vector<unsigned char> destination(inputs.back().size());
+    CHECK(!lz4Decompress(compressed.data(), compressed.size() / 2, destination.data(), destination.size()));
+    CHECK(!lz4Decompress(compressed.data(), compressed.size(), destination.data(), destination.size() - 1));
+    std::vector<unsigned char> badOffset = {0x14, 'a', 0xFF, 0x00};     // 1 literal, then a match 255 bytes back
+    CHECK(!lz4Decompress(badOffset.data(), badOffset.size(), destination.data(), destination.size()));
+    for (int trial = 0; trial < 200; trial++) {
+        std::vector<unsigned char> damaged = compressed;
+        for (int flip = 0; flip < 4; flip++) damaged[random() % damaged.size()] ^= (unsigned char)(1 + random() % 255);
+        lz4Decompress(damaged.data(), damaged.size(), destination.data(), destination.size());    // Must not crash
+    }
+
+    // Pack: stored and compressed entries, normalized names, aligned stored entries
+    std::string packFilePath = testDirectory("assetpack") + "/test.pack";
+    AssetPackBuilder builder;
+    for (size_t i = 0; i < inputs.size(); i++)
+        CHECK(builder.add("./Assets\\Entry" + std::to_string(i) + ".bin", inputs[i].data(), inputs[i].size(), i % 2 == 0));
+    CHECK(builder.write(packFilePath));
+
+    AssetPack pack;
+    CHECK(pack.open(packFilePath));
+    CHECK(pack.size() == inputs.size());
+    std::vector<unsigned char> buffer;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        std::string name = "assets/entry" + std::to_string(i) + ".bin";
+        const AssetPackEntry* entry = pack.find(name);
+        if (!CHECK(entry != nullptr)) continue;
+        CHECK(std::string(pack.entryName(*entry)) == name);
+        CHECK(entry->offset % ASSET_PACK_ALIGNMENT == 0);
+        std::span<const unsigned char> contents = pack.read(name, buffer);
+        CHECK(std::vector<unsigned char>(contents.begin(), contents.end()) == inputs[i]);
+        if (!(entry->flags & ASSET_PACK_LZ4)) CHECK(pack.view(name).data() == contents.data());
+    }
+    CHECK(!pack.contains("assets/missing.bin"));
+    CHECK(pack.read("assets/missing.bin", buffer).empty());
+    pack.close();
+
+    // Names block without its last 0: rejected at open (entry names are C strings into the mapping)
+    std::vector<char> bytes(std::filesystem::file_size(packFilePath));
+    std::ifstream(packFilePath, std::ios::binary).read(bytes.data(), bytes.size());
+    AssetPackHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    bytes[header.namesOffset + header.namesSize - 1] = 'x';
+    std::string unterminatedFilePath = packFilePath + ".unterminated";
+    std::ofstream(unterminatedFilePath, std::ios::binary).write(bytes.data(), bytes.size());
+    CHECK(!pack.open(unterminatedFilePath));
+
+    // Truncated pack: rejected at open
+    std::filesystem::resize_file(packFilePath, std::filesystem::file_size(packFilePath) / 2);
+    CHECK(!pack.open(packFilePath));
+
+    return testResult("AssetPackTest");
+}
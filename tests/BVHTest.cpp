@@ -0,0 +1,133 @@
+// BVH Test: ray casts, overlap and nearest point queries against brute force over every primitive, for triangle and
+// box BVHs, single threaded and parallel builds, after a refit and with the heap traversal stack
+#include "Test.h"
+#include "../BVH.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+std::mt19937 generator(11);
+
+glm::vec3 randomPoint (float extent)
+{
+    std::uniform_real_distribution<float> coordinate(-extent, extent);
+    return glm::vec3(coordinate(generator), coordinate(generator), coordinate(generator));
+}
+
+// Closest hit over every primitive (the BVH's own primitive tests, so distances compare exactly)
+BVHHit bruteRaycast (const BVH& bvh, const BVHRay& ray)
+{
+    BVHHit hit = {ray.tMax, BVH_INVALID, 0.0f, 0.0f};
+    glm::vec3 inverseDirection = 1.0f / ray.direction;
+    for (unsigned int p = 0; p < (unsigned int)bvh.primitiveMin.size(); p++) {
+        if (bvh.isTriangles()) bvh.intersectTriangle(p, ray, hit);
+        else bvh.intersectBox(p, ray, inverseDirection, hit);
+    }
+    return hit;
+}
+
+std::vector<unsigned int> bruteOverlap (const BVH& bvh, const glm::vec3& boxMin, const glm::vec3& boxMax)
+{
+    std::vector<unsigned int> result;
+    for (unsigned int p = 0; p < (unsigned int)bvh.primitiveMin.size(); p++)
+        if (glm::all(glm::lessThanEqual(bvh.primitiveMin[p], boxMax)) && glm::all(glm::greaterThanEqual(bvh.primitiveMax[p], boxMin)))
+            result.push_back(p);
+    return result;
+}
+
+float bruteNearestSquared (const BVH& bvh, const glm::vec3& point)
+{
+    float best = 1e30f;
+    for (unsigned int p = 0; p < (unsigned int)bvh.primitiveMin.size(); p++) {
+        glm::vec3 closest = bvh.isTriangles()
+            ? closestPointTriangle(point, bvh.positions[bvh.indices[p * 3]], bvh.positions[bvh.indices[p * 3 + 1]], bvh.positions[bvh.indices[p * 3 + 2]])
+            : glm::clamp(point, bvh.primitiveMin[p], bvh.primitiveMax[p]);
+        best = std::min(best, glm::dot(closest - point, closest - point));
+    }
+    return best;
+}
+
+void checkQueries (const BVH& bvh, const std::string& name)
+{
+    unsigned int failures = testFailures();
+    unsigned int hits = 0;
+    for (int r = 0; r < 300; r++) {
+        BVHRay ray = {randomPoint(60.0f), glm::normalize(randomPoint(1.0f) + glm::vec3(1e-4f)), 1e30f};
+        BVHHit hit, reference = bruteRaycast(bvh, ray);
+        CHECK(bvh.raycast(ray, hit) == (reference.primitive != BVH_INVALID));
+        CHECK(hit.t == reference.t);
+        hits += hit.primitive != BVH_INVALID;
+    }
+    CHECK(hits > 0);
+
+    for (int q = 0; q < 100; q++) {
+        glm::vec3 center = randomPoint(50.0f), extent = glm::abs(randomPoint(8.0f));
+        std::vector<unsigned int> result;
+        bvh.overlap(center - extent, center + extent, result);
+        std::sort(result.begin(), result.end());
+        CHECK(result == bruteOverlap(bvh, center - extent, center + extent));
+    }
+
+    for (int q = 0; q < 100; q++) {
+        glm::vec3 point = randomPoint(70.0f), closest;
+        unsigned int primitive;
+        CHECK(bvh.nearestPoint(point, 1e6f, closest, primitive));
+        float reference = bruteNearestSquared(bvh, point);
+        CHECK(std::abs(glm::dot(closest - point, closest - point) - reference) <= 1e-4f * std::max(1.0f, reference));
+    }
+    if (testFailures() != failures) std::cout << "  in " << name << std::endl;
+}
+
+int main ()
+{
+    // Triangle soup: small random triangles in a 100 m cube (enough for parallel subtrees)
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+    for (unsigned int t = 0; t < 3 * BVH_PARALLEL_THRESHOLD; t++) {
+        glm::vec3 corner = randomPoint(50.0f);
+        for (int v = 0; v < 3; v++) {
+            indices.push_back((unsigned int)positions.size());
+            positions.push_back(corner + randomPoint(2.0f));
+        }
+    }
+
+    for (unsigned int threads : {1u, 0u}) {
+        BVH bvh;
+        bvh.buildTriangles(positions, indices, threads);
+        CHECK(bvh.depth > 0 && bvh.stackSize() <= BVH_STACK_SIZE);
+
+        // Every primitive exactly once in the leaves
+        std::vector<unsigned int> leaves = bvh.primitiveIndices;
+        std::sort(leaves.begin(), leaves.end());
+        CHECK(leaves.size() == indices.size() / 3);
+        for (unsigned int p = 0; p < (unsigned int)leaves.size(); p++) CHECK(leaves[p] == p);
+        checkQueries(bvh, threads == 1 ? "triangles, 1 thread" : "triangles, parallel build");
+
+        // Moved vertices: the refit bounds must still contain them
+        for (glm::vec3& position : bvh.positions) position += glm::vec3(0.0f, 0.05f * position.x, 0.0f);
+        bvh.refit();
+        checkQueries(bvh, "triangles, refit");
+
+        // Deeper than the local stack: same results from the heap stack
+        bvh.depth = BVH_STACK_SIZE;
+        checkQueries(bvh, "triangles, heap stack");
+    }
+
+    // Boxes (scene objects), a few of them overlapping
+    std::vector<glm::vec3> boxMin, boxMax;
+    for (int b = 0; b < 2000; b++) {
+        glm::vec3 center = randomPoint(50.0f), extent = glm::abs(randomPoint(3.0f)) + glm::vec3(0.01f);
+        boxMin.push_back(center - extent);
+        boxMax.push_back(center + extent);
+    }
+    BVH boxes;
+    boxes.buildBoxes(boxMin, boxMax, 1);
+    checkQueries(boxes, "boxes");
+    for (unsigned int b = 0; b < (unsigned int)boxMin.size(); b += 3)
+        boxes.updateBox(b, boxMin[b] + glm::vec3(5.0f), boxMax[b] + glm::vec3(5.0f));
+    boxes.refit();
+    checkQueries(boxes, "boxes, refit");
+
+    return testResult("BVHTest");
+}
@@ -0,0 +1,46 @@
+@echo off
+:: Set project_dir to the root of the repository
+:: %~dp0 : permanent directory containing the batch script.
+set project_dir=%~dp0..
+
+:: Compile and run the tests (exit code 1 when a check fails)
+echo Compiling Tests
+for %%t in (MeshletTest CullingTest BVHTest AssetPackTest ShaderPreprocessorTest) do (
+    g++ -std=c++20 -O2 %%t.cpp -o %%t -I"%project_dir%/include"
+    if errorlevel 1 (
+        echo Error
+    ) else (
+        %%t
+    )
+)
+
+g++ -std=c++20 -O2 TexturePackerTest.cpp ../ImageDecoder.cpp -o TexturePackerTest -msse2 -mstackrealign ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    TexturePackerTest
+)
+
+g++ -std=c++20 -O2 ResidencyTest.cpp ../ImageDecoder.cpp -o ResidencyTest -msse2 -mstackrealign ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    ResidencyTest
+)
+
+g++ -std=c++20 -O2 ImageDecoderTest.cpp ../ImageDecoder.cpp -o ImageDecoderTest -msse2 -mstackrealign ^
+-I"%project_dir%/include" ^
+-L"%project_dir%/lib" ^
+-lpng -lz
+
+if errorlevel 1 (
+    echo Error
+) else (
+    ImageDecoderTest
+)
+
+pause
@@ -0,0 +1,61 @@
+// Culling Test: SIMD and threaded frustum culling return exactly the scalar reference indices (spheres and boxes,
+// unaligned ranges, scenes below and above the parallel threshold)
+#include "Test.h"
+#include "../Camera.h"
+#include "../Culling.h"
+
+#include <vector>
+#include <random>
+
+std::vector<unsigned int> scalarVisible (const CullingBounds& bounds, const Frustum& frustum, CullingVolume volume, unsigned int begin, unsigned int end)
+{
+    std::vector<unsigned int> visible(end - begin);
+    visible.resize(cullScalar(bounds, frustum, volume, begin, end, visible.data()));
+    return visible;
+}
+
+int main ()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-300.0f, 300.0f);
+    std::uniform_real_distribution<float> size(0.1f, 20.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+
+    for (unsigned int objectCount : {0u, 1u, 7u, 13u, 1000u, CULLING_PARALLEL_THRESHOLD * 3 + 5}) {
+        CullingBounds bounds;
+        for (unsigned int i = 0; i < objectCount; i++) {
+            glm::vec3 center(position(random), position(random), position(random));
+            glm::vec3 extent(size(random), size(random), size(random));
+            bounds.add(center - extent, center + extent);
+        }
+
+        for (int view = 0; view < 4; view++) {
+            Camera camera(glm::vec3(position(random), position(random), position(random)) * 0.2f, angle(random), angle(random) / 8.0f - 22.5f);
+            Frustum frustum = camera.frustum();
+
+            for (CullingVolume volume : {CULL_SPHERE, CULL_AABB}) {
+                std::vector<unsigned int> reference = scalarVisible(bounds, frustum, volume, 0, objectCount);
+
+                std::vector<unsigned int> simd(objectCount);
+                simd.resize(cullSimd(bounds, frustum, volume, 0, objectCount, simd.data()));
+                CHECK(simd == reference);
+
+                // Ranges that start and end inside a SIMD group
+                if (objectCount > 6) {
+                    unsigned int begin = 3, end = objectCount - 2;
+                    std::vector<unsigned int> range(end - begin);
+                    range.resize(cullSimd(bounds, frustum, volume, begin, end, range.data()));
+                    CHECK(range == scalarVisible(bounds, frustum, volume, begin, end));
+                }
+
+                for (unsigned int chunkCount : {0u, 1u, 3u, 64u}) {
+                    std::vector<unsigned int> threaded;
+                    cullObjects(bounds, frustum, threaded, volume, chunkCount);
+                    CHECK(threaded == reference);
+                }
+            }
+        }
+    }
+
+    return testResult("CullingTest");
+}
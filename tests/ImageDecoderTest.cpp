@@ -0,0 +1,113 @@
+// Image Decoder Test: large PNGs (the striped path) decode to exactly the pixels of stbi_load, for every color type,
+// 8 and 16 bit, one / several IDAT chunks, one / many stripes, every channel count, on the job system and on the
+// calling thread, into caller memory with a row pitch and into decodeImage's own buffer, and into memory the decoder
+// must not read back (a write only mapped pixel unpack buffer)
+#include "Test.h"
+#include "../ImageDecoder.h"
+
+#include <stb_image/stb_image.h>      // Declarations only: the implementation is in ImageDecoder.cpp
+#include <png.h>
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+// PNG (libpng, fastest compression): adaptive filters (or the given ones), a None row every noneEvery rows (stripe starts,
+// 0: none), one IDAT chunk or many
+std::vector<unsigned char> encodePNG (const std::vector<unsigned char>& pixels, int width, int height, int colorType, int depth,
+                                      int noneEvery, bool oneChunk, int filters = PNG_ALL_FILTERS)
+{
+    std::vector<unsigned char> encoded;
+    png_structp encoder = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(encoder);
+    png_set_write_fn(encoder, &encoded, [](png_structp png, png_bytep data, png_size_t length) {
+        std::vector<unsigned char>* output = (std::vector<unsigned char>*)png_get_io_ptr(png);
+        output->insert(output->end(), data, data + length);
+    }, nullptr);
+    if (oneChunk) png_set_compression_buffer_size(encoder, 1 << 30);
+    png_set_compression_level(encoder, 1);
+    png_set_IHDR(encoder, info, width, height, depth, colorType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_set_filter(encoder, PNG_FILTER_TYPE_BASE, filters);
+    png_write_info(encoder, info);
+    size_t rowSize = pixels.size() / height;
+    for (int y = 0; y < height; y++) {
+        if (noneEvery && y > 0) png_set_filter(encoder, PNG_FILTER_TYPE_BASE, (y % noneEvery == 0) ? PNG_FILTER_NONE : filters);
+        png_write_row(encoder, (png_bytep)pixels.data() + y * rowSize);
+    }
+    png_write_end(encoder, info);
+    png_destroy_write_struct(&encoder, &info);
+    return encoded;
+}
+
+int main ()
+{
+    const int width = 2048, height = 2048;
+    static_assert((long long)width * height >= IMAGE_PARALLEL_PIXELS, "the test image must take the striped path");
+
+    struct Format { int colorType, components; };
+    const Format formats[] = {{PNG_COLOR_TYPE_GRAY, 1}, {PNG_COLOR_TYPE_GRAY_ALPHA, 2}, {PNG_COLOR_TYPE_RGB, 3}, {PNG_COLOR_TYPE_RGBA, 4}};
+    unsigned int variant = 0, striped = 0;
+    for (const Format& format : formats)
+        for (int depth : {8, 16})
+            for (int noneEvery : {0, 64}) {
+                // Gradients + noise: every filter type gets picked somewhere
+                size_t rowSize = (size_t)width * format.components * depth / 8;
+                std::vector<unsigned char> pixels(rowSize * height);
+                for (size_t y = 0; y < (size_t)height; y++)
+                    for (size_t x = 0; x < rowSize; x++)
+                        pixels[y * rowSize + x] = (unsigned char)(x / 3 + y / 2 + ((x * 7 ^ y * 13) & 15));
+                std::vector<unsigned char> encoded = encodePNG(pixels, width, height, format.colorType, depth, noneEvery, variant++ % 2 == 0);
+
+                for (int channels = 1; channels <= 4; channels++) {
+                    int referenceWidth, referenceHeight, referenceChannels;
+                    unsigned char* reference = stbi_load_from_memory(encoded.data(), (int)encoded.size(), &referenceWidth, &referenceHeight, &referenceChannels, channels);
+                    if (!CHECK(reference != nullptr)) continue;
+                    size_t row = (size_t)width * channels, pitch = row + 12;
+                    bool ok = true;
+
+                    // Every conversion on the job system, the output format on the calling thread and into decodeImage too
+                    for (bool parallel : {true, false}) {
+                        if (!parallel && channels != format.components) continue;
+                        std::vector<unsigned char> destination(pitch * height, 0xCD);
+                        ok &= CHECK(decodeImageInto(encoded.data(), encoded.size(), destination.data(), pitch, channels, IMAGE_BACKEND_AUTO, parallel));
+                        if (parallel) striped += imageDecodeStripes() > 1;
+                        for (int y = 0; y < height; y++) {
+                            ok &= std::memcmp(destination.data() + y * pitch, reference + y * row, row) == 0;
+                            ok &= destination[y * pitch + row] == 0xCD;                       // Nothing written past a row
+                        }
+                    }
+
+                    DecodedImage image;
+                    if (channels == format.components) {
+                        ok &= CHECK(decodeImage(encoded.data(), encoded.size(), image, channels));
+                        ok &= image.pixels && image.channels == channels && std::memcmp(image.pixels, reference, row * height) == 0;
+                    }
+                    if (!CHECK(ok))
+                        std::cout << "  color type " << format.colorType << ", " << depth << " bit, None every " << noneEvery << " rows, "
+                                  << channels << " channels" << std::endl;
+                    stbi_image_free(reference);
+                }
+            }
+    CHECK(striped > 0);                      // The None rows split the decode
+
+    // Write only destination: rows one pixel apart (rowPitch = pixel size), so every row written overwrites the row
+    // above, Paeth rows only so the decode is one stripe, in row order. A decoder reading the row above back from the
+    // destination gets the current row's pixels instead; the guard past the last row must stay untouched
+    for (const Format& format : formats) {
+        size_t row = (size_t)width * format.components, pitch = format.components;
+        std::vector<unsigned char> pixels(row * height);
+        for (size_t i = 0; i < pixels.size(); i++) pixels[i] = (unsigned char)(i / 3 + i / row * 5 + ((i * 7 ^ i / row * 13) & 15));
+        std::vector<unsigned char> encoded = encodePNG(pixels, width, height, format.colorType, 8, 0, true, PNG_FILTER_PAETH);
+        std::vector<unsigned char> sink(pitch * (height - 1) + row + 16, 0xCD);
+        CHECK(decodeImageInto(encoded.data(), encoded.size(), sink.data(), pitch, format.components));
+        bool ok = imageDecodeStripes() == 1;
+        for (size_t a = 0; a < sink.size() - 16; a++) {
+            size_t last = std::min((size_t)height - 1, a / pitch);                   // Last row written over this byte
+            ok &= sink[a] == pixels[last * row + a - last * pitch];
+        }
+        ok &= std::all_of(sink.end() - 16, sink.end(), [](unsigned char guard) { return guard == 0xCD; });
+        if (!CHECK(ok)) std::cout << "  write only destination, color type " << format.colorType << std::endl;
+    }
+
+    return testResult("ImageDecoderTest");
+}
@@ -0,0 +1,153 @@
+// Meshlet Test: vertex / triangle limits, every triangle in exactly one meshlet with its winding, bounding spheres
+// that contain their vertices, normal cones that contain their triangle normals, and the CPU culler against brute
+// force: every front facing triangle inside the frustum is kept (culling is conservative), back facing meshlets go
+#include "Test.h"
+#include "../Meshlet.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+
+// UV sphere, counter clockwise seen from outside, shared vertices
+void sphere (std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, int rings, int segments, float radius)
+{
+    for (int r = 0; r <= rings; r++)
+        for (int s = 0; s <= segments; s++) {
+            float theta = glm::pi<float>() * r / rings, phi = 2.0f * glm::pi<float>() * s / segments;
+            glm::vec3 position(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            vertices.push_back({position * radius, glm::vec4(1.0f), glm::vec2((float)s / segments, (float)r / rings)});
+        }
+    for (int r = 0; r < rings; r++)
+        for (int s = 0; s < segments; s++) {
+            unsigned int a = r * (segments + 1) + s, b = a + segments + 1;
+            if (r > 0) indices.insert(indices.end(), {a, a + 1, b});
+            if (r < rings - 1) indices.insert(indices.end(), {a + 1, b + 1, b});
+        }
+}
+
+// Flat grid facing +Y
+void grid (std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, int size)
+{
+    unsigned int base = (unsigned int)vertices.size();
+    for (int z = 0; z <= size; z++)
+        for (int x = 0; x <= size; x++)
+            vertices.push_back({glm::vec3(x - size * 0.5f, -3.0f, z - size * 0.5f), glm::vec4(1.0f), glm::vec2(0.0f)});
+    for (int z = 0; z < size; z++)
+        for (int x = 0; x < size; x++) {
+            unsigned int a = base + z * (size + 1) + x, b = a + size + 1;
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+}
+
+std::array<unsigned int, 3> triangle (const MeshletMesh& mesh, const Meshlet& meshlet, unsigned int t)
+{
+    unsigned int packed = mesh.meshletTriangles[meshlet.triangleOffset + t];
+    const unsigned int* local = &mesh.meshletVertices[meshlet.vertexOffset];
+    return {local[packed & 0xFF], local[(packed >> 8) & 0xFF], local[(packed >> 16) & 0xFF]};
+}
+
+void checkMesh (const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, unsigned int maxVertices, unsigned int maxTriangles)
+{
+    MeshletMesh mesh = buildMeshlets(vertices, indices, maxVertices, maxTriangles);
+    CHECK(mesh.bounds.size() == mesh.meshlets.size());
+
+    std::vector<std::array<unsigned int, 3>> covered, expected;
+    for (size_t i = 0; i < indices.size(); i += 3) expected.push_back({indices[i], indices[i + 1], indices[i + 2]});
+
+    for (size_t m = 0; m < mesh.meshlets.size(); m++) {
+        const Meshlet& meshlet = mesh.meshlets[m];
+        const MeshletBounds& bounds = mesh.bounds[m];
+        CHECK(meshlet.vertexCount > 0 && meshlet.vertexCount <= maxVertices);
+        CHECK(meshlet.triangleCount >= 1 && meshlet.triangleCount <= maxTriangles);
+        CHECK(meshlet.vertexOffset + meshlet.vertexCount <= mesh.meshletVertices.size());
+
+        // Local vertices: distinct, inside the sphere
+        std::vector<unsigned int> local(mesh.meshletVertices.begin() + meshlet.vertexOffset, mesh.meshletVertices.begin() + meshlet.vertexOffset + meshlet.vertexCount);
+        std::sort(local.begin(), local.end());
+        CHECK(std::adjacent_find(local.begin(), local.end()) == local.end());
+        for (unsigned int v : local)
+            CHECK(glm::length(vertices[v].Position - bounds.center) <= bounds.radius * (1.0f + 1e-5f) + 1e-5f);
+
+        float coneCos = std::sqrt(std::max(0.0f, 1.0f - bounds.coneCutoff * bounds.coneCutoff));
+        for (unsigned int t = 0; t < meshlet.triangleCount; t++) {
+            unsigned int packed = mesh.meshletTriangles[meshlet.triangleOffset + t];
+            CHECK((packed & 0xFF) < meshlet.vertexCount && ((packed >> 8) & 0xFF) < meshlet.vertexCount && ((packed >> 16) & 0xFF) < meshlet.vertexCount);
+            std::array<unsigned int, 3> corners = triangle(mesh, meshlet, t);
+            covered.push_back(corners);
+
+            // Normal inside the cone (when the cone is enabled)
+            glm::vec3 normal = glm::cross(vertices[corners[1]].Position - vertices[corners[0]].Position, vertices[corners[2]].Position - vertices[corners[0]].Position);
+            if (bounds.coneCutoff < 1.0f && glm::length(normal) > 1e-12f)
+                CHECK(glm::dot(glm::normalize(normal), bounds.coneAxis) >= coneCos - 1e-4f);
+        }
+    }
+
+    // Every triangle exactly once, winding kept
+    std::sort(covered.begin(), covered.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(covered == expected);
+}
+
+int main ()
+{
+    std::mt19937 random(9);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+
+    // Meshes: sphere + floor grid, random triangle soup (some triangles with a repeated vertex)
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    sphere(vertices, indices, 48, 64, 2.0f);
+    grid(vertices, indices, 40);
+
+    std::vector<Vertex> soupVertices;
+    std::vector<unsigned int> soupIndices;
+    for (int v = 0; v < 600; v++)
+        soupVertices.push_back({glm::vec3(coordinate(random), coordinate(random), coordinate(random)) * 5.0f, glm::vec4(1.0f), glm::vec2(0.0f)});
+    for (int t = 0; t < 2000; t++)
+        for (int k = 0; k < 3; k++) soupIndices.push_back((unsigned int)(random() % soupVertices.size()));
+
+    for (std::pair<unsigned int, unsigned int> limits : {std::pair(MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES), std::pair(16u, 8u), std::pair(3u, 1u), std::pair(255u, 512u)}) {
+        checkMesh(vertices, indices, limits.first, limits.second);
+        checkMesh(soupVertices, soupIndices, limits.first, limits.second);
+    }
+
+    // Culling vs brute force: a triangle that is front facing and not entirely behind a frustum plane must be drawn
+    MeshletMesh mesh = buildMeshlets(vertices, indices);
+    unsigned int coneCulled = 0;
+    for (int view = 0; view < 64; view++) {
+        glm::vec3 cameraPosition = glm::normalize(glm::vec3(coordinate(random), coordinate(random) * 0.5f, coordinate(random))) * (3.0f + 20.0f * (view % 8) / 8.0f);
+        glm::vec3 target = glm::vec3(coordinate(random), coordinate(random), coordinate(random)) * 2.0f;
+        glm::mat4 viewProjection = glm::perspective(glm::radians(50.0f), 16.0f / 9.0f, 0.1f, 100.0f) * glm::lookAt(cameraPosition, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::fromMatrix(viewProjection);
+
+        std::vector<unsigned int> culled;
+        DrawElementsIndirectCommand command;
+        meshletCull(mesh, frustum, cameraPosition, culled, command);
+        CHECK(command.count == culled.size() && command.instanceCount == 1);
+        std::vector<std::array<unsigned int, 3>> drawn;
+        for (size_t i = 0; i < culled.size(); i += 3) drawn.push_back({culled[i], culled[i + 1], culled[i + 2]});
+        std::sort(drawn.begin(), drawn.end());
+
+        unsigned int missing = 0;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const glm::vec3& a = vertices[indices[i]].Position;
+            const glm::vec3& b = vertices[indices[i + 1]].Position;
+            const glm::vec3& c = vertices[indices[i + 2]].Position;
+            bool frontFacing = glm::dot(glm::cross(b - a, c - a), cameraPosition - a) > 0.0f;
+            bool outside = false;
+            for (const glm::vec4& plane : frustum.planes)
+                outside |= glm::dot(glm::vec3(plane), a) + plane.w < 0.0f && glm::dot(glm::vec3(plane), b) + plane.w < 0.0f &&
+                           glm::dot(glm::vec3(plane), c) + plane.w < 0.0f;
+            if (frontFacing && !outside && !std::binary_search(drawn.begin(), drawn.end(), std::array<unsigned int, 3>{indices[i], indices[i + 1], indices[i + 2]}))
+                missing++;
+        }
+        CHECK(missing == 0);
+
+        for (size_t m = 0; m < mesh.meshlets.size(); m++)
+            coneCulled += frustum.sphereVisible(mesh.bounds[m].center, mesh.bounds[m].radius) && !meshletVisible(mesh.bounds[m], frustum, cameraPosition);
+    }
+    CHECK(coneCulled > 0);                   // The back of the sphere goes
+
+    return testResult("MeshletTest");
+}
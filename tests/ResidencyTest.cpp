@@ -0,0 +1,119 @@
+// Residency Test (no GPU): RAM resources (a loader without upload keeps the decoded data) streamed from files and from
+// an asset pack, least recently used eviction down to the budget, pinned resources, re-streams, failed loads, and
+// requests made ahead of the frame being updated (frame packets) counting as requests of that frame
+#include "Test.h"
+#include "../Residency.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+const size_t RESOURCE_BYTES = 1000;
+
+// Request a set of resources for a frame, start their loads, wait for them and upload them (second update)
+void streamFrame (Residency& residency, unsigned long long frame, const std::vector<std::pair<ResidencyID, float>>& requests)
+{
+    for (const std::pair<ResidencyID, float>& request : requests) residency.request(request.first, frame, request.second);
+    residency.update(frame);
+    residency.waitLoads();
+    residency.update(frame);
+}
+
+int main ()
+{
+    std::string directory = testDirectory("residency");
+    std::vector<std::vector<unsigned char>> contents;
+    for (int r = 0; r < 8; r++) {
+        contents.emplace_back(RESOURCE_BYTES, (unsigned char)('a' + r));
+        std::ofstream(directory + "/resource" + std::to_string(r) + ".bin", std::ios::binary)
+            .write(reinterpret_cast<const char*>(contents[r].data()), RESOURCE_BYTES);
+    }
+
+    // Data loader: the file bytes are the data (RAM)
+    ResidencyLoader loader;
+    loader.decode = [](std::span<const unsigned char> encoded, ResidencyData& data) {
+        data.bytes.assign(encoded.begin(), encoded.end());
+        return true;
+    };
+
+    Residency residency(0, 3 * RESOURCE_BYTES + RESOURCE_BYTES / 2);
+    std::vector<ResidencyID> ids;
+    for (int r = 0; r < 8; r++)
+        ids.push_back(residency.add(directory + "/resource" + std::to_string(r) + ".bin", RESIDENCY_DATA, &loader, r == 7));
+    ResidencyID missing = residency.add(directory + "/missing.bin", RESIDENCY_DATA, &loader);
+    CHECK(residency.resources[ids[0]].memory == RESIDENCY_RAM);
+
+    // Load: requested resources only, their data in RAM
+    streamFrame(residency, 1, {{ids[0], 1.5f}, {ids[1], 0.5f}, {ids[2], 0.2f}});
+    for (int r = 0; r < 3; r++) {
+        CHECK(residency.resident(ids[r]));
+        const ResidencyData* data = residency.data(ids[r]);
+        CHECK(data && data->bytes == contents[r]);
+        CHECK(residency.handle(ids[r]) == 0);
+    }
+    CHECK(!residency.resident(ids[3]) && residency.data(ids[3]) == nullptr);
+    CHECK(residency.used(RESIDENCY_RAM) == 3 * RESOURCE_BYTES);
+
+    // Budget: the least recently used goes first, the lower priority on ties; the frame's own requests stay
+    streamFrame(residency, 2, {{ids[0], 1.5f}, {ids[3], 1.0f}});
+    CHECK(residency.resident(ids[0]) && residency.resident(ids[1]) && residency.resident(ids[3]));
+    CHECK(!residency.resident(ids[2]));
+    CHECK(residency.evictions == 1);
+    CHECK(residency.used(RESIDENCY_RAM) <= residency.budgets[RESIDENCY_RAM]);
+
+    // Requests made ahead (the update thread fills frame 4 while frame 3 renders): loaded and protected now
+    residency.request(ids[4], 4, 1.0f);
+    residency.request(ids[0], 4, 1.0f);
+    streamFrame(residency, 3, {});
+    CHECK(residency.resident(ids[4]) && residency.resident(ids[0]) && residency.resident(ids[3]));
+    CHECK(!residency.resident(ids[1]));                  // Last used in frame 1
+    CHECK(residency.evictions == 2);
+
+    // Late request for an older frame: changes nothing
+    residency.request(ids[4], 3, 0.1f);
+    CHECK(residency.resources[ids[4]].lastUsedFrame == 4);
+    CHECK(residency.resources[ids[4]].priority.load() == 1.0f);
+
+    // Highest priority of a frame wins
+    residency.request(ids[5], 5, 0.3f);
+    residency.request(ids[5], 5, 0.9f);
+    residency.request(ids[5], 5, 0.6f);
+    CHECK(residency.resources[ids[5]].priority.load() == 0.9f);
+
+    // Re-stream an evicted resource
+    streamFrame(residency, 6, {{ids[2], 1.0f}});
+    CHECK(residency.resident(ids[2]) && residency.data(ids[2])->bytes == contents[2]);
+    CHECK(residency.restreams == 1 && residency.resources[ids[2]].loads == 2);
+
+    // Pinned: never evicted, the budget reported as exceeded when nothing else can go
+    streamFrame(residency, 7, {{ids[7], 1.0f}, {ids[0], 1.0f}, {ids[2], 1.0f}, {ids[5], 1.0f}});
+    streamFrame(residency, 8, {{ids[0], 1.0f}, {ids[2], 1.0f}, {ids[5], 1.0f}});
+    CHECK(residency.resident(ids[7]));
+    CHECK(residency.overBudget[RESIDENCY_RAM]);
+    streamFrame(residency, 9, {});
+    CHECK(residency.resident(ids[7]) && !residency.overBudget[RESIDENCY_RAM]);
+
+    // Failed: reported once, not retried
+    streamFrame(residency, 10, {{missing, 1.0f}});
+    CHECK(residency.resources[missing].state == RESIDENCY_FAILED);
+    streamFrame(residency, 11, {{missing, 1.0f}});
+    CHECK(residency.resources[missing].state == RESIDENCY_FAILED && residency.resources[missing].loads == 0);
+
+    residency.clear();
+    CHECK(residency.used(RESIDENCY_RAM) == 0);
+
+    // Pack entries: decoded from the mapping
+    AssetPackBuilder builder;
+    CHECK(builder.add("Data/Packed.bin", contents[6].data(), contents[6].size(), true));
+    CHECK(builder.write(directory + "/resources.pack"));
+    AssetPack pack;
+    CHECK(pack.open(directory + "/resources.pack"));
+    Residency packed(0, 1 << 20);
+    packed.pack = &pack;
+    ResidencyID packedID = packed.add("./data/packed.bin", RESIDENCY_DATA, &loader);
+    streamFrame(packed, 0, {{packedID, 1.0f}});
+    CHECK(packed.resident(packedID) && packed.data(packedID)->bytes == contents[6]);
+    packed.clear();
+
+    return testResult("ResidencyTest");
+}
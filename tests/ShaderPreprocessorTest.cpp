@@ -0,0 +1,119 @@
+// Shader Preprocessor Test: #include resolution (next to the includer, then the include directories), #pragma once,
+// defines after #version, include cycles and missing files, memoization and invalidation, and the #line mapping:
+// every line of the output is traced back through the #line directives to the same text in its source file
+#include "Test.h"
+#include "../ShaderPreprocessor.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+void writeFile (const std::string& filePath, const std::string& text)
+{
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+    std::ofstream(filePath) << text;
+}
+
+// Replays the output as the GLSL compiler numbers it; every line must be the line of the file it maps to. The lines
+// before the first #line are #version and the injected defines, blank lines stand for #pragma once
+bool checkLineMapping (ShaderPreprocessor& preprocessor, const ShaderSource& source)
+{
+    std::istringstream lines(source.text);
+    std::string line;
+    int number = -1, lineNumber = 1;
+    bool injected = true, mapped = true;
+    unsigned int checked = 0;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 6, "#line ") == 0) {
+            std::istringstream directive(line.substr(6));
+            directive >> lineNumber >> number;
+            injected = false;
+            continue;
+        }
+        if (!injected && !line.empty()) {
+            std::string original;
+            bool found = preprocessor.sourceLine(number, lineNumber, original);
+            if (!found || original != line) {
+                std::cout << "  '" << line << "' maps to " << preprocessor.sourceName(number) << "(" << lineNumber << ") '" << original << "'" << std::endl;
+                mapped = false;
+            }
+            checked++;
+        }
+        lineNumber++;
+    }
+    return mapped && checked > 0;
+}
+
+size_t count (const std::string& text, const std::string& pattern)
+{
+    size_t found = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) found++;
+    return found;
+}
+
+int main ()
+{
+    std::string directory = testDirectory("preprocessor");
+    writeFile(directory + "/shaders/Common/lighting.glsl", "#pragma once\nvec3 lighting (vec3 n) { return n * LIGHT_SCALE; }\n");
+    writeFile(directory + "/shaders/Common/math.glsl", "// math\n#include \"lighting.glsl\"\nfloat square (float x) { return x * x; }\n");
+    writeFile(directory + "/shaders/Fragment_Shader/local.glsl", "const float localValue = 2.0;\n");
+    writeFile(directory + "/shaders/Fragment_Shader/main.glsl",
+              "#version 460 core\n"
+              "\n"
+              "#include \"local.glsl\"\n"
+              "  #include \"Common/math.glsl\"\n"
+              "#include <Common/lighting.glsl>\n"
+              "out vec4 color;\n"
+              "void main ()\n"
+              "{\n"
+              "    color = vec4(lighting(vec3(square(localValue))), 1.0);\n"
+              "}\n");
+    writeFile(directory + "/shaders/Fragment_Shader/noversion.glsl", "#include \"local.glsl\"\nfloat value = localValue;\n");
+    writeFile(directory + "/shaders/Fragment_Shader/cycle_a.glsl", "#include \"cycle_b.glsl\"\n");
+    writeFile(directory + "/shaders/Fragment_Shader/cycle_b.glsl", "#include \"cycle_a.glsl\"\n");
+    writeFile(directory + "/shaders/Fragment_Shader/missing.glsl", "#include \"nowhere.glsl\"\n");
+
+    ShaderPreprocessor preprocessor;
+    preprocessor.includeDirectories = {directory + "/shaders"};
+    std::string root = directory + "/shaders/Fragment_Shader/main.glsl";
+
+    ShaderSource source = preprocessor.preprocess(root, {"LIGHT_SCALE 0.5", "USE_NORMAL_MAP"});
+    CHECK(source.success);
+    CHECK(source.text.compare(0, 18, "#version 460 core\n") == 0);
+    CHECK(source.text.find("#define LIGHT_SCALE 0.5\n#define USE_NORMAL_MAP\n#line 2 ") != std::string::npos);
+    CHECK(count(source.text, "vec3 lighting") == 1);                 // #pragma once: included twice, expanded once
+    CHECK(count(source.text, "const float localValue") == 1);
+    CHECK(source.text.find("#include") == std::string::npos);
+    CHECK(source.hash == shaderSourceHash(source.text));
+
+    // Dependencies: the root first, then every included file once
+    CHECK(source.dependencies.size() == 4);
+    CHECK(!source.dependencies.empty() && source.dependencies[0] == ShaderPreprocessor::normalize(root));
+    CHECK(checkLineMapping(preprocessor, source));
+
+    // No #version: defines and numbering first
+    std::string noVersion = directory + "/shaders/Fragment_Shader/noversion.glsl";
+    ShaderSource plain = preprocessor.preprocess(noVersion, {"A 1"});
+    CHECK(plain.success && plain.text.compare(0, 20, "#define A 1\n#line 1 ") == 0);
+    CHECK(checkLineMapping(preprocessor, plain));
+
+    // Failures: not memoized, reported
+    CHECK(!preprocessor.preprocess(directory + "/shaders/Fragment_Shader/cycle_a.glsl").success);
+    CHECK(!preprocessor.preprocess(directory + "/shaders/Fragment_Shader/missing.glsl").success);
+    CHECK(!preprocessor.preprocess(directory + "/shaders/none.glsl").success);
+
+    // Memoized until a dependency is invalidated; other defines are another result
+    ShaderSource again = preprocessor.preprocess(root, {"LIGHT_SCALE 0.5", "USE_NORMAL_MAP"});
+    CHECK(again.text == source.text);
+    CHECK(preprocessor.preprocess(root, {"LIGHT_SCALE 0.5"}).hash != source.hash);
+    writeFile(directory + "/shaders/Common/lighting.glsl", "#pragma once\nvec3 lighting (vec3 n) { return n; }\n");
+    CHECK(preprocessor.preprocess(root, {"LIGHT_SCALE 0.5", "USE_NORMAL_MAP"}).hash == source.hash);
+    preprocessor.invalidate(directory + "/shaders/Common/../Common/lighting.glsl");
+    ShaderSource changed = preprocessor.preprocess(root, {"LIGHT_SCALE 0.5", "USE_NORMAL_MAP"});
+    CHECK(changed.success && changed.hash != source.hash);
+    CHECK(changed.text.find("return n;") != std::string::npos);
+    CHECK(checkLineMapping(preprocessor, changed));
+
+    return testResult("ShaderPreprocessorTest");
+}
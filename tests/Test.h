@@ -0,0 +1,46 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+
+// Tests
+// One executable per module, registered with ctest (tests/CMakeLists.txt). CHECK prints the failed condition and
+// carries on, the exit code of main (testResult) is 1 when any check failed.
+
+#define CHECK(condition) testCheck((condition), #condition, __FILE__, __LINE__)
+
+inline unsigned int& testFailures ()
+{
+    static unsigned int failures = 0;
+    return failures;
+}
+
+inline bool testCheck (bool passed, const char* condition, const char* file, int line)
+{
+    if (!passed) {
+        std::cout << file << "(" << line << "): CHECK(" << condition << ") failed" << std::endl;
+        testFailures()++;
+    }
+    return passed;
+}
+
+// Scratch directory for the files a test writes (removed and created again)
+inline std::string testDirectory (const std::string& name)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("opengl_tests_" + name);
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(directory, error);
+    return directory.generic_string();
+}
+
+inline int testResult (const std::string& name)
+{
+    if (testFailures() == 0) std::cout << name << ": passed" << std::endl;
+    else std::cout << name << ": " << testFailures() << " checks failed" << std::endl;
+    return testFailures() == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,130 @@
+// Texture Packer Test: skyline rectangles never overlap and stay inside the layer; packed atlases hold every image
+// texel for texel with its gutter, aligned, one atlas per channel count; the .atlas cache round trips and corrupt or
+// truncated files are rejected
+#include "Test.h"
+#include "../TexturePacker.h"
+
+#include <vector>
+#include <random>
+#include <fstream>
+
+struct Rect { int x, y, width, height; };
+
+bool overlaps (const Rect& a, const Rect& b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// Write a 32 bit value at a byte offset of a file
+void patch (const std::string& filePath, std::streamoff offset, int32_t value)
+{
+    std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+int main ()
+{
+    std::mt19937 random(5);
+
+    // Skyline: random rectangles until the layer is full
+    for (int trial = 0; trial < 20; trial++) {
+        SkylinePacker packer(512, 512);
+        std::vector<Rect> placed;
+        int area = 0, failures = 0;
+        while (failures < 50) {
+            Rect rect = {0, 0, 1 + (int)(random() % 96), 1 + (int)(random() % 96)};
+            if (!packer.insert(rect.width, rect.height, rect.x, rect.y)) { failures++; continue; }
+            CHECK(rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= 512 && rect.y + rect.height <= 512);
+            for (const Rect& other : placed) CHECK(!overlaps(rect, other));
+            placed.push_back(rect);
+            area += rect.width * rect.height;
+        }
+        CHECK(area > 512 * 512 / 2);                 // Bottom-left skyline: well over half the layer used
+        CHECK(!packer.insert(513, 1, placed[0].x, placed[0].y));
+    }
+
+    // Packer: random images of 1 to 4 channels, some larger than the default layer
+    TexturePacker texturePacker;
+    texturePacker.layerSize = 256;
+    for (int i = 0; i < 60; i++) {
+        int width = 1 + (int)(random() % 120), height = 1 + (int)(random() % 120), channels = 1 + (int)(random() % 4);
+        if (i == 7) width = 300;
+        std::vector<unsigned char> pixels((size_t)width * height * channels);
+        for (unsigned char& texel : pixels) texel = (unsigned char)random();
+        texturePacker.add("Images/Texture" + std::to_string(i) + ".png", pixels.data(), width, height, channels);
+    }
+    std::vector<TextureAtlas> atlases = texturePacker.pack();
+    CHECK(atlases.size() == 4);
+
+    size_t entries = 0;
+    for (const TextureAtlas& atlas : atlases) {
+        int gutter = atlas.gutter;
+        CHECK(atlas.layerSize >= 256 && (atlas.layerSize & (atlas.layerSize - 1)) == 0);
+        std::vector<std::vector<Rect>> layerRects(atlas.layers.size());
+        for (const TextureAtlasEntry& entry : atlas.entries) {
+            const TexturePacker::Image* image = nullptr;
+            for (const TexturePacker::Image& candidate : texturePacker.images)
+                if (candidate.name == entry.name) image = &candidate;
+            if (!CHECK(image != nullptr && entry.layer < atlas.layers.size())) continue;
+            CHECK(image->channels == atlas.channels && entry.width == image->width && entry.height == image->height);
+            CHECK(atlas.find(entry.name) == &entry);
+
+            // Rectangle with its gutter: aligned, inside the layer, alone
+            Rect rect = {entry.x - gutter, entry.y - gutter, entry.width + 2 * gutter, entry.height + 2 * gutter};
+            CHECK(rect.x >= 0 && rect.y >= 0 && rect.x % gutter == 0 && rect.y % gutter == 0);
+            CHECK(rect.x + rect.width <= atlas.layerSize && rect.y + rect.height <= atlas.layerSize);
+            for (const Rect& other : layerRects[entry.layer]) CHECK(!overlaps(rect, other));
+            layerRects[entry.layer].push_back(rect);
+
+            // Texels: the image inside, the nearest edge texel in the gutter
+            const std::vector<unsigned char>& layer = atlas.layers[entry.layer];
+            bool same = true;
+            for (int y = -gutter; y < entry.height + gutter; y++)
+                for (int x = -gutter; x < entry.width + gutter; x++) {
+                    int sourceX = std::clamp(x, 0, entry.width - 1), sourceY = std::clamp(y, 0, entry.height - 1);
+                    same &= std::memcmp(&layer[((size_t)(entry.y + y) * atlas.layerSize + entry.x + x) * atlas.channels],
+                                        &image->pixels[((size_t)sourceY * entry.width + sourceX) * atlas.channels], atlas.channels) == 0;
+                }
+            CHECK(same);
+
+            glm::vec2 corner = entry.remap(glm::vec2(1.0f));
+            CHECK(std::abs(corner.x * atlas.layerSize - (entry.x + entry.width)) < 1e-3f);
+            CHECK(std::abs(corner.y * atlas.layerSize - (entry.y + entry.height)) < 1e-3f);
+            entries++;
+        }
+    }
+    CHECK(entries == texturePacker.images.size());
+
+    // Cache: round trip, other key, corrupt layer index, truncated file
+    std::string cacheFilePath = testDirectory("texturepacker") + "/test.atlas";
+    CHECK(saveTextureAtlases(cacheFilePath, atlases, 42));
+    std::vector<TextureAtlas> loaded;
+    CHECK(loadTextureAtlases(cacheFilePath, loaded, 42));
+    CHECK(loaded.size() == atlases.size());
+    for (size_t a = 0; a < loaded.size() && a < atlases.size(); a++) {
+        CHECK(loaded[a].layers == atlases[a].layers);
+        CHECK(loaded[a].entries.size() == atlases[a].entries.size());
+        for (size_t e = 0; e < loaded[a].entries.size() && e < atlases[a].entries.size(); e++)
+            CHECK(loaded[a].entries[e].name == atlases[a].entries[e].name && loaded[a].entries[e].layer == atlases[a].entries[e].layer &&
+                  loaded[a].entries[e].uvRect == atlases[a].entries[e].uvRect);
+    }
+    CHECK(!loadTextureAtlases(cacheFilePath, loaded, 43));
+
+    // Header (3 x 4 + 8 bytes), first atlas description (5 x 4), first entry: name size, layer
+    std::streamoff firstLayer = 12 + 8 + 20 + 4;
+    patch(cacheFilePath, firstLayer, (int32_t)atlases[0].layers.size());
+    CHECK(!loadTextureAtlases(cacheFilePath, loaded, 42));
+    patch(cacheFilePath, firstLayer, -1);
+    CHECK(!loadTextureAtlases(cacheFilePath, loaded, 42));
+    patch(cacheFilePath, firstLayer, 0);
+    CHECK(loadTextureAtlases(cacheFilePath, loaded, 42) == (atlases[0].entries[0].layer == 0));
+    patch(cacheFilePath, 12 + 8 + 12, TEXTURE_ATLAS_MAX_LAYERS + 1);       // Layer count
+    CHECK(!loadTextureAtlases(cacheFilePath, loaded, 42));
+
+    CHECK(saveTextureAtlases(cacheFilePath, atlases, 42));
+    std::filesystem::resize_file(cacheFilePath, std::filesystem::file_size(cacheFilePath) - 1);
+    CHECK(!loadTextureAtlases(cacheFilePath, loaded, 42));
+
+    return testResult("TexturePackerTest");
+}
@@ -0,0 +1,53 @@
+// Atlas Builder: packs images into texture array atlases (TexturePacker.h) and writes the .atlas cache
+// Usage: AtlasBuilder <output.atlas> [--size texels] [--gutter texels] <image or directory>...
+// Run from the repository root so the entry names match the paths used by the app (e.g. archive/Images/Img.jpg)
+#include "../TexturePacker.h"         // Images decoded by ImageDecoder.cpp (linked in)
+
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+int main (int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cout << "Usage: AtlasBuilder <output.atlas> [--size texels] [--gutter texels] <image or directory>..." << std::endl;
+        return 1;
+    }
+
+    std::string atlasFilePath = argv[1];
+    int layerSize = TEXTURE_ATLAS_LAYER_SIZE;
+    int gutter = TEXTURE_ATLAS_GUTTER;
+    std::vector<std::string> images;
+
+    for (int a = 2; a < argc; a++) {
+        std::string argument = argv[a];
+        if (argument == "--size" && a + 1 < argc) { layerSize = std::atoi(argv[++a]); continue; }
+        if (argument == "--gutter" && a + 1 < argc) { gutter = std::atoi(argv[++a]); continue; }
+
+        std::filesystem::path path(argument);
+        if (std::filesystem::is_directory(path)) {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path)) {
+                std::string extension = entry.path().extension().string();
+                if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp"))
+                    images.push_back(entry.path().generic_string());
+            }
+        } else {
+            images.push_back(path.generic_string());
+        }
+    }
+
+    // Summary: layers and fill per format
+    std::vector<TextureAtlas> atlases = packTextures(atlasFilePath, images, layerSize, gutter);
+    for (const TextureAtlas& atlas : atlases) {
+        size_t used = 0;
+        for (const TextureAtlasEntry& entry : atlas.entries) used += (size_t)entry.width * entry.height;
+        double capacity = (double)atlas.layerSize * atlas.layerSize * atlas.layers.size();
+        std::cout << atlas.channels << " channels: " << atlas.entries.size() << " textures in " << atlas.layers.size() << " layers of "
+                  << atlas.layerSize << "x" << atlas.layerSize << ", " << (int)(100.0 * used / capacity) << "% filled, "
+                  << atlas.mipLevels() << " mip levels" << std::endl;
+    }
+    std::cout << "Wrote " << atlasFilePath << std::endl;
+    return atlases.empty() ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+@echo off
+:: Set project_dir to the root of the repository
+:: %~dp0 : permanent directory containing the batch script.
+set project_dir=%~dp0..
+
+:: Compile the tools
+echo Compiling Tools
+g++ -std=c++20 -O2 PackBuilder.cpp -o PackBuilder
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 AtlasBuilder.cpp ../ImageDecoder.cpp -o AtlasBuilder -msse2 -mstackrealign ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+g++ -std=c++20 -O2 ShaderValidator.cpp -o ShaderValidator ^
+-I"%project_dir%/include"
+
+if errorlevel 1 (
+    echo Error
+) else (
+    echo Compiled
+)
+
+pause
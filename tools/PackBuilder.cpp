@@ -0,0 +1,50 @@
+// Pack Builder: writes an asset pack (AssetPack.h) from files and directories
+// Usage: PackBuilder <output.pack> [--lz4] [--align bytes] <file or directory>...
+// Run from the repository root so entry names match the paths used by the app (e.g. archive/Images/Img.jpg)
+#include "../AssetPack.h"
+
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <string>
+#include <cstdlib>
+
+int main (int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cout << "Usage: PackBuilder <output.pack> [--lz4] [--align bytes] <file or directory>..." << std::endl;
+        return 1;
+    }
+
+    std::string packFilePath = argv[1];
+    bool compress = false;
+    uint32_t alignment = ASSET_PACK_ALIGNMENT;
+    AssetPackBuilder builder;
+
+    for (int a = 2; a < argc; a++) {
+        std::string argument = argv[a];
+        if (argument == "--lz4") { compress = true; continue; }
+        if (argument == "--align" && a + 1 < argc) { alignment = (uint32_t)std::atoi(argv[++a]); continue; }
+
+        std::filesystem::path path(argument);
+        if (std::filesystem::is_directory(path)) {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path))
+                if (entry.is_regular_file() && !builder.addFile(entry.path().generic_string(), compress)) return 1;
+        } else if (!builder.addFile(path.generic_string(), compress)) {
+            return 1;
+        }
+    }
+
+    // Summary
+    uint64_t original = 0, stored = 0;
+    for (const AssetPackBuilder::Item& item : builder.items) {
+        original += item.originalSize;
+        stored += item.data.size();
+        std::cout << std::setw(10) << item.originalSize << std::setw(10) << item.data.size()
+                  << ((item.flags & ASSET_PACK_LZ4) ? "  lz4   " : "  stored") << "  " << item.name << std::endl;
+    }
+
+    if (!builder.write(packFilePath, alignment)) return 1;
+    std::cout << builder.items.size() << " entries, " << original << " bytes -> " << stored << " bytes: " << packFilePath << std::endl;
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Shader Validator: checks every shader with glslang (the reference GLSL compiler) at build time
+// Usage: ShaderValidator [--glslang executable] [shaders directory]
+// Stages come from the directory (Vertex_Shader, Fragment_Shader, Compute_Shader; Common only holds includes).
+// Each file is expanded by the ShaderPreprocessor exactly as the app loads it, material templates (material_*.glsl)
+// once per feature permutation, and glslang's errors are mapped back to the original files and lines.
+// Exit code 1 when a shader fails: Build.cmd stops before a broken shader reaches the app.
+#include "../ShaderPreprocessor.h"
+#include "../ShaderDiagnostics.h"
+#include "../Material.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+// glslang stage extension of a shader directory, empty for include directories
+std::string shaderStage (const std::filesystem::path& file)
+{
+    std::string directory = file.parent_path().filename().string();
+    if (directory == "Vertex_Shader") return "vert";
+    if (directory == "Fragment_Shader") return "frag";
+    if (directory == "Compute_Shader") return "comp";
+    return std::string();
+}
+
+// Expanded source through glslang: true when it compiles, the log is printed with source excerpts
+bool validate (const std::string& glslang, const std::filesystem::path& outputDirectory, const std::string& name,
+               const std::string& stage, const ShaderSource& source)
+{
+    if (!source.success) {
+        std::cout << "FAILED " << name << ": preprocessor error" << std::endl;
+        return false;
+    }
+    std::string stem = name;
+    for (char& c : stem) if (c == '/' || c == '\\' || c == ' ' || c == '[' || c == ']') c = '_';
+    std::filesystem::path sourceFile = outputDirectory / (stem + "." + stage);
+    std::filesystem::path logFile = outputDirectory / (stem + ".log");
+    std::ofstream(sourceFile, std::ios::binary) << source.text;
+
+    std::string command = "\"" + glslang + "\" \"" + sourceFile.string() + "\" > \"" + logFile.string() + "\" 2>&1";
+#ifdef _WIN32
+    command = "\"" + command + "\"";    // cmd.exe strips the outer quotes
+#endif
+    int status = std::system(command.c_str());
+
+    std::ifstream logStream(logFile);
+    std::stringstream log;
+    log << logStream.rdbuf();
+    if (status == 0) return true;
+    std::cout << "FAILED " << name << ":\n" << shaderLogExcerpt(log.str(), source.text) << std::endl;
+    return false;
+}
+
+int main (int argc, char* argv[])
+{
+    std::string glslang = "glslangValidator";
+    std::string shaderDirectory = "./shaders";
+    for (int a = 1; a < argc; a++) {
+        std::string argument = argv[a];
+        if (argument == "--glslang" && a + 1 < argc) { glslang = argv[++a]; continue; }
+        shaderDirectory = argument;
+    }
+
+    ShaderPreprocessor& preprocessor = shaderPreprocessor();
+    preprocessor.includeDirectories = {shaderDirectory};
+    std::filesystem::path outputDirectory = std::filesystem::temp_directory_path() / "ShaderValidator";
+    std::filesystem::create_directories(outputDirectory);
+
+    std::vector<std::filesystem::path> files;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(shaderDirectory))
+        if (entry.is_regular_file() && entry.path().extension() == ".glsl" && !shaderStage(entry.path()).empty())
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+
+    unsigned int checked = 0, failed = 0;
+    for (const std::filesystem::path& file : files) {
+        std::string path = file.lexically_normal().generic_string();
+        std::string stage = shaderStage(file);
+
+        // Material templates: every feature permutation is a program the app may build
+        bool materialTemplate = file.filename().string().compare(0, 9, "material_") == 0;
+        uint32_t permutations = materialTemplate ? MATERIAL_PERMUTATIONS : 1;
+        for (uint32_t features = 0; features < permutations; features++) {
+            std::vector<std::string> defines;
+            std::string name = path;
+            if (materialTemplate) {
+                name += " [";
+                for (uint32_t feature = 0; feature < MATERIAL_FEATURE_COUNT; feature++)
+                    if (features & (1u << feature)) {
+                        defines.push_back(MATERIAL_FEATURE_DEFINES[feature]);
+                        name += std::string(name.back() == '[' ? "" : " ") + MATERIAL_FEATURE_DEFINES[feature];
+                    }
+                name += "]";
+            }
+            checked++;
+            if (!validate(glslang, outputDirectory, name, stage, preprocessor.preprocess(path, defines))) failed++;
+        }
+    }
+
+    std::cout << checked << " shaders checked, " << failed << " failed" << std::endl;
+    return (failed > 0 || checked == 0) ? 1 : 0;
+}